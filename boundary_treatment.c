@@ -13,6 +13,7 @@
  ****************************************************************************/
 #include "boundary_treatment.h"
 #include <stdio.h> /* standard library for input and output */
+#include <math.h> /* common mathematical functions */
 #include "immersed_boundary.h"
 #include "cfd_commons.h"
 #include "commons.h"
@@ -20,12 +21,16 @@
  * Static Function Declarations
  ****************************************************************************/
 static void ApplyBoundaryCondition(const int, const int, int [restrict][LIMIT],
-        const int, Space *, const Model *);
+        const int, const Real, Space *, const Model *);
 static void EnforceZeroGradient(const Real [restrict], Real [restrict]);
+static void EnforceCharacteristic(const int, const int, const int, const Real,
+        const Real [restrict], const Real [restrict], const Real *, Real *, const Model *);
+static void ComputeReference(const int, const Real [restrict], const Real [restrict],
+        Real [restrict]);
 /****************************************************************************
  * Function definitions
  ****************************************************************************/
-void TreatBoundary(const int tn, Space *space, const Model *model)
+void TreatBoundary(const int tn, const Real dt, Space *space, const Model *model)
 {
     /*
      * Internal boundary treatment
@@ -58,13 +63,13 @@ void TreatBoundary(const int tn, Space *space, const Model *model)
             if ((box[X][MIN] >= box[X][MAX]) || (box[Y][MIN] >= box[Y][MAX]) || (box[Z][MIN] >= box[Z][MAX])) {
                 continue;
             }
-            ApplyBoundaryCondition(p, r, box, tn, space, model);
+            ApplyBoundaryCondition(p, r, box, tn, dt, space, model);
         }
     }
     return;
 }
 static void ApplyBoundaryCondition(const int p, const int r, int box[restrict][LIMIT],
-        const int tn, Space *space, const Model *model)
+        const int tn, const Real dt, Space *space, const Model *model)
 {
     const Partition *const part = &(space->part);
     Node *const node = space->node;
@@ -78,6 +83,10 @@ static void ApplyBoundaryCondition(const int p, const int r, int box[restrict][L
         part->varBC[p][5]};
     const IntVec N = {part->N[p][X], part->N[p][Y], part->N[p][Z]};
     const IntVec LN = {part->m[X] * N[X], part->m[Y] * N[Y], part->m[Z] * N[Z]};
+    IntVec st = {0}; /* index strides */
+    IndexStride(part->n, st);
+    const int idxN = N[X] * st[X] + N[Y] * st[Y] + N[Z] * st[Z]; /* index offset of normal */
+    const int idxLN = LN[X] * st[X] + LN[Y] * st[Y] + LN[Z] * st[Z]; /* index offset of period */
     Real *restrict UG = NULL;
     Real *restrict UI = NULL;
     Real *restrict UO = NULL;
@@ -105,23 +114,23 @@ static void ApplyBoundaryCondition(const int p, const int r, int box[restrict][L
                         case SLIPWALL:
                             /* fall through */
                         case NOSLIPWALL:
-                            idxO = IndexNode(k - r*N[Z], j - r*N[Y], i - r*N[X], part->n[Y], part->n[X]);
+                            idxO = idxG - r * idxN;
                             UO = node[idxO].U[tn];
-                            MapPrimitive(model->gamma, model->gasR, UO, UoO);
-                            idxI = IndexNode(k - 2*r*N[Z], j - 2*r*N[Y], i - 2*r*N[X], part->n[Y], part->n[X]);
+                            MapPrimitive(model, UO, UoO);
+                            idxI = idxG - 2 * r * idxN;
                             UI = node[idxI].U[tn];
-                            MapPrimitive(model->gamma, model->gasR, UI, UoI);
+                            MapPrimitive(model, UI, UoI);
                             DoMethodOfImage(UoI, UoO, UoG);
-                            UoG[0] = UoG[4] / (UoG[5] * model->gasR); /* compute density */
-                            MapConservative(model->gamma, UoG, UG);
+                            UoG[0] = ComputeDensity(model, UoG[4], UoG[5]);
+                            MapConservative(model, UoG, UG);
                             break;
                         case PERIODIC:
-                            idxh = IndexNode(k - LN[Z], j - LN[Y], i - LN[X], part->n[Y], part->n[X]);
+                            idxh = idxG - idxLN;
                             Uh = node[idxh].U[tn];
                             EnforceZeroGradient(Uh, UG);
                             break;
                         default:
-                            idxh = IndexNode(k - N[Z], j - N[Y], i - N[X], part->n[Y], part->n[X]);
+                            idxh = idxG - idxN;
                             Uh = node[idxh].U[tn];
                             EnforceZeroGradient(Uh, UG);
                             break;
@@ -132,18 +141,18 @@ static void ApplyBoundaryCondition(const int p, const int r, int box[restrict][L
                 UO = node[idxO].U[tn];
                 switch (part->typeBC[p]) { /* treat physical boundary */
                     case INFLOW:
-                        MapConservative(model->gamma, UoGiven, UO);
+                        MapConservative(model, UoGiven, UO);
                         break;
                     case OUTFLOW:
                         /* Calculate inner neighbour nodes according to normal vector direction. */
-                        idxh = IndexNode(k - N[Z], j - N[Y], i - N[X], part->n[Y], part->n[X]);
+                        idxh = idxO - idxN;
                         Uh = node[idxh].U[tn];
                         EnforceZeroGradient(Uh, UO);
                         break;
                     case SLIPWALL: /* zero-gradient for scalar and tangential component, zero for normal component */
-                        idxh = IndexNode(k - N[Z], j - N[Y], i - N[X], part->n[Y], part->n[X]);
+                        idxh = idxO - idxN;
                         Uh = node[idxh].U[tn];
-                        MapPrimitive(model->gamma, model->gasR, Uh, Uoh);
+                        MapPrimitive(model, Uh, Uoh);
                         UoO[1] = (!N[X]) * Uoh[1];
                         UoO[2] = (!N[Y]) * Uoh[2];
                         UoO[3] = (!N[Z]) * Uoh[3];
@@ -153,13 +162,13 @@ static void ApplyBoundaryCondition(const int p, const int r, int box[restrict][L
                         } else { /* otherwise, use specified constant wall temperature, T = Tw */
                             UoO[5] = UoGiven[5];
                         }
-                        UoO[0] = UoO[4] / (UoO[5] * model->gasR); /* compute density */
-                        MapConservative(model->gamma, UoO, UO);
+                        UoO[0] = ComputeDensity(model, UoO[4], UoO[5]);
+                        MapConservative(model, UoO, UO);
                         break;
                     case NOSLIPWALL:
-                        idxh = IndexNode(k - N[Z], j - N[Y], i - N[X], part->n[Y], part->n[X]);
+                        idxh = idxO - idxN;
                         Uh = node[idxh].U[tn];
-                        MapPrimitive(model->gamma, model->gasR, Uh, Uoh);
+                        MapPrimitive(model, Uh, Uoh);
                         UoO[1] = zero;
                         UoO[2] = zero;
                         UoO[3] = zero;
@@ -169,12 +178,20 @@ static void ApplyBoundaryCondition(const int p, const int r, int box[restrict][L
                         } else { /* otherwise, use specified constant wall temperature, T = Tw */
                             UoO[5] = UoGiven[5];
                         }
-                        UoO[0] = UoO[4] / (UoO[5] * model->gasR); /* compute density */
-                        MapConservative(model->gamma, UoO, UO);
+                        UoO[0] = ComputeDensity(model, UoO[4], UoO[5]);
+                        MapConservative(model, UoO, UO);
                         break;
                     case PERIODIC:
                         /* no treatment needed since the boundary participates normal computation */
                         break;
+                    case NROUTFLOW:
+                        /* fall through */
+                    case FARFIELD:
+                        idxh = idxO - idxN;
+                        Uh = node[idxh].U[tn];
+                        EnforceCharacteristic(part->typeBC[p], (p - PWB) / 2, N[(p - PWB) / 2], dt,
+                                UoGiven, Uh, node[idxO].U[TO], UO, model);
+                        break;
                     default:
                         break;
                 }
@@ -190,5 +207,149 @@ static void EnforceZeroGradient(const Real Uh[restrict], Real U[restrict])
     }
     return;
 }
+/*
+ * Characteristic non-reflecting boundary condition
+ * The boundary state is composed in the characteristic variables W = LU of
+ * the one dimensional Jacobian along the boundary normal, frozen at the
+ * average of the interior neighbour and the boundary state of the current
+ * time level TO. Outgoing characteristics are extrapolated from the
+ * interior. Incoming characteristics are held at the boundary state of TO,
+ * which is the discrete form of the LODI condition without incoming waves,
+ * and are relaxed towards the reference state at the relaxation rate K,
+ * dW/dt = -K (W - WRef), integrated exactly over the stage time step: a
+ * large K imposes the incoming waves of the reference state as a
+ * characteristic far field; a small K keeps the mean state from drifting
+ * as the Poinsot-Lele partially non-reflecting condition.
+ * The boundary state of TO and the target may be the same storage.
+ */
+static void EnforceCharacteristic(const int type, const int s, const int n, const Real dt,
+        const Real UoGiven[restrict], const Real Uh[restrict], const Real *Ub,
+        Real *U, const Model *model)
+{
+    const Real sigma = 1.0 - exp(-UoGiven[VARBC-1] * dt); /* relaxation factor of the stage */
+    Real Uob[DIMUo] = {0.0};
+    Real UoRef[DIMUo] = {0.0};
+    Real URef[DIMU] = {0.0};
+    MapPrimitive(model, Ub, Uob);
+    ComputeReference(type, UoGiven, Uob, UoRef);
+    MapConservative(model, UoRef, URef);
+    Real Uo[DIMUo] = {0.0}; /* averaged primitive variables */
+    Real Lambda[DIMU] = {0.0}; /* eigenvalues */
+    Real L[DIMU][DIMU] = {{0.0}}; /* left eigenvectors */
+    Real R[DIMU][DIMU] = {{0.0}}; /* right eigenvectors */
+    Real W[DIMU] = {0.0}; /* characteristic variables */
+    const Real gamma = SymmetricAverage(0, model, Uh, Ub, Uo);
+    Eigenvalue(s, Uo, Lambda);
+    EigenvectorL(s, gamma, Uo, L);
+    EigenvectorR(s, Uo, R);
+    Real Wh = 0.0;
+    Real Wb = 0.0;
+    Real WRef = 0.0;
+    for (int r = 0; r < DIMU; ++r) {
+        Wh = 0.0;
+        Wb = 0.0;
+        WRef = 0.0;
+        for (int m = 0; m < DIMU; ++m) {
+            Wh = Wh + L[r][m] * Uh[m];
+            Wb = Wb + L[r][m] * Ub[m];
+            WRef = WRef + L[r][m] * URef[m];
+        }
+        if (0.0 < n * Lambda[r]) { /* outgoing */
+            W[r] = Wh;
+        } else { /* incoming */
+            W[r] = Wb + sigma * (WRef - Wb);
+        }
+    }
+    for (int m = 0; m < DIMU; ++m) {
+        U[m] = 0.0;
+        for (int r = 0; r < DIMU; ++r) {
+            U[m] = U[m] + R[m][r] * W[r];
+        }
+    }
+    return;
+}
+/*
+ * The reference state of a far field is the specified state, while that
+ * of an outflow is the local state at the specified far-field pressure,
+ * which only controls the incoming acoustic wave and leaves the entropy
+ * and vorticity of a backflow held.
+ */
+static void ComputeReference(const int type, const Real UoGiven[restrict],
+        const Real Uo[restrict], Real UoRef[restrict])
+{
+    for (int n = 0; n < DIMUo; ++n) {
+        UoRef[n] = Uo[n];
+    }
+    if (FARFIELD == type) {
+        for (int n = 0; n < DIMU; ++n) {
+            UoRef[n] = UoGiven[n];
+        }
+    }
+    UoRef[4] = UoGiven[4];
+    return;
+}
+/*
+ * Sponge layer
+ * Within the layer adjacent to a non-reflecting boundary, the primitive
+ * variables are relaxed towards the reference state of the boundary by
+ * dUo/dt = -s(d) (Uo - UoRef) with s(d) = smax (1 - d / width)^2, which is
+ * integrated exactly. At corners the boundary with the strongest damping
+ * determines the reference state.
+ */
+void RelaxSpongeLayer(const Real dt, Space *space, const Model *model)
+{
+    const Partition *const part = &(space->part);
+    Node *const node = space->node;
+    const Real width = part->sponge[0];
+    Real Uo[DIMUo] = {0.0};
+    Real UoRef[DIMUo] = {0.0};
+    Real dist = 0.0; /* distance to boundary */
+    Real damp = 0.0; /* damping rate */
+    Real decay = 0.0; /* decay factor */
+    int pRef = 0; /* boundary determines the reference state */
+    int idx = 0; /* linear array index math variable */
+    for (int k = part->ns[PIN][Z][MIN]; k < part->ns[PIN][Z][MAX]; ++k) {
+        for (int j = part->ns[PIN][Y][MIN]; j < part->ns[PIN][Y][MAX]; ++j) {
+            for (int i = part->ns[PIN][X][MIN]; i < part->ns[PIN][X][MAX]; ++i) {
+                idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
+                if (0 != node[idx].did) {
+                    continue;
+                }
+                const IntVec nodeN = {i, j, k};
+                damp = 0.0;
+                for (int p = PWB; p <= PBB; ++p) {
+                    if ((NROUTFLOW != part->typeBC[p]) && (FARFIELD != part->typeBC[p])) {
+                        continue;
+                    }
+                    const int s = (p - PWB) / 2;
+                    dist = MapPoint(nodeN[s], part->domain[s][MIN], part->d[s], part->ng[s]);
+                    if (0 > part->N[p][s]) {
+                        dist = dist - part->domain[s][MIN];
+                    } else {
+                        dist = part->domain[s][MAX] - dist;
+                    }
+                    if (width <= dist) {
+                        continue;
+                    }
+                    if (damp < (1.0 - dist / width) * (1.0 - dist / width)) {
+                        damp = (1.0 - dist / width) * (1.0 - dist / width);
+                        pRef = p;
+                    }
+                }
+                if (0.0 == damp) {
+                    continue;
+                }
+                decay = exp(-part->sponge[1] * damp * dt);
+                MapPrimitive(model, node[idx].U[TO], Uo);
+                ComputeReference(part->typeBC[pRef], part->varBC[pRef], Uo, UoRef);
+                for (int n = 0; n < DIMU; ++n) {
+                    Uo[n] = UoRef[n] + decay * (Uo[n] - UoRef[n]);
+                }
+                MapConservative(model, Uo, node[idx].U[TO]);
+            }
+        }
+    }
+    return;
+}
 /* a good practice: end file with a newline */
 
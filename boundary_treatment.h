@@ -28,8 +28,20 @@
  *
  * Function
  *      Apply boundary conditions and treatments for the field variable.
+ *      The time step dt of the stage, measured from the current time level,
+ *      scales the relaxation of non-reflecting boundaries.
  */
-extern void TreatBoundary(const int tn, Space *, const Model *);
+extern void TreatBoundary(const int tn, const Real dt, Space *, const Model *);
+/*
+ * Sponge layer
+ *
+ * Function
+ *      Relax the field variable in the sponge layer of non-reflecting
+ *      boundaries towards their reference states over a time step.
+ *      Boundary nodes are not treated; the caller performs the boundary
+ *      treatment afterwards.
+ */
+extern void RelaxSpongeLayer(const Real dt, Space *, const Model *);
 #endif
 /* a good practice: end file with a newline */
 
@@ -69,20 +69,59 @@ static void GenerateCaseSettingFile(void)
     fprintf(fp, "1                  # space data writing frequency (int; 0: inf)\n");
     fprintf(fp, "1                  # data streamer (int; 0: ParaView; 1: Ensight)\n");
     fprintf(fp, "time end\n");
+    fprintf(fp, "#\n");
+    fprintf(fp, "adaptive cfl begin\n");
+    fprintf(fp, "0                  # CFL ceiling (<= CFL condition number: off)\n");
+    fprintf(fp, "1.05               # CFL growth factor per step in benign phases (>= 1)\n");
+    fprintf(fp, "adaptive cfl end\n");
+    fprintf(fp, "#\n");
+    fprintf(fp, "convergence begin\n");
+    fprintf(fp, "0                  # steady state monitoring interval (int; steps; 0: off)\n");
+    fprintf(fp, "3                  # consecutive converged samples to terminate (int)\n");
+    fprintf(fp, "1.0e-4             # residual tolerance (L2 of dU/dt relative to the first sample)\n");
+    fprintf(fp, "1.0e-3             # force tolerance (relative change of total force between samples)\n");
+    fprintf(fp, "0                  # force monitored body count (int; body numbers follow, one per line)\n");
+    fprintf(fp, "convergence end\n");
     fprintf(fp, "#------------------------------------------------------------------------------\n");
     fprintf(fp, "#\n");
     fprintf(fp, "#                        >> Numerical Method <<\n");
     fprintf(fp, "#\n");
     fprintf(fp, "#------------------------------------------------------------------------------\n");
     fprintf(fp, "numerical begin\n");
-    fprintf(fp, "1                  # temporal scheme (int; 0: RK2; 1: RK3;)\n");
-    fprintf(fp, "1                  # spatial scheme (int; 0: WENO3; 1: WENO5;)\n");
+    fprintf(fp, "1                  # temporal scheme (int; 0: RK2; 1: RK3; 2: SSPRK(5,4); 3: SSPRK(10,4))\n");
+    fprintf(fp, "1                  # spatial scheme (int; 0: WENO3; 1: WENO5; 2: MUSCL-HLLC)\n");
     fprintf(fp, "0                  # dimension scheme (int; 0: dim split; 1: dim by dim)\n");
     fprintf(fp, "0                  # Jacobian average (int; 0: Arithmetic; 1: Roe)\n");
     fprintf(fp, "0                  # flux splitting method (int; 0: LLF; 1: SW)\n");
     fprintf(fp, "0                  # phase interaction (int; 0: F; 1: FSI; 2: FSI+SSI)\n");
     fprintf(fp, "1                  # ibm reconstruction layers (int; 0: inf)\n");
     fprintf(fp, "numerical end\n");
+    fprintf(fp, "#\n");
+    fprintf(fp, "# Merging fuses adjacent same direction half sweeps of dimension splitting.\n");
+    fprintf(fp, "splitting begin\n");
+    fprintf(fp, "0                  # split sweep merging (int; 0: off; 1: within step; 2: within and across steps)\n");
+    fprintf(fp, "splitting end\n");
+    fprintf(fp, "#\n");
+    fprintf(fp, "contact begin\n");
+    fprintf(fp, "0                  # contact detection (int; 0: interfacial nodes; 1: geometric narrow phase)\n");
+    fprintf(fp, "contact end\n");
+    fprintf(fp, "#\n");
+    fprintf(fp, "# Wall models impose a modelled shear on noslip bodies of viscous flows.\n");
+    fprintf(fp, "wall model begin\n");
+    fprintf(fp, "0                  # wall model (int; 0: resolved; 1: log law; 2: Spalding)\n");
+    fprintf(fp, "wall model end\n");
+    fprintf(fp, "#\n");
+    fprintf(fp, "# Once the flow stays below the Mach threshold for the hold steps, steps are\n");
+    fprintf(fp, "# implicit dual time steps under the convective CFL condition, bounded by a\n");
+    fprintf(fp, "# multiple of the acoustic time step, with preconditioned pseudo time\n");
+    fprintf(fp, "# iterations. Steps return to explicit ones once the threshold is exceeded.\n");
+    fprintf(fp, "low mach begin\n");
+    fprintf(fp, "0                  # Mach number threshold of preconditioning (0: off)\n");
+    fprintf(fp, "10                 # consecutive steps below threshold before dual time (int >= 1)\n");
+    fprintf(fp, "100                # upper bound of dual time step in acoustic time steps (>= 1)\n");
+    fprintf(fp, "20                 # maximum pseudo time iterations per step (int)\n");
+    fprintf(fp, "1.0e-2             # momentum residual reduction to stop pseudo time iterations\n");
+    fprintf(fp, "low mach end\n");
     fprintf(fp, "#------------------------------------------------------------------------------\n");
     fprintf(fp, "#\n");
     fprintf(fp, "#                        >> Material Properties <<\n");
@@ -94,6 +133,10 @@ static void GenerateCaseSettingFile(void)
     fprintf(fp, "0                  # gravity state (int; 0: off; 1: on)\n");
     fprintf(fp, "0, -9.806, 0       # gravity vector\n");
     fprintf(fp, "material end\n");
+    fprintf(fp, "#\n");
+    fprintf(fp, "equation of state begin\n");
+    fprintf(fp, "0                  # equation of state (int; 0: ideal gas; 1: table in artracfd.eos)\n");
+    fprintf(fp, "equation of state end\n");
     fprintf(fp, "#------------------------------------------------------------------------------\n");
     fprintf(fp, "#\n");
     fprintf(fp, "#                        >> Reference Values  <<\n");
@@ -126,7 +169,8 @@ static void GenerateCaseSettingFile(void)
     fprintf(fp, "#\n");
     fprintf(fp, "#                        >> Boundary Condition <<\n");
     fprintf(fp, "#\n");
-    fprintf(fp, "# Available types: [inflow], [outflow], [slip wall], [noslip wall], [periodic]\n");
+    fprintf(fp, "# Available types: [inflow], [outflow], [slip wall], [noslip wall], [periodic],\n");
+    fprintf(fp, "# [nonreflecting outflow], [far field]\n");
     fprintf(fp, "#------------------------------------------------------------------------------\n");
     fprintf(fp, "#west boundary begin\n");
     fprintf(fp, "#inflow            # boundary type\n");
@@ -137,6 +181,22 @@ static void GenerateCaseSettingFile(void)
     fprintf(fp, "#1                 # pressure\n");
     fprintf(fp, "#west boundary end\n");
     fprintf(fp, "#\n");
+    fprintf(fp, "#west boundary begin\n");
+    fprintf(fp, "#far field         # boundary type\n");
+    fprintf(fp, "#1                 # density\n");
+    fprintf(fp, "#1                 # x velocity\n");
+    fprintf(fp, "#0                 # y velocity\n");
+    fprintf(fp, "#0                 # z velocity\n");
+    fprintf(fp, "#1                 # pressure\n");
+    fprintf(fp, "#1000              # relaxation rate of incoming characteristics (>= 0)\n");
+    fprintf(fp, "#west boundary end\n");
+    fprintf(fp, "#\n");
+    fprintf(fp, "#east boundary begin\n");
+    fprintf(fp, "#nonreflecting outflow # boundary type\n");
+    fprintf(fp, "#1                 # far-field pressure\n");
+    fprintf(fp, "#0.3               # relaxation rate of incoming characteristics (>= 0)\n");
+    fprintf(fp, "#east boundary end\n");
+    fprintf(fp, "#\n");
     fprintf(fp, "west boundary begin\n");
     fprintf(fp, "outflow            # boundary type\n");
     fprintf(fp, "west boundary end\n");
@@ -162,6 +222,11 @@ static void GenerateCaseSettingFile(void)
     fprintf(fp, "back boundary begin\n");
     fprintf(fp, "outflow            # boundary type\n");
     fprintf(fp, "back boundary end\n");
+    fprintf(fp, "#\n");
+    fprintf(fp, "sponge layer begin\n");
+    fprintf(fp, "0                  # sponge layer width at non-reflecting boundaries (0: off)\n");
+    fprintf(fp, "0                  # sponge layer damping strength\n");
+    fprintf(fp, "sponge layer end\n");
     fprintf(fp, "#------------------------------------------------------------------------------\n");
     fprintf(fp, "#\n");
     fprintf(fp, "#                  >> Regional Initialization <<\n");
@@ -231,7 +296,7 @@ static void GenerateCaseSettingFile(void)
     fprintf(fp, "probe count begin\n");
     fprintf(fp, "2                  # point probe count (int; 0: off)\n");
     fprintf(fp, "1                  # line probe count (int; 0: off)\n");
-    fprintf(fp, "1                  # body-conformal probe (int; 0: off; 1: on)\n");
+    fprintf(fp, "1                  # body-conformal probe (int; 0: off; 1: ghost; 2: surface)\n");
     fprintf(fp, "1                  # surface force probe (int; 0: off; 1: on)\n");
     fprintf(fp, "probe count end\n");
     fprintf(fp, "#\n");
@@ -252,6 +317,45 @@ static void GenerateCaseSettingFile(void)
     fprintf(fp, "2.5, 2.2197, 0     # x2, y2, z2\n");
     fprintf(fp, "500                # resolution\n");
     fprintf(fp, "line probe end\n");
+    fprintf(fp, "#\n");
+    fprintf(fp, "slice image begin\n");
+    fprintf(fp, "0                  # slice image count (int; 0: off)\n");
+    fprintf(fp, "10                 # slice image writing frequency (int; steps; 0: off)\n");
+    fprintf(fp, "0                  # slice image format (int; 0: PNG; 1: PFM float map)\n");
+    fprintf(fp, "2, 0, 2            # normal axis (int; 0: x; 1: y; 2: z), position, variable (int; 0: rho; 1: p; 2: schlieren; 3: did)\n");
+    fprintf(fp, "0, 1               # colour map range min, max (min >= max: adaptive)\n");
+    fprintf(fp, "slice image end\n");
+    fprintf(fp, "#------------------------------------------------------------------------------\n");
+    fprintf(fp, "#\n");
+    fprintf(fp, "#                    >> Performance Tuning <<\n");
+    fprintf(fp, "#\n");
+    fprintf(fp, "# Tuning cache is artracfd.tune or the file given by ARTRACFD_TUNE.\n");
+    fprintf(fp, "#------------------------------------------------------------------------------\n");
+    fprintf(fp, "tuning begin\n");
+    fprintf(fp, "0                  # kernel autotuning (int; 0: off; 1: on; 2: renew cache)\n");
+    fprintf(fp, "1, 1, 1            # sweep tile width x, y, z (int; used if autotuning off)\n");
+    fprintf(fp, "tuning end\n");
+    fprintf(fp, "#\n");
+    fprintf(fp, "threading begin\n");
+    fprintf(fp, "1                  # worker threads for sweeps and geometry classification (int; 1: serial)\n");
+    fprintf(fp, "threading end\n");
+    fprintf(fp, "#\n");
+    fprintf(fp, "reordering begin\n");
+    fprintf(fp, "0                  # geometry reordering interval (int; steps; 0: off)\n");
+    fprintf(fp, "reordering end\n");
+    fprintf(fp, "#\n");
+    fprintf(fp, "distance field begin\n");
+    fprintf(fp, "0                  # signed distance field samples on the longest side of triangulated bodies (int; 0: off)\n");
+    fprintf(fp, "distance field end\n");
+    fprintf(fp, "#\n");
+    fprintf(fp, "cost report begin\n");
+    fprintf(fp, "0                  # most expensive bodies reported at each snapshot (int; 0: off)\n");
+    fprintf(fp, "cost report end\n");
+    fprintf(fp, "#\n");
+    fprintf(fp, "staging begin\n");
+    fprintf(fp, "none               # local staging directory of output (string; none: write in place)\n");
+    fprintf(fp, ".                  # destination directory of staged output (string)\n");
+    fprintf(fp, "staging end\n");
     fprintf(fp, "#------------------------------------------------------------------------------\n");
     fprintf(fp, "#------------------------------------------------------------------------------\n");
     fprintf(fp, "#/* a good practice: end file with a newline */\n");
@@ -334,6 +438,9 @@ static void GenerateCaseGeometryFile(void)
     fprintf(fp, "polyhedron transform begin\n");
     fprintf(fp, "1, 1, 1, 0, 0, 0, 0, 0, 0 # scale, rotate, translate\n");
     fprintf(fp, "polyhedron transform end\n");
+    fprintf(fp, "polyhedron decimation begin\n");
+    fprintf(fp, "0, 0.05           # facet size, error bound in grid spacing (size <= 0: off)\n");
+    fprintf(fp, "polyhedron decimation end\n");
     fprintf(fp, "#------------------------------------------------------------------------------\n");
     fprintf(fp, "#------------------------------------------------------------------------------\n");
     fprintf(fp, "#/* a good practice: end file with a newline */\n");
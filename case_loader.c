@@ -33,13 +33,16 @@ void LoadCaseData(Time *time, Space *space, Model *model)
 {
     ReadCaseSettingData(time, space, model);
     ReadGeometrySettingData(&(space->geo));
-    WriteVerifyData(time, space, model);
+    if (0 == time->mute) {
+        WriteVerifyData(time, space, model);
+    }
     CheckCaseSettingData(time, space, model);
     return;
 }
 static void ReadCaseSettingData(Time *time, Space *space, Model *model)
 {
     Partition *const part = &(space->part);
+    Geometry *const geo = &(space->geo);
     part->typeBC = AssignStorage(NBC * sizeof(*part->typeBC));
     part->N = AssignStorage(NBC * sizeof(*part->N));
     part->varBC = AssignStorage(NBC * sizeof(*part->varBC));
@@ -52,6 +55,7 @@ static void ReadCaseSettingData(Time *time, Space *space, Model *model)
     int nentry = 0; /* entry count */
     const char *fmtI = ParseFormat("%lg");
     const char *fmtJ = ParseFormat("%lg, %lg, %lg");
+    const char *fmtK = ParseFormat("%lg, %lg");
     while (NULL != fgets(str, sizeof str, fp)) {
         ParseCommand(str);
         if (0 == strncmp(str, "space begin", sizeof str)) {
@@ -84,6 +88,30 @@ static void ReadCaseSettingData(Time *time, Space *space, Model *model)
             Sread(fp, 1, "%d", &(model->ibmLayer));
             continue;
         }
+        if (0 == strncmp(str, "splitting begin", sizeof str)) {
+            /* optional entry do not increase entry count */
+            Sread(fp, 1, "%d", &(model->merge));
+            continue;
+        }
+        if (0 == strncmp(str, "contact begin", sizeof str)) {
+            /* optional entry do not increase entry count */
+            Sread(fp, 1, "%d", &(model->contact));
+            continue;
+        }
+        if (0 == strncmp(str, "wall model begin", sizeof str)) {
+            /* optional entry do not increase entry count */
+            Sread(fp, 1, "%d", &(model->wall));
+            continue;
+        }
+        if (0 == strncmp(str, "low mach begin", sizeof str)) {
+            /* optional entry do not increase entry count */
+            Sread(fp, 1, fmtI, &(model->pcMa));
+            Sread(fp, 1, "%d", &(model->pcHold));
+            Sread(fp, 1, fmtI, &(model->pcStep));
+            Sread(fp, 1, "%d", &(model->pcIter));
+            Sread(fp, 1, fmtI, &(model->pcTol));
+            continue;
+        }
         if (0 == strncmp(str, "material begin", sizeof str)) {
             ++nentry;
             Sread(fp, 1, "%d", &(model->mid));
@@ -92,6 +120,11 @@ static void ReadCaseSettingData(Time *time, Space *space, Model *model)
             Sread(fp, 3, fmtJ, &(model->g[X]), &(model->g[Y]), &(model->g[Z]));
             continue;
         }
+        if (0 == strncmp(str, "equation of state begin", sizeof str)) {
+            /* optional entry do not increase entry count */
+            Sread(fp, 1, "%d", &(model->eos));
+            continue;
+        }
         if (0 == strncmp(str, "reference begin", sizeof str)) {
             ++nentry;
             Sread(fp, 1, fmtI, &(model->refL));
@@ -138,6 +171,12 @@ static void ReadCaseSettingData(Time *time, Space *space, Model *model)
             ReadBoundaryData(fp, space, PBB);
             continue;
         }
+        if (0 == strncmp(str, "sponge layer begin", sizeof str)) {
+            /* optional entry do not increase entry count */
+            Sread(fp, 1, fmtI, &(part->sponge[0]));
+            Sread(fp, 1, fmtI, &(part->sponge[1]));
+            continue;
+        }
         if (0 == strncmp(str, "plane initialization begin", sizeof str)) {
             /* optional entry do not increase entry count */
             part->typeIC[part->nIC] = ICPLANE;
@@ -212,6 +251,38 @@ static void ReadCaseSettingData(Time *time, Space *space, Model *model)
             }
             continue;
         }
+        if (0 == strncmp(str, "tuning begin", sizeof str)) {
+            /* optional entry do not increase entry count */
+            Sread(fp, 1, "%d", &(part->tune));
+            Sread(fp, 3, "%d, %d, %d", &(part->tile[X]), &(part->tile[Y]), &(part->tile[Z]));
+            continue;
+        }
+        if (0 == strncmp(str, "threading begin", sizeof str)) {
+            /* optional entry do not increase entry count */
+            Sread(fp, 1, "%d", &(part->thread));
+            continue;
+        }
+        if (0 == strncmp(str, "reordering begin", sizeof str)) {
+            /* optional entry do not increase entry count */
+            Sread(fp, 1, "%d", &(geo->reorder));
+            continue;
+        }
+        if (0 == strncmp(str, "distance field begin", sizeof str)) {
+            /* optional entry do not increase entry count */
+            Sread(fp, 1, "%d", &(geo->sdf));
+            continue;
+        }
+        if (0 == strncmp(str, "cost report begin", sizeof str)) {
+            /* optional entry do not increase entry count */
+            Sread(fp, 1, "%d", &(geo->costN));
+            continue;
+        }
+        if (0 == strncmp(str, "staging begin", sizeof str)) {
+            /* optional entry do not increase entry count */
+            Sread(fp, 1, "%s", time->stage);
+            Sread(fp, 1, "%s", time->drain);
+            continue;
+        }
         if (0 == strncmp(str, "line probe begin", sizeof str)) {
             /* optional entry do not increase entry count */
             for (int n = 0; n < time->dataN[PROLN]; ++n) {
@@ -223,6 +294,42 @@ static void ReadCaseSettingData(Time *time, Space *space, Model *model)
             }
             continue;
         }
+        if (0 == strncmp(str, "adaptive cfl begin", sizeof str)) {
+            /* optional entry do not increase entry count */
+            Sread(fp, 1, fmtI, &(time->cflMax));
+            Sread(fp, 1, fmtI, &(time->cflRate));
+            continue;
+        }
+        if (0 == strncmp(str, "convergence begin", sizeof str)) {
+            /* optional entry do not increase entry count */
+            Sread(fp, 1, "%d", &(time->cvgW));
+            Sread(fp, 1, "%d", &(time->cvgN));
+            Sread(fp, 1, fmtI, time->cvgTol + 0);
+            Sread(fp, 1, fmtI, time->cvgTol + 1);
+            Sread(fp, 1, "%d", &(time->cvgB));
+            if (0 < time->cvgB) {
+                time->cvgId = AssignStorage(time->cvgB * sizeof(*time->cvgId));
+            }
+            for (int n = 0; n < time->cvgB; ++n) {
+                Sread(fp, 1, "%d", time->cvgId + n);
+            }
+            continue;
+        }
+        if (0 == strncmp(str, "slice image begin", sizeof str)) {
+            /* optional entry do not increase entry count */
+            Sread(fp, 1, "%d", &(time->imgN));
+            Sread(fp, 1, "%d", &(time->imgW));
+            Sread(fp, 1, "%d", &(time->imgF));
+            if (0 < time->imgN) {
+                time->img = AssignStorage(time->imgN * sizeof(*time->img));
+            }
+            for (int n = 0; n < time->imgN; ++n) {
+                Sread(fp, 3, fmtJ, time->img[n] + 0,
+                        time->img[n] + 1, time->img[n] + 2);
+                Sread(fp, 2, fmtK, time->img[n] + 3, time->img[n] + 4);
+            }
+            continue;
+        }
     }
     fclose(fp);
     if (12 != nentry) {
@@ -280,6 +387,17 @@ static void ReadBoundaryData(FILE *fp, Space *space, const int n)
         part->typeBC[n] = PERIODIC;
         return;
     }
+    if (0 == strncmp(str, "nonreflecting outflow", sizeof str)) {
+        part->typeBC[n] = NROUTFLOW;
+        Sread(fp, 1, fmtI, &(part->varBC[n][4]));
+        Sread(fp, 1, fmtI, &(part->varBC[n][VARBC-1]));
+        return;
+    }
+    if (0 == strncmp(str, "far field", sizeof str)) {
+        part->typeBC[n] = FARFIELD;
+        ReadConsecutiveData(fp, VARBC, fmtI, part->varBC[n], NULL);
+        return;
+    }
     ShowError("unidentified boundary type: n: %d, type: %s", n, str);
     return;
 }
@@ -325,6 +443,20 @@ static void WriteBoundaryData(FILE *fp, const Space *space, const int n)
         case PERIODIC:
             fprintf(fp, "boundary type: periodic\n");
             break;
+        case NROUTFLOW:
+            fprintf(fp, "boundary type: nonreflecting outflow\n");
+            fprintf(fp, "pressure: %.6g\n", part->varBC[n][4]);
+            fprintf(fp, "relaxation rate: %.6g\n", part->varBC[n][VARBC-1]);
+            break;
+        case FARFIELD:
+            fprintf(fp, "boundary type: far field\n");
+            fprintf(fp, "density: %.6g\n", part->varBC[n][0]);
+            fprintf(fp, "x velocity: %.6g\n", part->varBC[n][1]);
+            fprintf(fp, "y velocity: %.6g\n", part->varBC[n][2]);
+            fprintf(fp, "z velocity: %.6g\n", part->varBC[n][3]);
+            fprintf(fp, "pressure: %.6g\n", part->varBC[n][4]);
+            fprintf(fp, "relaxation rate: %.6g\n", part->varBC[n][VARBC-1]);
+            break;
         default:
             ShowError("unidentified boundary type: n: %d, type: %d", n, part->typeBC[n]);
             break;
@@ -378,6 +510,7 @@ static void WriteInitializerData(FILE *fp, const Space *space, const int n)
 static void WriteVerifyData(const Time *time, const Space *space, const Model *model)
 {
     const Partition *const part = &(space->part);
+    const Geometry *const geo = &(space->geo);
     const char *fname = "artracfd.verify";
     FILE *fp = Fopen(fname, "w");
     fprintf(fp, "#------------------------------------------------------------------------------\n");
@@ -403,8 +536,17 @@ static void WriteVerifyData(const Time *time, const Space *space, const Model *m
     fprintf(fp, "restart number tag: %d\n", time->restart);
     fprintf(fp, "termination time: %.6g\n", time->end);
     fprintf(fp, "CFL condition number: %.6g\n", time->numCFL);
+    fprintf(fp, "adaptive CFL ceiling: %.6g\n", time->cflMax);
+    fprintf(fp, "adaptive CFL growth factor: %.6g\n", time->cflRate);
     fprintf(fp, "maximum computing steps: %d\n", time->stepN);
     fprintf(fp, "space data writing frequency: %d\n", time->dataW[PROSD]);
+    fprintf(fp, "convergence monitoring interval: %d\n", time->cvgW);
+    fprintf(fp, "converged samples to terminate: %d\n", time->cvgN);
+    fprintf(fp, "residual tolerance: %.6g\n", time->cvgTol[0]);
+    fprintf(fp, "force tolerance: %.6g\n", time->cvgTol[1]);
+    for (int n = 0; n < time->cvgB; ++n) {
+        fprintf(fp, "force monitored body: %d\n", time->cvgId[n]);
+    }
     fprintf(fp, "data streamer: %d\n", time->dataStreamer);
     fprintf(fp, "#------------------------------------------------------------------------------\n");
     fprintf(fp, "#\n");
@@ -414,10 +556,18 @@ static void WriteVerifyData(const Time *time, const Space *space, const Model *m
     fprintf(fp, "temporal scheme: %d\n", model->tScheme);
     fprintf(fp, "spatial scheme: %d\n", model->sScheme);
     fprintf(fp, "dimensional scheme: %d\n", model->multidim);
+    fprintf(fp, "split sweep merging: %d\n", model->merge);
     fprintf(fp, "Jacobian average: %d\n", model->jacobMean);
     fprintf(fp, "flux splitting method: %d\n", model->fluxSplit);
     fprintf(fp, "phase interaction: %d\n", model->psi);
+    fprintf(fp, "contact detection: %d\n", model->contact);
     fprintf(fp, "ibm reconstruction layers: %d\n", model->ibmLayer);
+    fprintf(fp, "ibm wall model: %d\n", model->wall);
+    fprintf(fp, "low Mach preconditioning threshold: %.6g\n", model->pcMa);
+    fprintf(fp, "steps below threshold before dual time: %d\n", model->pcHold);
+    fprintf(fp, "dual time step bound in acoustic steps: %.6g\n", model->pcStep);
+    fprintf(fp, "pseudo time iterations: %d\n", model->pcIter);
+    fprintf(fp, "pseudo time residual reduction: %.6g\n", model->pcTol);
     fprintf(fp, "#------------------------------------------------------------------------------\n");
     fprintf(fp, "#\n");
     fprintf(fp, "#                       >> Material Properties <<\n");
@@ -427,6 +577,7 @@ static void WriteVerifyData(const Time *time, const Space *space, const Model *m
     fprintf(fp, "viscous level: %.6g\n", model->refMu);
     fprintf(fp, "gravity state: %d\n", model->gState);
     fprintf(fp, "gravity vector: %.6g, %.6g, %.6g\n", model->g[X], model->g[Y], model->g[Z]);
+    fprintf(fp, "equation of state: %d\n", model->eos);
     fprintf(fp, "#------------------------------------------------------------------------------\n");
     fprintf(fp, "#\n");
     fprintf(fp, "#                        >> Reference Values  <<\n");
@@ -465,6 +616,9 @@ static void WriteVerifyData(const Time *time, const Space *space, const Model *m
     fprintf(fp, "#\n");
     fprintf(fp, "Domian Back\n");
     WriteBoundaryData(fp, space, PBB);
+    fprintf(fp, "#\n");
+    fprintf(fp, "sponge layer width: %.6g\n", part->sponge[0]);
+    fprintf(fp, "sponge layer damping strength: %.6g\n", part->sponge[1]);
     fprintf(fp, "#------------------------------------------------------------------------------\n");
     fprintf(fp, "#\n");
     fprintf(fp, "#                  >> Regional Initialization <<\n");
@@ -501,6 +655,28 @@ static void WriteVerifyData(const Time *time, const Space *space, const Model *m
                 time->lp[n][3], time->lp[n][4], time->lp[n][5]);
         fprintf(fp, "resolution: %.6g\n", time->lp[n][6]);
     }
+    fprintf(fp, "#\n");
+    fprintf(fp, "slice image count: %d\n", time->imgN);
+    fprintf(fp, "slice image writing frequency: %d\n", time->imgW);
+    fprintf(fp, "slice image format: %d\n", time->imgF);
+    for (int n = 0; n < time->imgN; ++n) {
+        fprintf(fp, "slice axis, position, variable: %.6g, %.6g, %.6g\n",
+                time->img[n][0], time->img[n][1], time->img[n][2]);
+        fprintf(fp, "slice range min, max: %.6g, %.6g\n", time->img[n][3], time->img[n][4]);
+    }
+    fprintf(fp, "#------------------------------------------------------------------------------\n");
+    fprintf(fp, "#\n");
+    fprintf(fp, "#                    >> Performance Tuning <<\n");
+    fprintf(fp, "#\n");
+    fprintf(fp, "#------------------------------------------------------------------------------\n");
+    fprintf(fp, "kernel autotuning: %d\n", part->tune);
+    fprintf(fp, "sweep tile width x, y, z: %d, %d, %d\n", part->tile[X], part->tile[Y], part->tile[Z]);
+    fprintf(fp, "worker threads: %d\n", part->thread);
+    fprintf(fp, "geometry reordering interval: %d\n", geo->reorder);
+    fprintf(fp, "distance field samples: %d\n", geo->sdf);
+    fprintf(fp, "bodies in cost report: %d\n", geo->costN);
+    fprintf(fp, "output staging directory: %s\n", time->stage);
+    fprintf(fp, "output destination directory: %s\n", time->drain);
     fprintf(fp, "#------------------------------------------------------------------------------\n");
     fprintf(fp, "#------------------------------------------------------------------------------\n");
     fclose(fp);
@@ -522,19 +698,82 @@ static void CheckCaseSettingData(const Time *time, const Space *space, const Mod
     if ((1 > part->proc[X]) || (1 > part->proc[Y]) || (1 > part->proc[Z])) {
         ShowError("processor number should be positive");
     }
+    if ((0 > part->tune) || (0 > part->thread) || (0 > space->geo.reorder) || (0 > space->geo.sdf) || (0 > space->geo.costN) || (TILEN < part->tile[X]) || (TILEN < part->tile[Y]) || (TILEN < part->tile[Z])) {
+        ShowError("tuning values should be nonnegative and tile width should not exceed %d", TILEN);
+    }
+    for (int n = 0; n < time->imgN; ++n) {
+        if ((X > (int)time->img[n][0]) || (Z < (int)time->img[n][0]) ||
+                (IMGRHO > (int)time->img[n][2]) || (IMGDID < (int)time->img[n][2])) {
+            ShowError("unidentified slice image axis or variable: %d", n + 1);
+        }
+    }
+    if ((IMGPNG > time->imgF) || (IMGPFM < time->imgF)) {
+        ShowError("unidentified slice image format: %d", time->imgF);
+    }
     /* time */
     if ((0 > time->restart) || (zero >= time->end) || (zero >= time->numCFL)) {
         ShowError("values in time section should not be negative");
     }
+    if ((time->numCFL < time->cflMax) && (1.0 > time->cflRate)) {
+        ShowError("adaptive CFL growth factor should not be less than 1");
+    }
+    if ((0 > time->cvgN) || (0 > time->cvgB) || (zero > time->cvgTol[0]) || (zero > time->cvgTol[1])) {
+        ShowError("convergence monitor values should not be negative");
+    }
+    if ((0 < time->cvgW) && (1 > time->cvgN)) {
+        ShowError("converged samples to terminate should be at least 1 when monitoring");
+    }
+    for (int n = 0; n < time->cvgB; ++n) {
+        if ((1 > time->cvgId[n]) || (space->geo.sphN + space->geo.stlN < time->cvgId[n])) {
+            ShowError("force monitored body out of range: %d", time->cvgId[n]);
+        }
+    }
+    /* boundary condition */
+    for (int p = PWB; p <= PBB; ++p) {
+        if (((NROUTFLOW == part->typeBC[p]) || (FARFIELD == part->typeBC[p])) &&
+                (zero > part->varBC[p][VARBC-1])) {
+            ShowError("non-reflecting boundary relaxation rate should not be negative: %d", p);
+        }
+    }
+    if ((zero > part->sponge[0]) || (zero > part->sponge[1])) {
+        ShowError("sponge layer values should not be negative");
+    }
+    if ((0 > time->dataN[PROCV]) || (CURVESURF < time->dataN[PROCV])) {
+        ShowError("unidentified body-conformal probe: %d", time->dataN[PROCV]);
+    }
     /* numerical method */
     if ((0 > model->tScheme) || (0 > model->sScheme) || (0 > model->multidim) ||
             (0 > model->jacobMean) || (0 > model->fluxSplit) || (0 > model->psi)) {
         ShowError("values in numerical section should not be negative");
     }
+    if (RKTENFOUR < model->tScheme) {
+        ShowError("unidentified temporal scheme: %d", model->tScheme);
+    }
+    if (MUSCLHLLC < model->sScheme) {
+        ShowError("unidentified spatial scheme: %d", model->sScheme);
+    }
+    if ((CONTACTNODE > model->contact) || (CONTACTMESH < model->contact)) {
+        ShowError("unidentified contact detection: %d", model->contact);
+    }
+    if ((WALLN > model->wall) || (WALLSPALDING < model->wall)) {
+        ShowError("unidentified wall model: %d", model->wall);
+    }
+    if ((MERGEN > model->merge) || (MERGEALL < model->merge)) {
+        ShowError("unidentified split sweep merging: %d", model->merge);
+    }
+    if ((zero < model->pcMa) && ((1 > model->pcIter) || (zero >= model->pcTol) || (1.0 <= model->pcTol))) {
+        ShowError("low Mach preconditioning needs iterations >= 1 and residual reduction in (0, 1)");
+    }
+    if ((zero < model->pcMa) && ((1 > model->pcHold) || (1.0 > model->pcStep))) {
+        ShowError("low Mach preconditioning needs hold steps >= 1 and step bound >= 1");
+    }
     /* material */
     if ((0 > model->mid)) {
         ShowError("material type should not be negative");
     }
+    if ((EOSIDEAL != model->eos) && (EOSTABLE != model->eos)) {
+        ShowError("unidentified equation of state: %d", model->eos);
+    }
     /* reference */
     if ((zero >= model->refL) || (zero >= model->refRho) ||
             (zero >= model->refV) || (zero >= model->refT)) {
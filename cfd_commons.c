@@ -15,6 +15,7 @@
 #include <stdio.h> /* standard library for input and output */
 #include <math.h> /* common mathematical functions */
 #include <float.h> /* size of floating point values */
+#include "equation_of_state.h"
 #include "commons.h"
 /****************************************************************************
  * Function Pointers
@@ -37,6 +38,7 @@ typedef void (*ConvectiveFluxComputer)(const Real, const Real, const Real, const
  ****************************************************************************/
 static void LocalLaxFriedrichs(const Real [restrict], Real [restrict], Real [restrict]);
 static void StegerWarming(const Real [restrict], Real [restrict], Real [restrict]);
+static void PreconditionedLaxFriedrichs(const Real [restrict], Real [restrict], Real [restrict]);
 static void EigenvectorLX(const Real, const Real, const Real, const Real,
         const Real, const Real, Real [restrict][DIMU]);
 static void EigenvectorLY(const Real, const Real, const Real, const Real,
@@ -58,9 +60,10 @@ static void ConvectiveFluxZ(const Real, const Real, const Real, const Real,
 /****************************************************************************
  * Global Variables Definition with Private Scope
  ****************************************************************************/
-static EigenvalueSplitter SplitEigenvalue[2] = {
+static EigenvalueSplitter SplitEigenvalue[3] = {
     LocalLaxFriedrichs,
-    StegerWarming};
+    StegerWarming,
+    PreconditionedLaxFriedrichs};
 static EigenvectorLComputer ComputeEigenvectorL[DIMS] = {
     EigenvectorLX,
     EigenvectorLY,
@@ -76,19 +79,37 @@ static ConvectiveFluxComputer ComputeConvectiveFlux[DIMS] = {
 /****************************************************************************
  * Function definitions
  ****************************************************************************/
-void SymmetricAverage(const int averager, const Real gamma,
+/*
+ * For a tabulated equation of state, the total enthalpy of each side is
+ * formed with the tabulated pressure and the speed of sound is averaged
+ * from the tabulated ones with the same weights, so that the eigenvalues
+ * carry the actual acoustic speeds. The eigenvectors keep the ideal gas
+ * form with the equivalent gamma = 1 + c^2 / h of the averaged state,
+ * which keeps the left and right eigenvectors mutually inverse.
+ */
+Real SymmetricAverage(const int averager, const Model *model,
         const Real UL[restrict], const Real UR[restrict], Real Uo[restrict])
 {
+    const Real gamma = model->gamma;
     const Real rhoL = UL[0];
     const Real uL = UL[1] / UL[0];
     const Real vL = UL[2] / UL[0];
     const Real wL = UL[3] / UL[0];
-    const Real hTL = (UL[4] / UL[0]) * gamma - 0.5 * (uL * uL + vL * vL + wL * wL) * (gamma - 1.0);
     const Real rhoR = UR[0];
     const Real uR = UR[1] / UR[0];
     const Real vR = UR[2] / UR[0];
     const Real wR = UR[3] / UR[0];
-    const Real hTR = (UR[4] / UR[0]) * gamma - 0.5 * (uR * uR + vR * vR + wR * wR) * (gamma - 1.0);
+    Real hTL = (UL[4] / UL[0]) * gamma - 0.5 * (uL * uL + vL * vL + wL * wL) * (gamma - 1.0);
+    Real hTR = (UR[4] / UR[0]) * gamma - 0.5 * (uR * uR + vR * vR + wR * wR) * (gamma - 1.0);
+    Real pTcL[EOSN] = {0.0}; /* tabulated states of the left side */
+    Real pTcR[EOSN] = {0.0}; /* tabulated states of the right side */
+    if (EOSIDEAL != model->eos) {
+        LookupEos(model->mat, rhoL, UL[4] / UL[0] - 0.5 * (uL * uL + vL * vL + wL * wL), pTcL);
+        LookupEos(model->mat, rhoR, UR[4] / UR[0] - 0.5 * (uR * uR + vR * vR + wR * wR), pTcR);
+        hTL = (UL[4] + pTcL[EOSP]) / UL[0];
+        hTR = (UR[4] + pTcR[EOSP]) / UR[0];
+    }
+    Real c = 0.0; /* averaged tabulated speed of sound */
     Real D = 0.0;
     switch (averager) {
         case 0: /* arithmetic mean */
@@ -96,6 +117,7 @@ void SymmetricAverage(const int averager, const Real gamma,
             Uo[2] = 0.5 * (vL + vR); /* v average */
             Uo[3] = 0.5 * (wL + wR); /* w average */
             Uo[4] = 0.5 * (hTL + hTR); /* hT average */
+            c = 0.5 * (pTcL[EOSC] + pTcR[EOSC]);
             break;
         case 1: /* Roe average */
             D = sqrt(rhoR / rhoL);
@@ -103,12 +125,18 @@ void SymmetricAverage(const int averager, const Real gamma,
             Uo[2] = (vL + D * vR) / (1.0 + D); /* v average */
             Uo[3] = (wL + D * wR) / (1.0 + D); /* w average */
             Uo[4] = (hTL + D * hTR) / (1.0 + D); /* hT average */
+            c = (pTcL[EOSC] + D * pTcR[EOSC]) / (1.0 + D);
             break;
         default:
             break;
     }
-    Uo[5] = sqrt((gamma - 1.0) * (Uo[4] - 0.5 * (Uo[1] * Uo[1] + Uo[2] * Uo[2] + Uo[3] * Uo[3]))); /* the speed of sound */
-    return;
+    const Real h = Uo[4] - 0.5 * (Uo[1] * Uo[1] + Uo[2] * Uo[2] + Uo[3] * Uo[3]); /* static enthalpy */
+    if (EOSIDEAL == model->eos) {
+        Uo[5] = sqrt((gamma - 1.0) * h); /* the speed of sound */
+        return gamma;
+    }
+    Uo[5] = c;
+    return 1.0 + c * c / h;
 }
 void Eigenvalue(const int s, const Real Uo[restrict], Real Lambda[restrict])
 {
@@ -146,6 +174,20 @@ static void StegerWarming(const Real Lambda[restrict],
     }
     return;
 }
+/*
+ * The acoustic speeds of a preconditioned system are not centred at Vs,
+ * hence the local maximum is taken from the acoustic eigenvalues directly.
+ */
+static void PreconditionedLaxFriedrichs(const Real Lambda[restrict],
+        Real LambdaP[restrict], Real LambdaN[restrict])
+{
+    const Real lambdaStar = MaxReal(fabs(Lambda[0]), fabs(Lambda[4]));
+    for (int r = 0; r < DIMU; ++r) {
+        LambdaP[r] = 0.5 * (Lambda[r] + lambdaStar);
+        LambdaN[r] = 0.5 * (Lambda[r] - lambdaStar);
+    }
+    return;
+}
 void EigenvectorL(const int s, const Real gamma, const Real Uo[restrict], Real L[restrict][DIMU])
 {
     const Real u = Uo[1];
@@ -244,14 +286,78 @@ static void EigenvectorRZ(const Real u, const Real v, const Real w, const Real h
     R[4][0] = hT - w * c;  R[4][1] = u;    R[4][2] = v;    R[4][3] = w * w - q;  R[4][4] = hT + w * c;
     return;
 }
-void ConvectiveFlux(const int s, const Real gamma, const Real U[restrict], Real F[restrict])
+/*
+ * Weiss-Smith type low Mach preconditioning. The preconditioner scales the
+ * pressure change of the time derivative by beta2: P = I + (beta2 - 1) a b'
+ * with a = dU/dp at constant velocity and entropy, b = dp/dU, and b'a = 1.
+ * The entropy and shear fields of PA are those of A, while the acoustic
+ * speeds become (1 + beta2) Vs / 2 -+ c' with
+ * c' = sqrt((1 - beta2)^2 Vs^2 / 4 + beta2 c^2), which are of the order
+ * of the flow speed once beta2 is of the order of the squared Mach number.
+ * Weiss, J. M., & Smith, W. A. (1995). Preconditioning applied to variable
+ * and constant density flows. AIAA Journal, 33(11), 2050-2057.
+ */
+Real PreconditionParameter(const Real cut, const Real Uo[restrict])
+{
+    const Real Ma2 = (Uo[1] * Uo[1] + Uo[2] * Uo[2] + Uo[3] * Uo[3]) / (Uo[5] * Uo[5]);
+    return MinReal(MaxReal(Ma2, cut), 1.0);
+}
+void PreconditionedEigenvalue(const int s, const Real beta2, const Real Uo[restrict],
+        Real Lambda[restrict])
+{
+    const Real u = Uo[s+1];
+    const Real c = Uo[5];
+    const Real up = 0.5 * (1.0 + beta2) * u;
+    const Real cp = sqrt(0.25 * (1.0 - beta2) * (1.0 - beta2) * u * u + beta2 * c * c);
+    Lambda[0] = up - cp;
+    Lambda[1] = u;
+    Lambda[2] = u;
+    Lambda[3] = u;
+    Lambda[4] = up + cp;
+    return;
+}
+/*
+ * The standard acoustic rows of L hold dp/dU / (2 c^2) -+ rho du/dU / (2 c),
+ * and the acoustic columns of R hold a c^2 -+ c e, with e the velocity
+ * derivative of U, so the preconditioned ones are recombined from their
+ * sums and differences. For an acoustic speed lambda, the right eigenvector
+ * of PA is a c^2 + mu e with mu = c^2 / (lambda - Vs). R is returned
+ * premultiplied by the inverse of P, therefore the projected flux
+ * P^-1 R Lambda L U recovers AU, while the upwind dissipation becomes
+ * P^-1 R |Lambda| L.
+ */
+void PreconditionEigenvector(const int s, const Real beta2, const Real Uo[restrict],
+        const Real Lambda[restrict], Real L[restrict][DIMU], Real R[restrict][DIMU])
+{
+    const Real u = Uo[s+1];
+    const Real c = Uo[5];
+    const Real muN = c * c / (Lambda[0] - u);
+    const Real muP = c * c / (Lambda[4] - u);
+    const Real D = muP - muN;
+    Real sum = 0.0; /* sum of the standard acoustic vectors */
+    Real dif = 0.0; /* difference of the standard acoustic vectors */
+    for (int n = 0; n < DIMU; ++n) {
+        sum = L[0][n] + L[4][n];
+        dif = c * (L[4][n] - L[0][n]);
+        L[0][n] = (muP * sum - dif) / D;
+        L[4][n] = (dif - muN * sum) / D;
+    }
+    for (int n = 0; n < DIMU; ++n) {
+        sum = 0.5 * (R[n][0] + R[n][4]) / beta2;
+        dif = 0.5 * (R[n][4] - R[n][0]) / c;
+        R[n][0] = sum + muN * dif;
+        R[n][4] = sum + muP * dif;
+    }
+    return;
+}
+void ConvectiveFlux(const int s, const Model *model, const Real U[restrict], Real F[restrict])
 {
     const Real rho = U[0];
     const Real u = U[1] / U[0];
     const Real v = U[2] / U[0];
     const Real w = U[3] / U[0];
     const Real eT = U[4] / U[0];
-    const Real p = ComputePressure(gamma, U);
+    const Real p = ComputePressure(model, U);
     ComputeConvectiveFlux[s](rho, u, v, w, eT, p, F);
     return;
 }
@@ -293,43 +399,43 @@ Real PrandtlNumber(void)
 {
     return 0.71; /* air */
 }
-void MapPrimitive(const Real gamma, const Real gasR, const Real U[restrict], Real Uo[restrict])
-{
-    Uo[0] = U[0];
-    Uo[1] = U[1] / U[0];
-    Uo[2] = U[2] / U[0];
-    Uo[3] = U[3] / U[0];
-    Uo[4] = (U[4] - 0.5 * (U[1] * U[1] + U[2] * U[2] + U[3] * U[3]) / U[0]) * (gamma - 1.0);
-    Uo[5] = Uo[4] / (Uo[0] * gasR);
-    return;
-}
-Real ComputePressure(const Real gamma, const Real U[restrict])
-{
-    return (U[4] - 0.5 * (U[1] * U[1] + U[2] * U[2] + U[3] * U[3]) / U[0]) * (gamma - 1.0);
-}
-Real ComputeTemperature(const Real cv, const Real U[restrict])
-{
-    return (U[4] - 0.5 * (U[1] * U[1] + U[2] * U[2] + U[3] * U[3]) / U[0]) / (U[0] * cv);
-}
-void MapConservative(const Real gamma, const Real Uo[restrict], Real U[restrict])
+/*
+ * External definitions of the functions defined inline in the header, for
+ * callers that do not inline them and for users of the solver library.
+ */
+extern int IndexNode(const int k, const int j, const int i, const int jMax, const int iMax);
+extern int InPartBox(const int k, const int j, const int i, const int pbox[restrict][LIMIT]);
+extern Real MinReal(const Real x, const Real y);
+extern Real MaxReal(const Real x, const Real y);
+extern int MinInt(const int x, const int y);
+extern int MaxInt(const int x, const int y);
+extern Real Dot(const Real V1[restrict], const Real V2[restrict]);
+extern void MapPrimitive(const Model *, const Real U[restrict], Real Uo[restrict]);
+extern Real ComputePressure(const Model *, const Real U[restrict]);
+extern Real ComputeTemperature(const Model *, const Real U[restrict]);
+extern Real ComputeSoundSpeed(const Model *, const Real U[restrict]);
+void MapConservative(const Model *model, const Real Uo[restrict], Real U[restrict])
 {
     U[0] = Uo[0];
     U[1] = Uo[0] * Uo[1];
     U[2] = Uo[0] * Uo[2];
     U[3] = Uo[0] * Uo[3];
-    U[4] = 0.5 * Uo[0] * (Uo[1] * Uo[1] + Uo[2] * Uo[2] + Uo[3] * Uo[3]) + Uo[4] / (gamma - 1.0);
+    U[4] = 0.5 * Uo[0] * (Uo[1] * Uo[1] + Uo[2] * Uo[2] + Uo[3] * Uo[3]) + ComputeInternalEnergy(model, Uo[0], Uo[4]);
     return;
 }
-int IndexNode(const int k, const int j, const int i, const int jMax, const int iMax)
+Real ComputeInternalEnergy(const Model *model, const Real rho, const Real p)
 {
-    return (k * jMax + j) * iMax + i;
+    if (EOSIDEAL == model->eos) {
+        return p / (model->gamma - 1.0);
+    }
+    return rho * InverseEos(model->mat, rho, p);
 }
-int InPartBox(const int k, const int j, const int i, const int pbox[restrict][LIMIT])
+Real ComputeDensity(const Model *model, const Real p, const Real T)
 {
-    return
-        (pbox[Z][MIN] <= k) && (pbox[Z][MAX] > k) &&
-        (pbox[Y][MIN] <= j) && (pbox[Y][MAX] > j) &&
-        (pbox[X][MIN] <= i) && (pbox[X][MAX] > i);
+    if (EOSIDEAL == model->eos) {
+        return p / (T * model->gasR);
+    }
+    return DensityEos(model->mat, p, T);
 }
 /*
  * Coordinates transformations
@@ -352,20 +458,6 @@ Real MapPoint(const int n, const Real sMin, const Real ds, const int ng)
 /*
  * Math functions
  */
-Real MinReal(const Real x, const Real y)
-{
-    if (x < y) {
-        return x;
-    }
-    return y;
-}
-Real MaxReal(const Real x, const Real y)
-{
-    if (x > y) {
-        return x;
-    }
-    return y;
-}
 int EqualReal(const Real x, const Real y)
 {
     const Real epsilon = DBL_EPSILON;
@@ -379,20 +471,6 @@ int EqualReal(const Real x, const Real y)
     const Real absMax = (absx > absy) ? absx : absy;
     return (diff <= epsilon * absMax);
 }
-int MinInt(const int x, const int y)
-{
-    if (x < y) {
-        return x;
-    }
-    return y;
-}
-int MaxInt(const int x, const int y)
-{
-    if (x > y) {
-        return x;
-    }
-    return y;
-}
 int Sign(const Real x)
 {
     const Real zero = 0.0;
@@ -404,10 +482,6 @@ int Sign(const Real x)
     }
     return 0;
 }
-Real Dot(const Real V1[restrict], const Real V2[restrict])
-{
-    return V1[X] * V2[X] + V1[Y] * V2[Y] + V1[Z] * V2[Z];
-}
 Real Norm(const Real V[restrict])
 {
     return sqrt(Dot(V, V));
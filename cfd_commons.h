@@ -16,7 +16,9 @@
 /****************************************************************************
  * Required Header Files
  ****************************************************************************/
+#include <math.h> /* common mathematical functions */
 #include "commons.h"
+#include "equation_of_state.h"
 /****************************************************************************
  * Data Structure Declarations
  ****************************************************************************/
@@ -27,9 +29,10 @@
  * Average method
  *
  * Function
- *      Compute averaged variables at interface.
+ *      Compute averaged variables at interface, return the heat capacity
+ *      ratio (or its equivalent for a tabulated equation of state).
  */
-extern void SymmetricAverage(const int averager, const Real gamma,
+extern Real SymmetricAverage(const int averager, const Model *,
         const Real UL[restrict], const Real UR[restrict], Real Uo[restrict]);
 /*
  * Jacobian matrices, eigenvalues, and eigenvectors
@@ -43,13 +46,28 @@ extern void EigenvalueSplitting(const int splitter, const Real Lambda[restrict],
 extern void EigenvectorL(const int s, const Real gamma, const Real Uo[restrict],
         Real L[restrict][DIMU]);
 extern void EigenvectorR(const int s, const Real Uo[restrict], Real R[restrict][DIMU]);
+/*
+ * Low Mach preconditioning
+ *
+ * Function
+ *      Compute the preconditioning parameter beta2 from the squared local
+ *      Mach number bounded below by cut, the eigenvalues of the
+ *      preconditioned Jacobian, and transform the eigenvectors computed
+ *      by EigenvectorL and EigenvectorR into those of the preconditioned
+ *      system, with R premultiplied by the inverse preconditioner.
+ */
+extern Real PreconditionParameter(const Real cut, const Real Uo[restrict]);
+extern void PreconditionedEigenvalue(const int s, const Real beta2, const Real Uo[restrict],
+        Real Lambda[restrict]);
+extern void PreconditionEigenvector(const int s, const Real beta2, const Real Uo[restrict],
+        const Real Lambda[restrict], Real L[restrict][DIMU], Real R[restrict][DIMU]);
 /*
  * Convective fluxes
  *
  * Function
  *      Compute convective fluxes.
  */
-extern void ConvectiveFlux(const int s, const Real gamma, const Real U[restrict], Real F[restrict]);
+extern void ConvectiveFlux(const int s, const Model *, const Real U[restrict], Real F[restrict]);
 /*
  * Physical property
  */
@@ -60,31 +78,19 @@ extern Real PrandtlNumber(void);
  *
  * Function
  *      Compute primitive variable vector according to conservative vector.
+ *      MapPrimitive, ComputePressure, ComputeTemperature and
+ *      ComputeSoundSpeed are defined inline below; cfd_commons.c provides
+ *      their external definitions.
  */
-extern void MapPrimitive(const Real gamma, const Real gasR, const Real U[restrict], Real Uo[restrict]);
-extern Real ComputePressure(const Real gamma, const Real U[restrict]);
-extern Real ComputeTemperature(const Real cv, const Real U[restrict]);
 /*
  * Compute and update conservative variable vector
  *
  * Function
  *      Compute conservative variable vector according to primitive vector.
  */
-extern void MapConservative(const Real gamma, const Real Uo[restrict], Real U[restrict]);
-/*
- * Index math
- *
- * Function
- *      Calculate the node index.
- */
-extern int IndexNode(const int k, const int j, const int i, const int jMax, const int iMax);
-/*
- * Verify node region
- *
- * Function
- *     Check whether a node is within the part box.
- */
-extern int InPartBox(const int k, const int j, const int i, const int pbox[restrict][LIMIT]);
+extern void MapConservative(const Model *, const Real Uo[restrict], Real U[restrict]);
+extern Real ComputeInternalEnergy(const Model *, const Real rho, const Real p);
+extern Real ComputeDensity(const Model *, const Real p, const Real T);
 /*
  * Coordinates transformation
  *
@@ -97,19 +103,139 @@ extern Real MapPoint(const int n, const Real sMin, const Real ds, const int ng);
 /*
  * Common math functions
  */
-extern Real MinReal(const Real x, const Real y);
-extern Real MaxReal(const Real x, const Real y);
 extern int EqualReal(const Real x, const Real y);
-extern int MinInt(const int x, const int y);
-extern int MaxInt(const int x, const int y);
 extern int Sign(const Real x);
-extern Real Dot(const Real V1[restrict], const Real V2[restrict]);
 extern Real Norm(const Real V[restrict]);
 extern Real Dist2(const Real V1[restrict], const Real V2[restrict]);
 extern Real Dist(const Real V1[restrict], const Real V2[restrict]);
 extern void Cross(const Real V1[restrict], const Real V2[restrict], Real V[restrict]);
 extern void OrthogonalSpace(const Real N[restrict], Real Ta[restrict], Real Tb[restrict]);
 extern void Normalize(const int dimV, const Real normalizer, Real V[restrict]);
+/****************************************************************************
+ * Inline Function Definitions
+ ****************************************************************************/
+/*
+ * The following functions are evaluated at every stencil point of every
+ * sweep from other translation units, hence they are defined here to be
+ * inlined by the compiler. Except the static IndexStride, these are inline
+ * definitions without static, so that each translation unit may inline
+ * them while cfd_commons.c provides the external definitions.
+ */
+/*
+ * Index math
+ *
+ * Function
+ *      Calculate the node index. Neighbours of a node are addressed by
+ *      adding multiples of the strides of unit steps in x, y, z.
+ */
+inline int IndexNode(const int k, const int j, const int i, const int jMax, const int iMax)
+{
+    return (k * jMax + j) * iMax + i;
+}
+static inline void IndexStride(const int partn[restrict], int st[restrict])
+{
+    st[X] = 1;
+    st[Y] = partn[X];
+    st[Z] = partn[X] * partn[Y];
+    return;
+}
+/*
+ * Verify node region
+ *
+ * Function
+ *     Check whether a node is within the part box.
+ */
+inline int InPartBox(const int k, const int j, const int i, const int pbox[restrict][LIMIT])
+{
+    return
+        (pbox[Z][MIN] <= k) && (pbox[Z][MAX] > k) &&
+        (pbox[Y][MIN] <= j) && (pbox[Y][MAX] > j) &&
+        (pbox[X][MIN] <= i) && (pbox[X][MAX] > i);
+}
+/*
+ * Primitive variables
+ * The calorically perfect gas is evaluated in place, the tabulated
+ * equation of state is looked up by density and specific internal energy.
+ */
+inline void MapPrimitive(const Model *model, const Real U[restrict], Real Uo[restrict])
+{
+    Uo[0] = U[0];
+    Uo[1] = U[1] / U[0];
+    Uo[2] = U[2] / U[0];
+    Uo[3] = U[3] / U[0];
+    if (EOSIDEAL == model->eos) {
+        Uo[4] = (U[4] - 0.5 * (U[1] * U[1] + U[2] * U[2] + U[3] * U[3]) / U[0]) * (model->gamma - 1.0);
+        Uo[5] = Uo[4] / (Uo[0] * model->gasR);
+        return;
+    }
+    Real pTc[EOSN] = {0.0};
+    LookupEos(model->mat, U[0], (U[4] - 0.5 * (U[1] * U[1] + U[2] * U[2] + U[3] * U[3]) / U[0]) / U[0], pTc);
+    Uo[4] = pTc[EOSP];
+    Uo[5] = pTc[EOST];
+    return;
+}
+inline Real ComputePressure(const Model *model, const Real U[restrict])
+{
+    if (EOSIDEAL == model->eos) {
+        return (U[4] - 0.5 * (U[1] * U[1] + U[2] * U[2] + U[3] * U[3]) / U[0]) * (model->gamma - 1.0);
+    }
+    Real pTc[EOSN] = {0.0};
+    LookupEos(model->mat, U[0], (U[4] - 0.5 * (U[1] * U[1] + U[2] * U[2] + U[3] * U[3]) / U[0]) / U[0], pTc);
+    return pTc[EOSP];
+}
+inline Real ComputeTemperature(const Model *model, const Real U[restrict])
+{
+    if (EOSIDEAL == model->eos) {
+        return (U[4] - 0.5 * (U[1] * U[1] + U[2] * U[2] + U[3] * U[3]) / U[0]) / (U[0] * model->cv);
+    }
+    Real pTc[EOSN] = {0.0};
+    LookupEos(model->mat, U[0], (U[4] - 0.5 * (U[1] * U[1] + U[2] * U[2] + U[3] * U[3]) / U[0]) / U[0], pTc);
+    return pTc[EOST];
+}
+inline Real ComputeSoundSpeed(const Model *model, const Real U[restrict])
+{
+    if (EOSIDEAL == model->eos) {
+        return sqrt(model->gamma * model->gasR * (ComputePressure(model, U) / (U[0] * model->gasR)));
+    }
+    Real pTc[EOSN] = {0.0};
+    LookupEos(model->mat, U[0], (U[4] - 0.5 * (U[1] * U[1] + U[2] * U[2] + U[3] * U[3]) / U[0]) / U[0], pTc);
+    return pTc[EOSC];
+}
+/*
+ * Common math functions
+ */
+inline Real MinReal(const Real x, const Real y)
+{
+    if (x < y) {
+        return x;
+    }
+    return y;
+}
+inline Real MaxReal(const Real x, const Real y)
+{
+    if (x > y) {
+        return x;
+    }
+    return y;
+}
+inline int MinInt(const int x, const int y)
+{
+    if (x < y) {
+        return x;
+    }
+    return y;
+}
+inline int MaxInt(const int x, const int y)
+{
+    if (x > y) {
+        return x;
+    }
+    return y;
+}
+inline Real Dot(const Real V1[restrict], const Real V2[restrict])
+{
+    return V1[X] * V2[X] + V1[Y] * V2[Y] + V1[Z] * V2[Z];
+}
 #endif
 /* a good practice: end file with a newline */
 
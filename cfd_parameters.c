@@ -65,6 +65,9 @@ static void SetNodeNumber(Space *space, Model *model)
         case WENOFIVE:
             model->sL = -2; model->sR = 3; part->gl = 3;
             break;
+        case MUSCLHLLC:
+            model->sL = -1; model->sR = 2; part->gl = 2;
+            break;
         default:
             break;
     }
@@ -139,12 +142,42 @@ static void InitializeParameters(Time *time, Space *space, Model *model)
     }
     part->tinyL = 1.0e-6 * MinReal(part->d[X], MinReal(part->d[Y], part->d[Z]));
     part->tinyL = part->tinyL * part->tinyL; /* distance square based comparison */
+    for (int s = 0; s < DIMS; ++s) {
+        part->tile[s] = MaxInt(part->tile[s], 1);
+        part->depth[s] = MaxInt(part->depth[s], 1);
+    }
+    part->thread = MaxInt(part->thread, 1);
     /* time */
     time->end = time->end * model->refV / model->refL;
     if (0 >= time->stepN) {
         time->stepN = INT_MAX;
     }
     time->dataC = time->restart;
+    /* forward Euler step multiple of the temporal scheme stability bound */
+    switch (model->tScheme) {
+        case RKFIVEFOUR:
+            model->ssp = 1.508;
+            break;
+        case RKTENFOUR:
+            model->ssp = 6.0;
+            break;
+        default:
+            model->ssp = 1.0;
+            break;
+    }
+    if (time->numCFL > time->cflMax) {
+        time->cflMax = time->numCFL; /* adaptive CFL off */
+    }
+    /* a merged split sweep advances a full step in one direction */
+    if ((MERGEN != model->merge) && ((OPTSPLIT != model->multidim) || (1.0 < time->cflMax))) {
+        ShowWarning("split sweep merging requires dimension splitting with CFL <= 1, disabled");
+        model->merge = MERGEN;
+    }
+    /* dual time steps start from a synchronized time level */
+    if ((MERGEALL == model->merge) && (0.0 < model->pcMa)) {
+        ShowWarning("split sweep merging across steps disabled by low Mach preconditioning");
+        model->merge = MERGESTEP;
+    }
     for (int n = 0; n < NPROBE; ++n) {
         if (0 >= time->dataN[n]) {
             time->dataN[n] = 0;
@@ -153,6 +186,14 @@ static void InitializeParameters(Time *time, Space *space, Model *model)
             time->dataW[n] = INT_MAX;
         }
     }
+    if ((0 >= time->imgN) || (0 >= time->imgW)) {
+        time->imgN = 0;
+        time->imgW = INT_MAX;
+    }
+    if (0 >= time->cvgW) {
+        time->cvgW = INT_MAX;
+    }
+    time->cvgN = MaxInt(time->cvgN, 1);
     /* geometry */
     if (0 >= geo->sphN) {
         geo->sphN = 0;
@@ -11,15 +11,50 @@
 /****************************************************************************
  * Required Header Files
  ****************************************************************************/
+#define _POSIX_C_SOURCE 200809L /* expose fmemopen and POSIX threads under -std=c99 */
 #include "commons.h"
 #include <stdio.h> /* standard library for input and output */
 #include <stdlib.h> /* dynamic memory allocation and exit */
 #include <string.h> /* manipulating strings */
 #include <stdarg.h> /* variable-length argument lists */
+#include <pthread.h> /* POSIX threads */
+#include "data_stage.h"
+/****************************************************************************
+ * Data Structure Declarations
+ ****************************************************************************/
+struct Pool {
+    int threadN; /* number of threads including the caller */
+    pthread_t *tid; /* worker threads */
+    int *alive; /* worker start flag */
+    pthread_mutex_t lock; /* guard of the shared state */
+    pthread_cond_t start; /* signals a new batch or the shutdown */
+    pthread_cond_t done; /* signals the completion of a batch */
+    ItemWorker work; /* worker of the batch */
+    void *arg; /* worker argument of the batch */
+    FileTable *files; /* file table of the caller */
+    int itemN; /* number of items of the batch */
+    int next; /* next untaken item */
+    int fail; /* failure flag of the batch */
+    int batch; /* batch count */
+    int busy; /* threads still working on the batch */
+    int quit; /* shutdown flag */
+};
+/****************************************************************************
+ * Static Function Declarations
+ ****************************************************************************/
+static void *RunPool(void *);
+static void DrainItems(Pool *);
 /****************************************************************************
  * Global Real Constants Definition
  ****************************************************************************/
 const Real PI = 3.14159265358979323846;
+/****************************************************************************
+ * Global Variables Definition with Private Scope
+ ****************************************************************************/
+static FileTable table = {0}; /* default file table of the process */
+static __thread FileTable *bound = NULL; /* file table bound to the thread */
+static __thread int drain = 0; /* the thread is draining pool items */
+static __thread jmp_buf *trap = NULL; /* error trap of the thread */
 /****************************************************************************
  * General functions
  ****************************************************************************/
@@ -101,14 +136,28 @@ char *ParseFormat(char *fmt)
     *receiver = '\0';
     return fmt;
 }
+int BigEndian(void)
+{
+    const int probe = 1; /* least significant byte is one */
+    return (0 == *(const unsigned char *)&probe);
+}
 void ShowError(const char *fmt, ...)
 {
     va_list args;
     va_start(args, fmt);
     verror("error", fmt, args);
     va_end(args);
+    if (NULL != trap) {
+        longjmp(*trap, 1);
+    }
     exit(EXIT_FAILURE);
 }
+jmp_buf *SetErrorTrap(jmp_buf *set)
+{
+    jmp_buf *last = trap;
+    trap = set;
+    return last;
+}
 void ShowWarning(const char *fmt, ...)
 {
     va_list args;
@@ -182,12 +231,196 @@ void WriteToLine(FILE *fp, const char *line)
 }
 FILE *Fopen(const char *fname, const char *mode)
 {
-    FILE *fp = fopen(fname, mode);
+    const FileTable *const mf = BoundFileTable();
+    if (('r' == mode[0]) && (NULL == strchr(mode, '+'))) {
+        for (int n = 0; n < mf->fileN; ++n) {
+            if (0 != strcmp(fname, mf->fname[n])) {
+                continue;
+            }
+            FILE *fp = fmemopen((void *)mf->data[n], mf->size[n], mode);
+            if (NULL == fp) {
+                ShowError("failed to open in-memory file: %s, mode: %s", fname, mode);
+            }
+            return fp;
+        }
+    }
+    String path = {'\0'}; /* staged path of the file */
+    StagePath(fname, mode, path);
+    FILE *fp = fopen(path, mode);
     if (NULL == fp) {
         ShowError("failed to open file: %s, mode: %s", fname, mode);
     }
     return fp;
 }
+void BindFileTable(FileTable *files)
+{
+    bound = files;
+    return;
+}
+FileTable *BoundFileTable(void)
+{
+    return (NULL == bound) ? &table : bound;
+}
+Pool *InitializeWorkPool(const int threadN)
+{
+    if (1 >= threadN) {
+        return NULL;
+    }
+    Pool *pool = AssignStorage(sizeof(*pool));
+    pool->threadN = threadN;
+    pool->tid = AssignStorage(threadN * sizeof(*pool->tid));
+    pool->alive = AssignStorage(threadN * sizeof(*pool->alive));
+    pthread_mutex_init(&(pool->lock), NULL);
+    pthread_cond_init(&(pool->start), NULL);
+    pthread_cond_init(&(pool->done), NULL);
+    for (int m = 1; m < threadN; ++m) {
+        pool->alive[m] = (0 == pthread_create(pool->tid + m, NULL, RunPool, pool));
+    }
+    return pool;
+}
+void FinalizeWorkPool(Pool *pool)
+{
+    if (NULL == pool) {
+        return;
+    }
+    pthread_mutex_lock(&(pool->lock));
+    pool->quit = 1;
+    pthread_cond_broadcast(&(pool->start));
+    pthread_mutex_unlock(&(pool->lock));
+    for (int m = 1; m < pool->threadN; ++m) {
+        if (pool->alive[m]) {
+            pthread_join(pool->tid[m], NULL);
+        }
+    }
+    pthread_cond_destroy(&(pool->done));
+    pthread_cond_destroy(&(pool->start));
+    pthread_mutex_destroy(&(pool->lock));
+    RetrieveStorage(pool->alive);
+    RetrieveStorage(pool->tid);
+    RetrieveStorage(pool);
+    return;
+}
+/*
+ * A batch is published under the lock by advancing the batch count, then
+ * the started threads and the calling thread take items until none is
+ * left. Each of them traps its own errors, an error stops the handout of
+ * items, and is raised again on the calling thread once all are done.
+ */
+void RunWorkItems(Pool *pool, const int itemN, ItemWorker work, void *arg)
+{
+    if ((NULL == pool) || (1 >= itemN) || drain) {
+        for (int n = 0; n < itemN; ++n) {
+            work(n, arg);
+        }
+        return;
+    }
+    pthread_mutex_lock(&(pool->lock));
+    pool->work = work;
+    pool->arg = arg;
+    pool->files = BoundFileTable();
+    pool->itemN = itemN;
+    pool->next = 0;
+    pool->fail = 0;
+    pool->busy = 0;
+    for (int m = 1; m < pool->threadN; ++m) {
+        pool->busy = pool->busy + pool->alive[m];
+    }
+    ++(pool->batch);
+    pthread_cond_broadcast(&(pool->start));
+    pthread_mutex_unlock(&(pool->lock));
+    DrainItems(pool);
+    pthread_mutex_lock(&(pool->lock));
+    while (0 < pool->busy) {
+        pthread_cond_wait(&(pool->done), &(pool->lock));
+    }
+    pthread_mutex_unlock(&(pool->lock));
+    if (0 != pool->fail) {
+        ShowError("failed to run work items");
+    }
+    return;
+}
+static void *RunPool(void *arg)
+{
+    Pool *const pool = arg;
+    int batch = 0; /* last batch taken */
+    pthread_mutex_lock(&(pool->lock));
+    while (1) {
+        while ((batch == pool->batch) && (0 == pool->quit)) {
+            pthread_cond_wait(&(pool->start), &(pool->lock));
+        }
+        if (0 != pool->quit) {
+            pthread_mutex_unlock(&(pool->lock));
+            return NULL;
+        }
+        batch = pool->batch;
+        pthread_mutex_unlock(&(pool->lock));
+        BindFileTable(pool->files);
+        DrainItems(pool);
+        pthread_mutex_lock(&(pool->lock));
+        --(pool->busy);
+        if (0 == pool->busy) {
+            pthread_cond_signal(&(pool->done));
+        }
+    }
+}
+static void DrainItems(Pool *pool)
+{
+    jmp_buf env; /* return point of errors in items */
+    jmp_buf *last = SetErrorTrap(&env);
+    drain = 1;
+    if (0 == setjmp(env)) {
+        while (1) {
+            pthread_mutex_lock(&(pool->lock));
+            const int n = pool->next; /* item taken */
+            pool->next = (n < pool->itemN) ? n + 1 : pool->itemN;
+            pthread_mutex_unlock(&(pool->lock));
+            if (pool->itemN <= n) {
+                break;
+            }
+            pool->work(n, pool->arg);
+        }
+    } else {
+        pthread_mutex_lock(&(pool->lock));
+        pool->fail = 1;
+        pool->next = pool->itemN;
+        pthread_mutex_unlock(&(pool->lock));
+    }
+    drain = 0;
+    SetErrorTrap(last);
+    return;
+}
+void MountMemoryFile(const char *fname, const void *data, const size_t size)
+{
+    FileTable *const mf = BoundFileTable();
+    int n = 0;
+    while ((n < mf->fileN) && (0 != strcmp(fname, mf->fname[n]))) {
+        ++n;
+    }
+    if (MEMFILEN <= n) {
+        ShowError("too many in-memory files, maximum: %d", MEMFILEN);
+    }
+    if ((NULL == data) || (0 == size)) {
+        ShowError("empty in-memory file: %s", fname);
+    }
+    if ((int)sizeof(String) <= snprintf(mf->fname[n], sizeof(String), "%s", fname)) {
+        ShowError("in-memory file name too long: %s", fname);
+    }
+    mf->data[n] = data;
+    mf->size[n] = size;
+    if (mf->fileN == n) {
+        ++(mf->fileN);
+    }
+    return;
+}
+void UnmountMemoryFiles(void)
+{
+    FileTable *const mf = BoundFileTable();
+    mf->fileN = 0;
+    memset(mf->fname, 0, sizeof(mf->fname));
+    memset(mf->data, 0, sizeof(mf->data));
+    memset(mf->size, 0, sizeof(mf->size));
+    return;
+}
 void Fread(void *ptr, size_t size, size_t n, FILE *stream)
 {
     if (n != fread(ptr, size, n, stream))
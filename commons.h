@@ -18,6 +18,7 @@
  ****************************************************************************/
 #include <stdio.h> /* standard library for input and output */
 #include <stdarg.h> /* variable-length argument lists */
+#include <setjmp.h> /* nonlocal jumps */
 /****************************************************************************
  * Data Structure Declarations
  ****************************************************************************/
@@ -55,8 +56,34 @@ typedef enum {
     NONE = -1, /* invalid flag */
     WENOTHREE = 0, /* 3rd order weno */
     WENOFIVE = 1, /* 5th order weno */
+    MUSCLHLLC = 2, /* 2nd order muscl with hllc flux */
+    RKTWO = 0, /* 2nd order strong stability preserving runge-kutta */
+    RKTHREE = 1, /* 3rd order strong stability preserving runge-kutta */
+    RKFIVEFOUR = 2, /* five stage 4th order ssp runge-kutta */
+    RKTENFOUR = 3, /* ten stage 4th order ssp runge-kutta */
+    PRECONLLF = 2, /* local lax-friedrichs splitting of preconditioned eigensystem */
     OPTSPLIT = 0, /* operator splitting approximation */
     OPTBYOPT = 1, /* operator-by-operator approximation */
+    MERGEN = 0, /* no merging of split sweeps */
+    MERGESTEP = 1, /* merge adjacent split sweeps within a step */
+    MERGEALL = 2, /* merge adjacent split sweeps within and across steps */
+    TILEN = 32, /* maximum number of pencils in a tile of space sweeps */
+    CONTACTNODE = 0, /* contact detection by probing interfacial nodes */
+    CONTACTMESH = 1, /* contact detection by geometric narrow phase */
+    WALLN = 0, /* resolved noslip wall */
+    WALLLOG = 1, /* equilibrium log law wall model */
+    WALLSPALDING = 2, /* spalding wall function model */
+    LEAFN = 4, /* maximum faces in a leaf of bounding volume hierarchy */
+    COSTDOMAIN = 0, /* node classification phase of geometries */
+    COSTGHOST = 1, /* ghost node treatment phase of geometries */
+    COSTFORCE = 2, /* surface force integration phase of geometries */
+    COSTP = 3, /* number of geometry phases in cost accounting */
+    COSTTIME = 0, /* wall time of a phase */
+    COSTNODE = 1, /* ghost nodes treated in a phase */
+    COSTFACET = 2, /* facet tests in a phase */
+    COSTBOX = 3, /* nodes in bounding box visited in a phase */
+    COSTM = 4, /* number of cost measures */
+    MEMFILEN = 64, /* maximum number of mounted in-memory files */
     /* parameters related to domain partitions */
     NPART = 15, /* inner region, [west, east, south, north, front, back] x [Boundary, Ghost], physical region, all region */
     PIO = 0, /* the partition region for data iostream */
@@ -86,6 +113,8 @@ typedef enum {
     NOSLIPWALL = 3,
     PERIODIC = 4,
     VARBC = 6, /* specified primitive variables: rho, u, v, w, p, T */
+    NROUTFLOW = 7, /* characteristic non-reflecting outflow */
+    FARFIELD = 8, /* characteristic non-reflecting far field */
     /* parameters related to global and regional initialization */
     NIC = 10, /* maximum number of initializer to support */
     ICGLOBAL = 0, /* global initializer */
@@ -107,6 +136,25 @@ typedef enum {
     PROFC = 3,
     PROSD = 4,
     POSLN = 7, /* x1, y1, z1, x2, y2, z2, resolution */
+    CURVEGHOST = 1, /* ghost node data of each body at probe frequency */
+    CURVESURF = 2, /* surface field of all bodies with space data */
+    SURFV = 6, /* surface variables: p, T, tau x, tau y, tau z, did */
+    SURFRING = 64, /* maximum parametrization rings on a sphere surface */
+    /* parameters related to slice images */
+    POSIMG = 5, /* normal axis, position, variable, range min, range max */
+    IMGPNG = 0, /* 8-bit RGB portable network graphics */
+    IMGPFM = 1, /* single precision portable float map */
+    IMGRHO = 0,
+    IMGP = 1,
+    IMGSCH = 2, /* numerical schlieren */
+    IMGDID = 3,
+    /* parameters related to material */
+    EOSIDEAL = 0, /* calorically perfect gas */
+    EOSTABLE = 1, /* tabulated equation of state */
+    EOSN = 3, /* tabulated states: pressure, temperature, speed of sound */
+    EOSP = 0,
+    EOST = 1,
+    EOSC = 2,
     /* general parameters */
     STR = 200, /* string length */
     VARSTR =100, /* variable expression length */
@@ -133,6 +181,7 @@ typedef struct {
     Real U[DIMT][DIMU]; /* field data at each time level */
 } Node; /* field data */
 
+typedef struct Pool Pool; /* persistent worker threads, defined by commons.c */
 typedef struct {
     IntVec m; /* mesh number of spatial dimensions */
     IntVec n; /* node number of spatial dimensions */
@@ -149,6 +198,7 @@ typedef struct {
     int *restrict typeBC; /* boundary type recorder */
     int (*restrict N)[DIMS]; /* outward surface normal of domain boundary */
     Real (*restrict varBC)[VARBC]; /* field values of each boundary */
+    Real sponge[2]; /* sponge layer width and damping strength at non-reflecting boundaries */
     int nIC; /* flow initializer pointer and counter */
     int *restrict typeIC; /* flow initializer type recorder */
     Real (*restrict posIC)[POSIC]; /* position values of each initializer */
@@ -156,6 +206,16 @@ typedef struct {
     Real domain[DIMS][LIMIT]; /* coordinates define the space domain */
     IntVec proc; /* number of processors of spatial dimensions */
     int procN; /* total number of processors */
+    int tune; /* kernel autotuning flag */
+    IntVec tile; /* pencil tile width of space sweeps */
+    IntVec depth; /* pencil tile depth of space sweeps */
+    IntVec order; /* tile loop order of space sweeps: 0 depth outer, 1 width outer */
+    int thread; /* worker threads */
+    int active; /* worker threads in use by the work units, at most thread */
+    int unitN; /* number of work units */
+    int (*restrict unit)[DIMS][LIMIT]; /* node box of each work unit */
+    Real ghostCost; /* cost of a ghost node relative to a fluid node */
+    Pool *pool; /* worker threads of the work units, NULL when single threaded */
 } Partition; /* domain discretization and partition */
 
 typedef struct {
@@ -167,7 +227,7 @@ typedef struct {
 
 typedef struct {
     int gid; /* geometry identifier */
-    IntVec N; /* line of impact */
+    RealVec N; /* line of impact */
 } Collision; /* collision list */
 
 typedef struct {
@@ -175,6 +235,7 @@ typedef struct {
     int edgeN; /* number of edges */
     int vertN; /* number of vertices */
     int state; /* dynamic motion indicator */
+    int pid; /* geometry identifier in input order */
     int mid; /* material type */
     Real r; /* bounding sphere radius */
     RealVec O; /* centroid */
@@ -200,6 +261,17 @@ typedef struct {
     Real (*restrict Ne)[DIMS]; /* edge normal */
     Real (*restrict v)[DIMS]; /* vertex list */
     Real (*restrict Nv)[DIMS]; /* vertex normal */
+    int bvN; /* number of nodes in bounding volume hierarchy */
+    int *restrict fo; /* face order of bounding volume hierarchy */
+    Real (*restrict bv)[DIMS][LIMIT]; /* node boxes of bounding volume hierarchy */
+    int sdfN[DIMS]; /* samples of signed distance field on each dimension */
+    Real sdfH; /* sample spacing of signed distance field */
+    Real sdfBand; /* depth below surface within which closest faces are exact */
+    RealVec sdfO; /* first sample point in body frame */
+    Real sdfR[DIMS][DIMS]; /* rotation from body frame to world frame */
+    RealVec sdfT; /* translation from body frame to world frame */
+    Real *restrict sdf; /* signed distance at samples, negative inside */
+    int *restrict sdfF; /* closest face at samples */
     Facet *facet; /* facet data */
 } Polyhedron; /* polyhedron */
 
@@ -208,13 +280,30 @@ typedef struct {
     int sphN; /* number of analytical polyhedrons */
     int stlN; /* number of triangulated polyhedrons */
     int colN; /* colliding list pointer and count */
+    int reorder; /* step interval of spatial reordering of geometries */
+    int sdf; /* samples of signed distance field on the longest body side */
+    int costN; /* most expensive geometries in cost report at each snapshot */
+    Real (*restrict cost)[COSTP][COSTM]; /* accumulated cost of each geometry in input order */
+    int *restrict pos; /* storage position of each geometry in input order */
     Polyhedron *poly; /* geometry list */
     Collision *col; /* collision list */
 } Geometry; /* geometry data */
 
 typedef struct {
-    Real eos; /* equation of state */
+    int tn[2]; /* number of table entries of density and internal energy */
+    Real t0[2]; /* table origin of density and internal energy */
+    Real dd[2]; /* reciprocal of table spacing of density and internal energy */
+    Real (*restrict tab)[EOSN]; /* tabulated states with internal energy running fastest */
 } Material; /* material property database */
+
+typedef struct {
+    int pointN; /* number of points */
+    int vertN; /* number of vertex cells, on the leading points */
+    int faceN; /* number of triangle cells, following vertex cells */
+    Real (*restrict v)[DIMS]; /* point list */
+    int (*restrict f)[POLYN]; /* triangle-point list */
+    Real (*restrict data)[SURFV]; /* cell data */
+} Surface; /* surface field of immersed bodies */
 /*
  * Manager structures
  * Memory of normal type members will be automatically allocated from stack.
@@ -237,23 +326,48 @@ typedef struct {
     Real end; /* termination time */
     Real now; /* current time recorder */
     Real numCFL; /* CFL number */
+    Real cflMax; /* ceiling of adaptive CFL number */
+    Real cflRate; /* growth factor of adaptive CFL number per step */
     Real (*restrict pp)[DIMS]; /* point probes */
     Real (*restrict lp)[POSLN]; /* line probes */
+    int imgN; /* number of slice images */
+    int imgW; /* slice image writing frequency in steps */
+    int imgF; /* slice image format */
+    Real (*restrict img)[POSIMG]; /* slice images */
+    int cvgW; /* convergence monitoring interval in steps */
+    int cvgN; /* consecutive converged samples to terminate */
+    int cvgB; /* number of bodies with monitored forces */
+    int *restrict cvgId; /* bodies with monitored forces */
+    Real cvgTol[2]; /* residual and force tolerances */
+    String stage; /* local staging directory of output */
+    String drain; /* destination directory of staged output */
+    int mute; /* suppress file output for embedded runs */
 } Time;
 
 typedef struct {
     int tScheme; /* temporal discretization scheme */
+    Real ssp; /* strong stability preserving coefficient of temporal scheme */
     int sScheme; /* spatial discretization scheme */
     int sL; /* left offset of stencil index */
     int sR; /* right offset of stencil index */
     int multidim; /* multidimensional space method */
+    int merge; /* merging of adjacent split sweeps */
     int jacobMean; /* average method for local Jacobian linearization */
     int fluxSplit; /* flux vector splitting method */
     int psi; /* phase interaction type */
+    int contact; /* contact detection method */
     int ibmLayer; /* number of interfacial layers using flow reconstruction */
+    int wall; /* wall model of noslip immersed boundaries */
     int mid; /* material identifier */
+    int eos; /* equation of state type */
     int gState; /* gravity state */
     int sState; /* source state */
+    Real pcMa; /* Mach number threshold of low Mach preconditioning */
+    int pcHold; /* consecutive steps below the threshold before dual time stepping */
+    Real pcStep; /* upper bound of dual time step in acoustic time steps */
+    int pcIter; /* maximum pseudo time iterations per dual time step */
+    Real pcTol; /* residual reduction of pseudo time iterations */
+    Real pcCut; /* lower bound of preconditioning parameter, dual time steps only */
     Real refMa; /* reference Mach number */
     Real refMu; /* reference dynamic viscosity */
     Real gamma; /* heat capacity ratio */
@@ -271,6 +385,16 @@ typedef struct {
     char runMode; /* running mode */
     IntVec proc; /* number of processors per dimension */
 } Control;
+
+typedef struct Stage Stage; /* output staging state, defined by data_stage.c */
+typedef struct {
+    int fileN; /* number of mounted in-memory files */
+    String fname[MEMFILEN]; /* mounted file names */
+    const void *data[MEMFILEN]; /* mounted buffers */
+    size_t size[MEMFILEN]; /* buffer sizes */
+    Stage *stage; /* output staging, NULL when staging is off */
+} FileTable; /* file access state of a solver instance */
+typedef void (*ItemWorker)(const int, void *);
 /****************************************************************************
  * Public Functions Declaration
  ****************************************************************************/
@@ -291,6 +415,14 @@ extern int ParseCommand(char *cmdstr);
  *      Adjust the format string according to the type of Real.
  */
 extern char *ParseFormat(char *fmt);
+/*
+ * Host byte order
+ *
+ * Function
+ *      Return 1 if the host stores multibyte values big endian, otherwise 0.
+ *      Binary output declares the host byte order with it.
+ */
+extern int BigEndian(void);
 /*
  * Fatal error control
  *
@@ -298,8 +430,13 @@ extern char *ParseFormat(char *fmt);
  *      Show error and then exit. Once the process exits,
  *      the operating system can free all dynamically allocated
  *      memory associated with the process.
+ *      If an error trap is set on the calling thread, jump to the trap
+ *      instead of exiting, which lets library calls return an error.
+ *      SetErrorTrap sets the trap of the calling thread, NULL clears it,
+ *      and returns the previous one.
  */
 extern void ShowError(const char *fmt, ...);
+extern jmp_buf *SetErrorTrap(jmp_buf *trap);
 /*
  * Warning control
  *
@@ -358,6 +495,53 @@ extern void WriteToLine(FILE *fp, const char *line);
  * Standard Stream Functions with Checked Return Values
  */
 extern FILE *Fopen(const char *fname, const char *mode);
+/*
+ * File table binding
+ *
+ * Function
+ *      Bind the file table of a solver instance to the calling thread,
+ *      NULL binds the default table of the process. File opening, in-memory
+ *      files, and output staging work on the bound table, so that instances
+ *      on different threads, or interleaved on one thread, stay apart.
+ *      BoundFileTable returns the table bound to the calling thread.
+ */
+extern void BindFileTable(FileTable *);
+extern FileTable *BoundFileTable(void);
+/*
+ * Worker thread pool
+ *
+ * Function
+ *      Start threadN - 1 worker threads once, which wait for work between
+ *      parallel sections, and stop them at finalization. No pool is
+ *      started for a single thread, and NULL is returned.
+ */
+extern Pool *InitializeWorkPool(const int threadN);
+extern void FinalizeWorkPool(Pool *);
+/*
+ * Run work items
+ *
+ * Function
+ *      Apply the worker to items 0 to itemN - 1 on the pool, each thread
+ *      taking the next untaken item when it becomes idle. The calling
+ *      thread is one of the pool and drains the items left by threads that
+ *      failed to start. Items run serially without a pool or when called
+ *      from an item. Workers share the file table of the caller. An error
+ *      in an item stops the remaining items and is raised on the caller
+ *      after all threads are done.
+ */
+extern void RunWorkItems(Pool *, const int itemN, ItemWorker, void *);
+/*
+ * In-memory files
+ *
+ * Function
+ *      Mount a memory buffer under a file name, then opening the file for
+ *      reading with Fopen reads the buffer instead of the file system.
+ *      Buffers are referenced rather than copied and should persist until
+ *      unmounted. Unmounting releases all mounted names. Both work on the
+ *      bound file table.
+ */
+extern void MountMemoryFile(const char *fname, const void *data, const size_t size);
+extern void UnmountMemoryFiles(void);
 extern void Fread(void *ptr, size_t size, size_t n, FILE *stream);
 extern void Fscanf(FILE *stream, const int n, const char *fmt, ...);
 extern void Sscanf(const char *str, const int n, const char *fmt, ...);
@@ -19,6 +19,36 @@
 #include <float.h> /* size of floating point values */
 #include "cfd_commons.h"
 #include "commons.h"
+/****************************************************************************
+ * Data Structure Declarations
+ ****************************************************************************/
+typedef enum {
+    QUADN = 10, /* entries of a symmetric quadric */
+} GeometryConst;
+typedef struct {
+    Real cost; /* quadric error of the collapsed vertex */
+    int v0; /* edge vertex */
+    int v1; /* edge vertex */
+} Collapse; /* edge collapse candidate */
+typedef struct {
+    int faceN; /* number of live faces */
+    int (*f)[POLYN]; /* face-vertex list */
+    Real (*v)[DIMS]; /* vertex list */
+    Real (*Q)[QUADN]; /* fundamental error quadric of each vertex */
+    int *live; /* face live flag */
+    int *head; /* first face corner of each vertex */
+    int *next; /* next face corner of the same vertex */
+    int *ohead; /* first original vertex merged into each vertex */
+    int *otail; /* last original vertex merged into each vertex */
+    int *onext; /* next original vertex of the same vertex */
+    int *stamp; /* visit stamp of each vertex */
+    int tick; /* current visit stamp */
+    Real (*org)[DIMS]; /* original vertex list */
+} Decimator; /* working mesh of polyhedron decimation */
+typedef struct {
+    int collapse; /* space collapse flag */
+    Geometry *geo; /* geometry data */
+} ParameterTask; /* polyhedrons to compute parameters */
 /****************************************************************************
  * Static Function Declarations
  ****************************************************************************/
@@ -26,11 +56,33 @@ static int AddVertex(const Real [restrict], Polyhedron *);
 static int FindEdge(const int, const int, const int, int [restrict][EVF]);
 static void ComputeParametersSphere(const int, Polyhedron *);
 static void ComputeParametersPolyhedron(const int, Polyhedron *);
+static void ComputeParametersItem(const int, void *);
 static void TransformVertex(const Real [restrict], const Real [restrict],
         const Real [restrict][DIMS], const Real [restrict], Real [restrict][LIMIT],
         const int, Real [restrict][DIMS]);
 static void TransformNormal(const Real [restrict][DIMS], const int, Real [restrict][DIMS]);
 static Real TransformInertia(const Real [restrict], Real [restrict][DIMS]);
+static void BuildHierarchy(const int, const int, const int, Polyhedron *);
+static void RefitHierarchy(const int, const int, const int, Polyhedron *);
+static void SelectFace(const int, const int, const int, const int, Polyhedron *);
+static Real FaceKey(const int, const int, const Polyhedron *);
+static Real BoxDistance(const Real [restrict], Real [restrict][LIMIT]);
+static void SearchFace(const Real [restrict], const int, const int, const int,
+        const Polyhedron *, Real [restrict], int [restrict], int [restrict]);
+static int ClassifyPoint(const Real [restrict], const Polyhedron *, int [restrict], int [restrict]);
+static int IndexSample(const int, const int, const int, const Polyhedron *);
+static Real PlaceVertex(const int, const int, const Decimator *, Real [restrict]);
+static int CheckCollapse(const int, const int, const Real [restrict], const Real,
+        Decimator *);
+static void CollapseEdge(const int, const int, const Real [restrict], Decimator *);
+static void BuildFanTriangle(const int, const int, const Real [restrict], const Decimator *,
+        Real [restrict], Real [restrict], Real [restrict]);
+static Real QuadricError(const Real [restrict], const Real [restrict]);
+static Real TripleProduct(const Real [restrict], const Real [restrict], const Real [restrict]);
+static Real MeshVolume(const int, int [restrict][POLYN], Real [restrict][DIMS]);
+static Real MeshDeviation(const int, Real [restrict][DIMS], Polyhedron *);
+static int FaceHasVertex(const int, const int, const Decimator *);
+static int CompareCollapse(const void *, const void *);
 /****************************************************************************
  * Function definitions
  ****************************************************************************/
@@ -198,12 +250,33 @@ void TransformPolyhedron(const Real O[restrict], const Real scale[restrict],
     poly->I[X][X] = I[0];  poly->I[X][Y] = -I[3]; poly->I[X][Z] = -I[5];
     poly->I[Y][X] = -I[3]; poly->I[Y][Y] = I[1];  poly->I[Y][Z] = -I[4];
     poly->I[Z][X] = -I[5]; poly->I[Z][Y] = -I[4]; poly->I[Z][Z] = I[2];
+    /* body frame of the distance field follows the rigid motion */
+    if (NULL != poly->sdf) {
+        Real R[DIMS][DIMS] = {{0.0}};
+        RealVec T = {0.0};
+        for (int r = 0; r < DIMS; ++r) {
+            for (int c = 0; c < DIMS; ++c) {
+                R[r][c] = rotate[r][X] * poly->sdfR[X][c] + rotate[r][Y] * poly->sdfR[Y][c] +
+                    rotate[r][Z] * poly->sdfR[Z][c];
+            }
+            axis[r] = poly->sdfT[r] - O[r];
+        }
+        for (int r = 0; r < DIMS; ++r) {
+            T[r] = Dot(rotate[r], axis) + offset[r] + O[r];
+        }
+        memcpy(poly->sdfR, R, sizeof(R));
+        memcpy(poly->sdfT, T, sizeof(T));
+    }
     /* centroid should be transformed at last */
     Real Oc[1][DIMS] = {{poly->O[X], poly->O[Y], poly->O[Z]}};
     TransformVertex(O, scale, rotate, offset, poly->box, 1, Oc);
     poly->O[X] = Oc[0][X];
     poly->O[Y] = Oc[0][Y];
     poly->O[Z] = Oc[0][Z];
+    /* rigid motion keeps the face order of the hierarchy valid */
+    if (0 < poly->bvN) {
+        RefitHierarchy(0, 0, poly->faceN, poly);
+    }
     return;
 }
 static void TransformVertex(const Real O[restrict], const Real scale[restrict],
@@ -259,14 +332,19 @@ static Real TransformInertia(const Real axis[restrict], Real I[restrict][DIMS])
         I[Z][Z] * axis[Z] * axis[Z] + 2.0 * I[X][Y] * axis[X] * axis[Y] +
         2.0 * I[Y][Z] * axis[Y] * axis[Z] + 2.0 * I[Z][X] * axis[Z] * axis[X];
 }
-void ComputeGeometryParameters(const int collapse, Geometry *const geo)
+void ComputeGeometryParameters(const int collapse, Pool *pool, Geometry *const geo)
 {
+    ParameterTask task = {.collapse = collapse, .geo = geo};
     for (int n = 0; n < geo->sphN; ++n) {
         ComputeParametersSphere(collapse, geo->poly + n);
     }
-    for (int n = geo->sphN; n < geo->totN; ++n) {
-        ComputeParametersPolyhedron(collapse, geo->poly + n);
-    }
+    RunWorkItems(pool, geo->stlN, ComputeParametersItem, &task);
+    return;
+}
+static void ComputeParametersItem(const int n, void *arg)
+{
+    const ParameterTask *const task = arg;
+    ComputeParametersPolyhedron(task->collapse, task->geo->poly + task->geo->sphN + n);
     return;
 }
 /*
@@ -444,6 +522,8 @@ static void ComputeParametersPolyhedron(const int collapse, Polyhedron *poly)
         }
         Normalize(DIMS, Norm(poly->Ne[n]), poly->Ne[n]);
     }
+    /* bounding volume hierarchy for closest face search */
+    BuildBoundingVolume(poly);
     return;
 }
 void BuildTriangle(const int fid, const Polyhedron *poly, Real v0[restrict],
@@ -461,6 +541,11 @@ void BuildTriangle(const int fid, const Polyhedron *poly, Real v0[restrict],
     return;
 }
 int PointInPolyhedron(const Real p[restrict], const Polyhedron *poly, int fid[restrict])
+{
+    int tests = 0; /* facet tests */
+    return ClassifyPoint(p, poly, fid, &tests);
+}
+static int ClassifyPoint(const Real p[restrict], const Polyhedron *poly, int fid[restrict], int tests[restrict])
 {
     const Real zero = 0.0;
     RealVec v0 = {zero}; /* vertices */
@@ -483,12 +568,17 @@ int PointInPolyhedron(const Real p[restrict], const Polyhedron *poly, int fid[re
     Real distSquare = zero; /* store computed squared distance */
     Real distSquareMin = FLT_MAX; /* store minimum squared distance */
     int cid = 0; /* closest face identifier */
-    for (int n = 0; n < poly->faceN; ++n) {
-        BuildTriangle(n, poly, v0, v1, v2, e01, e02);
-        distSquare = PointTriangleDistance(p, v0, e01, e02, para);
-        if (distSquareMin > distSquare) {
-            distSquareMin = distSquare;
-            cid = n;
+    if (0 < poly->bvN) {
+        SearchFace(p, 0, 0, poly->faceN, poly, &distSquareMin, &cid, tests);
+    } else {
+        *tests = *tests + poly->faceN;
+        for (int n = 0; n < poly->faceN; ++n) {
+            BuildTriangle(n, poly, v0, v1, v2, e01, e02);
+            distSquare = PointTriangleDistance(p, v0, e01, e02, para);
+            if (distSquareMin > distSquare) {
+                distSquareMin = distSquare;
+                cid = n;
+            }
         }
     }
     *fid = cid;
@@ -781,5 +871,816 @@ void ComputeGeometricData(const Real p[restrict], const int fid, const Polyhedro
     pm[Z] = pi[Z] + pi[Z] - p[Z];
     return;
 }
+/*
+ * Bounding volume hierarchy
+ *
+ * Faces are ordered by recursive median splits of their centroids along
+ * the longest side of the enclosing box. The hierarchy is a complete binary
+ * tree stored implicitly: node m has children 2m+1 and 2m+2, and a node
+ * covering faces [lo, hi) gives [lo, mid) and [mid, hi) to its children.
+ */
+void BuildBoundingVolume(Polyhedron *poly)
+{
+    int depth = 0; /* depth of leaves */
+    while (LEAFN * (1 << depth) < poly->faceN) {
+        ++depth;
+    }
+    poly->bvN = (1 << (depth + 1)) - 1;
+    poly->fo = AssignStorage(poly->faceN * sizeof(*poly->fo));
+    poly->bv = AssignStorage(poly->bvN * sizeof(*poly->bv));
+    for (int n = 0; n < poly->faceN; ++n) {
+        poly->fo[n] = n;
+    }
+    BuildHierarchy(0, 0, poly->faceN, poly);
+    RefitHierarchy(0, 0, poly->faceN, poly);
+    return;
+}
+static void BuildHierarchy(const int m, const int lo, const int hi, Polyhedron *poly)
+{
+    if (2 * m + 1 >= poly->bvN) { /* leaf */
+        return;
+    }
+    /* split along the longest side of the centroid box */
+    Real box[DIMS][LIMIT] = {{FLT_MAX, -FLT_MAX}, {FLT_MAX, -FLT_MAX}, {FLT_MAX, -FLT_MAX}};
+    Real key = 0.0;
+    for (int n = lo; n < hi; ++n) {
+        for (int s = 0; s < DIMS; ++s) {
+            key = FaceKey(poly->fo[n], s, poly);
+            box[s][MIN] = MinReal(box[s][MIN], key);
+            box[s][MAX] = MaxReal(box[s][MAX], key);
+        }
+    }
+    int s = X;
+    for (int q = Y; q < DIMS; ++q) {
+        if ((box[q][MAX] - box[q][MIN]) > (box[s][MAX] - box[s][MIN])) {
+            s = q;
+        }
+    }
+    const int mid = lo + (hi - lo) / 2;
+    SelectFace(lo, hi, mid, s, poly);
+    BuildHierarchy(2 * m + 1, lo, mid, poly);
+    BuildHierarchy(2 * m + 2, mid, hi, poly);
+    return;
+}
+static void RefitHierarchy(const int m, const int lo, const int hi, Polyhedron *poly)
+{
+    Real (*box)[LIMIT] = poly->bv[m];
+    for (int s = 0; s < DIMS; ++s) {
+        box[s][MIN] = FLT_MAX;
+        box[s][MAX] = -FLT_MAX;
+    }
+    if (2 * m + 1 >= poly->bvN) { /* leaf */
+        for (int n = lo; n < hi; ++n) {
+            for (int q = 0; q < POLYN; ++q) {
+                for (int s = 0; s < DIMS; ++s) {
+                    box[s][MIN] = MinReal(box[s][MIN], poly->v[poly->f[poly->fo[n]][q]][s]);
+                    box[s][MAX] = MaxReal(box[s][MAX], poly->v[poly->f[poly->fo[n]][q]][s]);
+                }
+            }
+        }
+        return;
+    }
+    const int mid = lo + (hi - lo) / 2;
+    RefitHierarchy(2 * m + 1, lo, mid, poly);
+    RefitHierarchy(2 * m + 2, mid, hi, poly);
+    for (int s = 0; s < DIMS; ++s) {
+        box[s][MIN] = MinReal(poly->bv[2 * m + 1][s][MIN], poly->bv[2 * m + 2][s][MIN]);
+        box[s][MAX] = MaxReal(poly->bv[2 * m + 1][s][MAX], poly->bv[2 * m + 2][s][MAX]);
+    }
+    return;
+}
+/*
+ * Partially order faces in [lo, hi) so that the face at mid has its
+ * centroid key in sorted position, Hoare's selection algorithm.
+ */
+static void SelectFace(int lo, int hi, const int mid, const int s, Polyhedron *poly)
+{
+    int *const fo = poly->fo;
+    int i = 0, j = 0, tmp = 0;
+    Real pivot = 0.0;
+    hi = hi - 1;
+    while (lo < hi) {
+        pivot = FaceKey(fo[lo + (hi - lo) / 2], s, poly);
+        i = lo;
+        j = hi;
+        while (i <= j) {
+            while (FaceKey(fo[i], s, poly) < pivot) {
+                ++i;
+            }
+            while (FaceKey(fo[j], s, poly) > pivot) {
+                --j;
+            }
+            if (i <= j) {
+                tmp = fo[i]; fo[i] = fo[j]; fo[j] = tmp;
+                ++i;
+                --j;
+            }
+        }
+        if (mid <= j) {
+            hi = j;
+        } else {
+            if (mid >= i) {
+                lo = i;
+            } else {
+                break;
+            }
+        }
+    }
+    return;
+}
+static Real FaceKey(const int fid, const int s, const Polyhedron *poly)
+{
+    return poly->v[poly->f[fid][0]][s] + poly->v[poly->f[fid][1]][s] + poly->v[poly->f[fid][2]][s];
+}
+static Real BoxDistance(const Real p[restrict], Real box[restrict][LIMIT])
+{
+    Real dist = 0.0;
+    Real d = 0.0;
+    for (int s = 0; s < DIMS; ++s) {
+        d = MaxReal(box[s][MIN] - p[s], MaxReal(p[s] - box[s][MAX], 0.0));
+        dist = dist + d * d;
+    }
+    return dist;
+}
+/*
+ * Closest face search with branch and bound. Ties are resolved to the
+ * smallest face identifier and a box is only pruned when it is clearly
+ * farther than the current best, so the result matches a linear scan.
+ */
+static void SearchFace(const Real p[restrict], const int m, const int lo, const int hi,
+        const Polyhedron *poly, Real distSquareMin[restrict], int cid[restrict], int tests[restrict])
+{
+    const Real slack = 1.0 - 1.0e-12; /* round-off margin of the box bound */
+    if (BoxDistance(p, poly->bv[m]) * slack > *distSquareMin) {
+        return;
+    }
+    if (2 * m + 1 >= poly->bvN) { /* leaf */
+        RealVec v0 = {0.0}; /* vertices */
+        RealVec v1 = {0.0};
+        RealVec v2 = {0.0};
+        RealVec e01 = {0.0}; /* edges */
+        RealVec e02 = {0.0};
+        RealVec para = {0.0}; /* parametric coordinates */
+        Real distSquare = 0.0;
+        int fid = 0;
+        *tests = *tests + hi - lo;
+        for (int n = lo; n < hi; ++n) {
+            fid = poly->fo[n];
+            BuildTriangle(fid, poly, v0, v1, v2, e01, e02);
+            distSquare = PointTriangleDistance(p, v0, e01, e02, para);
+            if ((*distSquareMin > distSquare) || ((*distSquareMin == distSquare) && (*cid > fid))) {
+                *distSquareMin = distSquare;
+                *cid = fid;
+            }
+        }
+        return;
+    }
+    /* visit the nearer child first to tighten the bound early */
+    const int mid = lo + (hi - lo) / 2;
+    if (BoxDistance(p, poly->bv[2 * m + 1]) <= BoxDistance(p, poly->bv[2 * m + 2])) {
+        SearchFace(p, 2 * m + 1, lo, mid, poly, distSquareMin, cid, tests);
+        SearchFace(p, 2 * m + 2, mid, hi, poly, distSquareMin, cid, tests);
+    } else {
+        SearchFace(p, 2 * m + 2, mid, hi, poly, distSquareMin, cid, tests);
+        SearchFace(p, 2 * m + 1, lo, mid, poly, distSquareMin, cid, tests);
+    }
+    return;
+}
+/*
+ * Signed distance field
+ *
+ * The field is sampled once on a uniform grid in the body frame, which is
+ * the world frame at sampling time, with two samples of margin around the
+ * bounding box. Rigid motion only changes the body frame. Since a signed
+ * distance is 1-Lipschitz, trilinear interpolation in a cell differs from
+ * the exact value by at most the cell diagonal, which bounds the region
+ * where the sign is uncertain. The band is the depth below the surface
+ * within which callers use the closest face of inside points.
+ */
+void BuildDistanceField(const int sampleN, const Real band, Polyhedron *poly)
+{
+    Real side = 0.0; /* longest side of the bounding box */
+    RealVec p = {0.0}; /* sample point */
+    RealVec pi = {0.0}; /* closest surface point */
+    RealVec N = {0.0}; /* normal of the closest point */
+    const Real slack = 1.0 + 1.0e-6; /* round-off margin of the bound */
+    Real dist = 0.0; /* distance of the previous sample */
+    Real distSquare = 0.0; /* squared distance */
+    int fid = 0; /* closest face */
+    int idx = 0; /* linear sample index */
+    int tests = 0; /* facet tests */
+    for (int s = 0; s < DIMS; ++s) {
+        side = MaxReal(side, poly->box[s][MAX] - poly->box[s][MIN]);
+    }
+    poly->sdfH = side / (Real)MaxInt(sampleN - 1, 1);
+    poly->sdfBand = band;
+    for (int s = 0; s < DIMS; ++s) {
+        poly->sdfN[s] = (int)ceil((poly->box[s][MAX] - poly->box[s][MIN]) / poly->sdfH) + 5;
+        poly->sdfO[s] = poly->box[s][MIN] - 2.0 * poly->sdfH;
+        poly->sdfT[s] = 0.0;
+        for (int r = 0; r < DIMS; ++r) {
+            poly->sdfR[s][r] = (s == r) ? 1.0 : 0.0;
+        }
+    }
+    poly->sdf = AssignStorage(poly->sdfN[X] * poly->sdfN[Y] * poly->sdfN[Z] * sizeof(*poly->sdf));
+    poly->sdfF = AssignStorage(poly->sdfN[X] * poly->sdfN[Y] * poly->sdfN[Z] * sizeof(*poly->sdfF));
+    for (int k = 0; k < poly->sdfN[Z]; ++k) {
+        for (int j = 0; j < poly->sdfN[Y]; ++j) {
+            dist = FLT_MAX;
+            for (int i = 0; i < poly->sdfN[X]; ++i) {
+                p[X] = poly->sdfO[X] + i * poly->sdfH;
+                p[Y] = poly->sdfO[Y] + j * poly->sdfH;
+                p[Z] = poly->sdfO[Z] + k * poly->sdfH;
+                idx = IndexSample(k, j, i, poly);
+                /* the previous sample bounds the distance, which prunes the search */
+                distSquare = (FLT_MAX == dist) ? FLT_MAX : (dist + slack * poly->sdfH) * (dist + slack * poly->sdfH);
+                fid = poly->faceN;
+                SearchFace(p, 0, 0, poly->faceN, poly, &distSquare, &fid, &tests);
+                ComputeIntersection(p, fid, poly, pi, N);
+                pi[X] = p[X] - pi[X];
+                pi[Y] = p[Y] - pi[Y];
+                pi[Z] = p[Z] - pi[Z];
+                dist = sqrt(distSquare);
+                poly->sdf[idx] = (0.0 < Dot(pi, N)) ? dist : -dist;
+                poly->sdfF[idx] = fid;
+            }
+        }
+    }
+    return;
+}
+int PointInDistanceField(const Real p[restrict], const Polyhedron *poly, int fid[restrict], int tests[restrict])
+{
+    if (NULL == poly->sdf) {
+        return ClassifyPoint(p, poly, fid, tests);
+    }
+    RealVec b = {0.0}; /* point in body frame */
+    RealVec g = {0.0}; /* local coordinates in sample cell */
+    IntVec n = {0}; /* sample cell */
+    Real phi = 0.0; /* interpolated signed distance */
+    Real w = 0.0; /* interpolation weight */
+    Real wMax = -1.0; /* weight of the nearest sample */
+    int idx = 0; /* linear sample index */
+    for (int s = 0; s < DIMS; ++s) {
+        b[s] = poly->sdfR[X][s] * (p[X] - poly->sdfT[X]) + poly->sdfR[Y][s] * (p[Y] - poly->sdfT[Y]) +
+            poly->sdfR[Z][s] * (p[Z] - poly->sdfT[Z]);
+        g[s] = (b[s] - poly->sdfO[s]) / poly->sdfH;
+        if ((0.0 > g[s]) || ((Real)(poly->sdfN[s] - 1) <= g[s])) {
+            *fid = 0;
+            return 0; /* beyond the margin of the bounding box */
+        }
+        n[s] = (int)g[s];
+        g[s] = g[s] - n[s];
+    }
+    for (int c = 0; c < 8; ++c) {
+        w = ((c & 1) ? g[X] : 1.0 - g[X]) * ((c & 2) ? g[Y] : 1.0 - g[Y]) * ((c & 4) ? g[Z] : 1.0 - g[Z]);
+        idx = IndexSample(n[Z] + ((c >> 2) & 1), n[Y] + ((c >> 1) & 1), n[X] + (c & 1), poly);
+        phi = phi + w * poly->sdf[idx];
+        if (w > wMax) {
+            wMax = w;
+            *fid = poly->sdfF[idx];
+        }
+    }
+    const Real diag = sqrt(3.0) * poly->sdfH; /* interpolation error bound */
+    if (diag < phi) {
+        return 0;
+    }
+    if (-(poly->sdfBand + diag) > phi) {
+        return 1;
+    }
+    /* exact refinement near the surface */
+    return ClassifyPoint(p, poly, fid, tests);
+}
+static int IndexSample(const int k, const int j, const int i, const Polyhedron *poly)
+{
+    return (k * poly->sdfN[Y] + j) * poly->sdfN[X] + i;
+}
+/*
+ * Garland, M., & Heckbert, P. S. (1997). Surface simplification using
+ * quadric error metrics. Proceedings of SIGGRAPH 97, 209-216.
+ * Lindstrom, P., & Turk, G. (1998). Fast and memory efficient polygonal
+ * simplification. Proceedings of Visualization 98, 279-286.
+ * Dey, T. K., Edelsbrunner, H., Guha, S., & Nekhayev, D. V. (1999).
+ * Topology preserving edge contraction. Publications de l'Institut
+ * Mathematique, 66(80), 23-45.
+ *
+ * Edges shorter than size are collapsed in passes of increasing quadric
+ * error, and a vertex takes part in at most one collapse per pass. The
+ * new vertex minimizes the quadric of the original face planes on the
+ * plane that keeps the enclosed volume. A collapse is rejected if it
+ * breaks the link condition, which keeps the surface closed and
+ * manifold, folds a face, or leaves an original vertex merged into the
+ * edge farther than tol from the new faces.
+ */
+void DecimatePolyhedron(const Real size, const Real tol, Polyhedron *poly)
+{
+    if ((4 >= poly->faceN) || (0.0 >= size)) {
+        return;
+    }
+    if (2 * poly->edgeN != POLYN * poly->faceN) {
+        ShowWarning("decimation skipped for open polyhedron");
+        return;
+    }
+    const int faceN = poly->faceN;
+    const int vertN = poly->vertN;
+    const Real sizeSquare = size * size;
+    const Real tolSquare = tol * tol;
+    RealVec v0 = {0.0}; /* vertices */
+    RealVec v1 = {0.0};
+    RealVec v2 = {0.0};
+    RealVec e01 = {0.0}; /* edges */
+    RealVec e02 = {0.0};
+    RealVec N = {0.0}; /* face normal */
+    RealVec p = {0.0}; /* collapsed vertex */
+    Decimator dec = {.faceN = faceN, .f = poly->f, .v = poly->v, .tick = 0};
+    dec.Q = AssignStorage(vertN * sizeof(*dec.Q));
+    dec.live = AssignStorage(faceN * sizeof(*dec.live));
+    dec.head = AssignStorage(vertN * sizeof(*dec.head));
+    dec.next = AssignStorage(POLYN * faceN * sizeof(*dec.next));
+    dec.ohead = AssignStorage(vertN * sizeof(*dec.ohead));
+    dec.otail = AssignStorage(vertN * sizeof(*dec.otail));
+    dec.onext = AssignStorage(vertN * sizeof(*dec.onext));
+    dec.stamp = AssignStorage(vertN * sizeof(*dec.stamp));
+    dec.org = AssignStorage(vertN * sizeof(*dec.org));
+    int (*orgF)[POLYN] = AssignStorage(faceN * sizeof(*orgF));
+    int *touch = AssignStorage(vertN * sizeof(*touch)); /* last pass of a nearby collapse */
+    Collapse *cand = AssignStorage(POLYN * faceN * sizeof(*cand));
+    memcpy(orgF, poly->f, faceN * sizeof(*orgF));
+    memcpy(dec.org, poly->v, vertN * sizeof(*dec.org));
+    for (int n = 0; n < vertN; ++n) {
+        dec.head[n] = -1;
+        dec.ohead[n] = n;
+        dec.otail[n] = n;
+        dec.onext[n] = -1;
+    }
+    /* face corners of each vertex and quadrics of the original face planes */
+    for (int n = faceN - 1; n >= 0; --n) {
+        dec.live[n] = 1;
+        for (int k = POLYN - 1; k >= 0; --k) {
+            dec.next[POLYN * n + k] = dec.head[dec.f[n][k]];
+            dec.head[dec.f[n][k]] = POLYN * n + k;
+        }
+        BuildTriangle(n, poly, v0, v1, v2, e01, e02);
+        Cross(e01, e02, N);
+        if (0.0 == Norm(N)) {
+            continue;
+        }
+        Normalize(DIMS, Norm(N), N);
+        const Real plane[DIMS+1] = {N[X], N[Y], N[Z], -Dot(N, v0)};
+        for (int k = 0; k < POLYN; ++k) {
+            for (int i = 0, m = 0; i <= DIMS; ++i) {
+                for (int j = i; j <= DIMS; ++j, ++m) {
+                    dec.Q[dec.f[n][k]][m] = dec.Q[dec.f[n][k]][m] + plane[i] * plane[j];
+                }
+            }
+        }
+    }
+    /* collapse passes */
+    int a = 0;
+    int b = 0;
+    int candN = 0;
+    int collapseN = 0;
+    for (int pass = 1; ; ++pass) {
+        candN = 0;
+        for (int n = 0; n < faceN; ++n) {
+            if (0 == dec.live[n]) {
+                continue;
+            }
+            for (int k = 0; k < POLYN; ++k) {
+                a = dec.f[n][k];
+                b = dec.f[n][(k + 1) % POLYN];
+                if (a > b) { /* each edge is visited once in a closed surface */
+                    continue;
+                }
+                for (int s = 0; s < DIMS; ++s) {
+                    e01[s] = dec.v[b][s] - dec.v[a][s];
+                }
+                if (sizeSquare <= Dot(e01, e01)) {
+                    continue;
+                }
+                cand[candN].cost = PlaceVertex(a, b, &dec, p);
+                cand[candN].v0 = a;
+                cand[candN].v1 = b;
+                if (tolSquare >= cand[candN].cost) {
+                    ++candN;
+                }
+            }
+        }
+        qsort(cand, candN, sizeof(*cand), CompareCollapse);
+        collapseN = 0;
+        for (int n = 0; n < candN; ++n) {
+            a = cand[n].v0;
+            b = cand[n].v1;
+            if ((pass == touch[a]) || (pass == touch[b])) {
+                continue;
+            }
+            PlaceVertex(a, b, &dec, p);
+            if (0 == CheckCollapse(a, b, p, tolSquare, &dec)) {
+                continue;
+            }
+            CollapseEdge(a, b, p, &dec);
+            for (int c = dec.head[a]; 0 <= c; c = dec.next[c]) {
+                for (int k = 0; k < POLYN; ++k) {
+                    touch[dec.f[c/POLYN][k]] = pass;
+                }
+            }
+            ++collapseN;
+        }
+        if (0 == collapseN) {
+            break;
+        }
+    }
+    /* compact the surviving vertices and faces */
+    int *map = touch;
+    int newV = 0;
+    int newF = 0;
+    for (int n = 0; n < vertN; ++n) {
+        map[n] = -1;
+        if (0 <= dec.ohead[n]) {
+            map[n] = newV;
+            ++newV;
+        }
+    }
+    int (*f)[POLYN] = AssignStorage(dec.faceN * sizeof(*f));
+    Real (*v)[DIMS] = AssignStorage(newV * sizeof(*v));
+    for (int n = 0; n < vertN; ++n) {
+        if (0 <= map[n]) {
+            for (int s = 0; s < DIMS; ++s) {
+                v[map[n]][s] = dec.v[n][s];
+            }
+        }
+    }
+    for (int n = 0; n < faceN; ++n) {
+        if (0 != dec.live[n]) {
+            for (int k = 0; k < POLYN; ++k) {
+                f[newF][k] = map[dec.f[n][k]];
+            }
+            ++newF;
+        }
+    }
+    /* sampled two-sided Hausdorff distance between the surfaces */
+    Polyhedron mesh;
+    memset(&mesh, 0, sizeof(mesh));
+    mesh.faceN = faceN;
+    mesh.vertN = vertN;
+    mesh.f = orgF;
+    mesh.v = dec.org;
+    BuildBoundingVolume(&mesh);
+    Real dist = MeshDeviation(newV, v, &mesh);
+    const Real volume = MeshVolume(faceN, orgF, dec.org);
+    RetrieveStorage(mesh.fo);
+    RetrieveStorage(mesh.bv);
+    mesh.faceN = newF;
+    mesh.vertN = newV;
+    mesh.f = f;
+    mesh.v = v;
+    BuildBoundingVolume(&mesh);
+    dist = MaxReal(dist, MeshDeviation(vertN, dec.org, &mesh));
+    RetrieveStorage(mesh.fo);
+    RetrieveStorage(mesh.bv);
+    ShowInfo("  decimation: faces %d -> %d; Hausdorff distance %.6g; volume change %.6g\n",
+            faceN, newF, dist, MeshVolume(newF, f, v) / volume - 1.0);
+    if (tol < dist) {
+        ShowWarning("decimation error %.6g exceeds bound %.6g", dist, tol);
+    }
+    /* rebuild the polyhedron on the simplified surface */
+    RetrieveStorage(poly->f);
+    RetrieveStorage(poly->Nf);
+    RetrieveStorage(poly->e);
+    RetrieveStorage(poly->Ne);
+    RetrieveStorage(poly->v);
+    RetrieveStorage(poly->Nv);
+    poly->faceN = newF;
+    poly->vertN = newV;
+    poly->f = f;
+    poly->v = v;
+    poly->Nf = AssignStorage(newF * sizeof(*poly->Nf));
+    poly->Nv = AssignStorage(newV * sizeof(*poly->Nv));
+    poly->e = AssignStorage(POLYN * newF * sizeof(*poly->e));
+    for (int n = 0; n < newF; ++n) {
+        for (int k = 0; k < POLYN; ++k) {
+            a = f[n][k];
+            b = f[n][(k + 1) % POLYN];
+            poly->e[POLYN * n + k][0] = (a > b) ? a : b;
+            poly->e[POLYN * n + k][1] = (a > b) ? b : a;
+            poly->e[POLYN * n + k][2] = n;
+        }
+    }
+    QuickSortEdge(POLYN * newF, poly->e);
+    poly->edgeN = 0;
+    for (int n = 0; n < POLYN * newF; ++n) {
+        if ((0 < poly->edgeN) && (poly->e[n][0] == poly->e[poly->edgeN-1][0]) &&
+                (poly->e[n][1] == poly->e[poly->edgeN-1][1])) {
+            a = poly->e[poly->edgeN-1][2];
+            b = poly->e[n][2];
+            poly->e[poly->edgeN-1][2] = (a < b) ? a : b;
+            poly->e[poly->edgeN-1][3] = (a < b) ? b : a;
+            continue;
+        }
+        for (int k = 0; k < EVF; ++k) {
+            poly->e[poly->edgeN][k] = poly->e[n][k];
+        }
+        poly->e[poly->edgeN][3] = 0;
+        ++(poly->edgeN);
+    }
+    poly->e = realloc(poly->e, poly->edgeN * sizeof(*poly->e));
+    poly->Ne = AssignStorage(poly->edgeN * sizeof(*poly->Ne));
+    RetrieveStorage(dec.Q);
+    RetrieveStorage(dec.live);
+    RetrieveStorage(dec.head);
+    RetrieveStorage(dec.next);
+    RetrieveStorage(dec.ohead);
+    RetrieveStorage(dec.otail);
+    RetrieveStorage(dec.onext);
+    RetrieveStorage(dec.stamp);
+    RetrieveStorage(dec.org);
+    RetrieveStorage(orgF);
+    RetrieveStorage(touch);
+    RetrieveStorage(cand);
+    return;
+}
+/*
+ * The collapsed vertex p minimizes the summed quadric of the two edge
+ * vertices subject to g.p = r, which keeps the volume enclosed by the
+ * faces around the edge. The midpoint projected onto the constraint is
+ * used when the system is singular, as on planes and creases, or when
+ * the optimum leaves the neighbourhood of the edge.
+ */
+static Real PlaceVertex(const int a, const int b, const Decimator *dec, Real p[restrict])
+{
+    const int ends[2] = {a, b};
+    Real Q[QUADN] = {0.0};
+    RealVec g = {0.0}; /* gradient of six times the enclosed volume */
+    RealVec tmp = {0.0};
+    Real r = 0.0; /* six times the enclosed volume */
+    for (int m = 0; m < QUADN; ++m) {
+        Q[m] = dec->Q[a][m] + dec->Q[b][m];
+    }
+    for (int m = 0; m < 2; ++m) {
+        for (int c = dec->head[ends[m]]; 0 <= c; c = dec->next[c]) {
+            const int fid = c / POLYN;
+            const int k = c % POLYN;
+            if ((0 == dec->live[fid]) || ((1 == m) && (FaceHasVertex(fid, a, dec)))) {
+                continue;
+            }
+            r = r + TripleProduct(dec->v[dec->f[fid][0]], dec->v[dec->f[fid][1]], dec->v[dec->f[fid][2]]);
+            if (FaceHasVertex(fid, ends[1-m], dec)) { /* vanishes with the edge */
+                continue;
+            }
+            Cross(dec->v[dec->f[fid][(k+1)%POLYN]], dec->v[dec->f[fid][(k+2)%POLYN]], tmp);
+            for (int s = 0; s < DIMS; ++s) {
+                g[s] = g[s] + tmp[s];
+            }
+        }
+    }
+    RealVec mid = {0.0};
+    for (int s = 0; s < DIMS; ++s) {
+        mid[s] = 0.5 * (dec->v[a][s] + dec->v[b][s]);
+        tmp[s] = dec->v[b][s] - dec->v[a][s];
+        p[s] = mid[s];
+    }
+    const Real len = Norm(tmp);
+    const Real gn = Norm(g);
+    if (0.0 == gn) {
+        return QuadricError(Q, p);
+    }
+    /* solve the Lagrange system with partial pivoting */
+    Real M[DIMS+1][DIMS+2] = {
+        {Q[0], Q[1], Q[2], g[X] / gn, -Q[3]},
+        {Q[1], Q[4], Q[5], g[Y] / gn, -Q[6]},
+        {Q[2], Q[5], Q[7], g[Z] / gn, -Q[8]},
+        {g[X] / gn, g[Y] / gn, g[Z] / gn, 0.0, r / gn}};
+    const Real small = 1.0e-8 * (1.0 + Q[0] + Q[4] + Q[7]);
+    int solved = 1;
+    for (int i = 0; (i <= DIMS) && solved; ++i) {
+        int piv = i;
+        for (int j = i + 1; j <= DIMS; ++j) {
+            piv = (fabs(M[j][i]) > fabs(M[piv][i])) ? j : piv;
+        }
+        if (small > fabs(M[piv][i])) {
+            solved = 0;
+            break;
+        }
+        for (int j = 0; j <= DIMS + 1; ++j) {
+            const Real swap = M[i][j];
+            M[i][j] = M[piv][j];
+            M[piv][j] = swap;
+        }
+        for (int j = i + 1; j <= DIMS; ++j) {
+            const Real ratio = M[j][i] / M[i][i];
+            for (int l = i; l <= DIMS + 1; ++l) {
+                M[j][l] = M[j][l] - ratio * M[i][l];
+            }
+        }
+    }
+    if (solved) {
+        Real sol[DIMS+1] = {0.0};
+        for (int i = DIMS; i >= 0; --i) {
+            sol[i] = M[i][DIMS+1];
+            for (int j = i + 1; j <= DIMS; ++j) {
+                sol[i] = sol[i] - M[i][j] * sol[j];
+            }
+            sol[i] = sol[i] / M[i][i];
+        }
+        for (int s = 0; s < DIMS; ++s) {
+            tmp[s] = sol[s] - mid[s];
+        }
+        if (len >= Norm(tmp)) {
+            for (int s = 0; s < DIMS; ++s) {
+                p[s] = sol[s];
+            }
+            return QuadricError(Q, p);
+        }
+    }
+    const Real shift = (r - Dot(g, mid)) / (gn * gn);
+    for (int s = 0; s < DIMS; ++s) {
+        p[s] = mid[s] + shift * g[s];
+    }
+    return QuadricError(Q, p);
+}
+static int CheckCollapse(const int a, const int b, const Real p[restrict], const Real tolSquare,
+        Decimator *dec)
+{
+    const Real cosine = 0.5; /* bound of face normal rotation */
+    const int ends[2] = {a, b};
+    RealVec v0 = {0.0};
+    RealVec e01 = {0.0};
+    RealVec e02 = {0.0};
+    RealVec N = {0.0};
+    RealVec Nc = {0.0};
+    RealVec para = {0.0};
+    if (4 > dec->faceN - 2) {
+        return 0;
+    }
+    /* link condition: the two edge vertices share exactly two neighbours */
+    ++(dec->tick);
+    for (int c = dec->head[a]; 0 <= c; c = dec->next[c]) {
+        if (0 == dec->live[c/POLYN]) {
+            continue;
+        }
+        for (int k = 0; k < POLYN; ++k) {
+            dec->stamp[dec->f[c/POLYN][k]] = dec->tick;
+        }
+    }
+    ++(dec->tick);
+    int common = 0;
+    for (int c = dec->head[b]; 0 <= c; c = dec->next[c]) {
+        if (0 == dec->live[c/POLYN]) {
+            continue;
+        }
+        for (int k = 0; k < POLYN; ++k) {
+            const int u = dec->f[c/POLYN][k];
+            if ((a != u) && (b != u) && (dec->tick - 1 == dec->stamp[u])) {
+                dec->stamp[u] = dec->tick;
+                ++common;
+            }
+        }
+    }
+    if (2 != common) {
+        return 0;
+    }
+    /* faces around the edge must not fold */
+    for (int m = 0; m < 2; ++m) {
+        for (int c = dec->head[ends[m]]; 0 <= c; c = dec->next[c]) {
+            if ((0 == dec->live[c/POLYN]) || FaceHasVertex(c / POLYN, ends[1-m], dec)) {
+                continue;
+            }
+            BuildFanTriangle(c / POLYN, c % POLYN, dec->v[ends[m]], dec, v0, e01, e02);
+            Cross(e01, e02, N);
+            BuildFanTriangle(c / POLYN, c % POLYN, p, dec, v0, e01, e02);
+            Cross(e01, e02, Nc);
+            if (cosine * Norm(N) * Norm(Nc) >= Dot(N, Nc)) {
+                return 0;
+            }
+        }
+    }
+    /* original vertices merged into the edge stay close to the new faces */
+    for (int m = 0; m < 2; ++m) {
+        for (int o = dec->ohead[ends[m]]; 0 <= o; o = dec->onext[o]) {
+            Real distSquareMin = FLT_MAX;
+            for (int l = 0; l < 2; ++l) {
+                for (int c = dec->head[ends[l]]; 0 <= c; c = dec->next[c]) {
+                    if ((0 == dec->live[c/POLYN]) || FaceHasVertex(c / POLYN, ends[1-l], dec)) {
+                        continue;
+                    }
+                    BuildFanTriangle(c / POLYN, c % POLYN, p, dec, v0, e01, e02);
+                    distSquareMin = MinReal(distSquareMin,
+                            PointTriangleDistance(dec->org[o], v0, e01, e02, para));
+                }
+            }
+            if (tolSquare < distSquareMin) {
+                return 0;
+            }
+        }
+    }
+    return 1;
+}
+static void CollapseEdge(const int a, const int b, const Real p[restrict], Decimator *dec)
+{
+    int tail = -1;
+    for (int c = dec->head[b]; 0 <= c; c = dec->next[c]) {
+        tail = c;
+        if (0 == dec->live[c/POLYN]) {
+            continue;
+        }
+        if (FaceHasVertex(c / POLYN, a, dec)) {
+            dec->live[c/POLYN] = 0;
+            --(dec->faceN);
+        } else {
+            dec->f[c/POLYN][c%POLYN] = a;
+        }
+    }
+    /* hand over the corners of b and drop the corners of dead faces */
+    dec->next[tail] = dec->head[a];
+    dec->head[a] = dec->head[b];
+    dec->head[b] = -1;
+    int *link = dec->head + a;
+    while (0 <= *link) {
+        if (0 == dec->live[*link/POLYN]) {
+            *link = dec->next[*link];
+        } else {
+            link = dec->next + *link;
+        }
+    }
+    for (int s = 0; s < DIMS; ++s) {
+        dec->v[a][s] = p[s];
+    }
+    for (int m = 0; m < QUADN; ++m) {
+        dec->Q[a][m] = dec->Q[a][m] + dec->Q[b][m];
+    }
+    dec->onext[dec->otail[a]] = dec->ohead[b];
+    dec->otail[a] = dec->otail[b];
+    dec->ohead[b] = -1;
+    return;
+}
+/*
+ * Triangle of face fid with the vertex at corner k moved to p.
+ */
+static void BuildFanTriangle(const int fid, const int k, const Real p[restrict], const Decimator *dec,
+        Real v0[restrict], Real e01[restrict], Real e02[restrict])
+{
+    Real q[POLYN][DIMS] = {{0.0}};
+    for (int j = 0; j < POLYN; ++j) {
+        for (int s = 0; s < DIMS; ++s) {
+            q[j][s] = (k == j) ? p[s] : dec->v[dec->f[fid][j]][s];
+        }
+    }
+    for (int s = 0; s < DIMS; ++s) {
+        v0[s] = q[0][s];
+        e01[s] = q[1][s] - q[0][s];
+        e02[s] = q[2][s] - q[0][s];
+    }
+    return;
+}
+static Real QuadricError(const Real Q[restrict], const Real p[restrict])
+{
+    const Real err = Q[0] * p[X] * p[X] + Q[4] * p[Y] * p[Y] + Q[7] * p[Z] * p[Z] +
+        2.0 * (Q[1] * p[X] * p[Y] + Q[2] * p[X] * p[Z] + Q[5] * p[Y] * p[Z]) +
+        2.0 * (Q[3] * p[X] + Q[6] * p[Y] + Q[8] * p[Z]) + Q[9];
+    return MaxReal(err, 0.0);
+}
+static Real TripleProduct(const Real v0[restrict], const Real v1[restrict], const Real v2[restrict])
+{
+    RealVec tmp = {0.0};
+    Cross(v1, v2, tmp);
+    return Dot(v0, tmp);
+}
+static Real MeshVolume(const int faceN, int f[restrict][POLYN], Real v[restrict][DIMS])
+{
+    Real volume = 0.0;
+    for (int n = 0; n < faceN; ++n) {
+        volume = volume + TripleProduct(v[f[n][0]], v[f[n][1]], v[f[n][2]]);
+    }
+    return volume * (1.0 / 6.0);
+}
+static Real MeshDeviation(const int pointN, Real p[restrict][DIMS], Polyhedron *mesh)
+{
+    Real distSquareMax = 0.0;
+    Real distSquare = 0.0;
+    int cid = 0;
+    int tests = 0; /* facet tests */
+    for (int n = 0; n < pointN; ++n) {
+        distSquare = FLT_MAX;
+        cid = 0;
+        SearchFace(p[n], 0, 0, mesh->faceN, mesh, &distSquare, &cid, &tests);
+        distSquareMax = MaxReal(distSquareMax, distSquare);
+    }
+    return sqrt(distSquareMax);
+}
+static int FaceHasVertex(const int fid, const int u, const Decimator *dec)
+{
+    return (u == dec->f[fid][0]) || (u == dec->f[fid][1]) || (u == dec->f[fid][2]);
+}
+static int CompareCollapse(const void *x, const void *y)
+{
+    const Collapse *cx = x;
+    const Collapse *cy = y;
+    if (cx->cost != cy->cost) {
+        return (cx->cost < cy->cost) ? -1 : 1;
+    }
+    if (cx->v0 != cy->v0) {
+        return (cx->v0 < cy->v0) ? -1 : 1;
+    }
+    return (cx->v1 < cy->v1) ? -1 : ((cx->v1 > cy->v1) ? 1 : 0);
+}
 /* a good practice: end file with a newline */
 
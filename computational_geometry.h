@@ -37,6 +37,16 @@ extern void AddEdge(const int v0, const int v1, const int f, Polyhedron *);
 extern void QuickSortEdge(const int n, int e[restrict][EVF]);
 extern void BuildTriangle(const int fid, const Polyhedron *, Real v0[restrict],
         Real v1[restrict], Real v2[restrict], Real e01[restrict], Real e02[restrict]);
+/*
+ * Polyhedron decimation
+ *
+ * Function
+ *      Simplify a closed triangulated polyhedron by edge collapse until no
+ *      edge shorter than size can be removed without moving the surface
+ *      farther than tol. The enclosed volume, closedness and topology are
+ *      preserved; face counts and the sampled Hausdorff distance are reported.
+ */
+extern void DecimatePolyhedron(const Real size, const Real tol, Polyhedron *);
 /*
  * Compute geometry parameters
  *
@@ -45,13 +55,23 @@ extern void BuildTriangle(const int fid, const Polyhedron *, Real v0[restrict],
  *      volume, area, volume, centroid, inertia tensor, normal. Note that the
  *      inertia tensor is relative to the body coordinates located at centroid
  *      and is computed by assuming that the density is a constant with value 1.
+ *      Triangulated polyhedrons are shared among the threads of the pool.
  */
-extern void ComputeGeometryParameters(const int collapse, Geometry *const);
+extern void ComputeGeometryParameters(const int collapse, Pool *, Geometry *const);
 /*
  * Polyhedron transformation
  */
 extern void TransformPolyhedron(const Real O[restrict], const Real scale[restrict],
         const Real angle[restrict], const Real offset[restrict], Polyhedron *);
+/*
+ * Bounding volume hierarchy
+ *
+ * Function
+ *      Build a hierarchy of axis-aligned boxes over the faces of a
+ *      triangulated polyhedron for closest face search. The boxes are
+ *      refitted whenever the polyhedron is transformed.
+ */
+extern void BuildBoundingVolume(Polyhedron *);
 /*
  * Point in polyhedron
  *
@@ -60,6 +80,27 @@ extern void TransformPolyhedron(const Real O[restrict], const Real scale[restric
  *      also find the cloest face.
  */
 extern int PointInPolyhedron(const Real p[restrict], const Polyhedron *, int fid[restrict]);
+/*
+ * Signed distance field
+ *
+ * Function
+ *      Sample the signed distance and the closest face of a triangulated
+ *      polyhedron on a body frame grid with sampleN samples on the longest
+ *      side. The body frame follows later rigid transformations.
+ */
+extern void BuildDistanceField(const int sampleN, const Real band, Polyhedron *);
+/*
+ * Point in distance field
+ *
+ * Function
+ *      Solve point-in-polyhedron problem by trilinear lookup in the signed
+ *      distance field, refined by the exact search near the surface. The
+ *      closest face is exact for points outside the field's uncertainty
+ *      and within band below the surface, and is the face of the nearest
+ *      sample for deeper points. Without a field, the exact search is used.
+ *      The number of facets tested is added to tests.
+ */
+extern int PointInDistanceField(const Real p[restrict], const Polyhedron *, int fid[restrict], int tests[restrict]);
 /*
  * Point triangle distance
  *
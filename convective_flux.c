@@ -13,6 +13,7 @@
  ****************************************************************************/
 #include "convective_flux.h"
 #include "weno.h"
+#include "hllc.h"
 #include "cfd_commons.h"
 #include "commons.h"
 /****************************************************************************
@@ -26,9 +27,15 @@ typedef enum {
  * Function Pointers
  ****************************************************************************/
 typedef void (*FhatReconstructor)(Real [restrict][DIMU], Real [restrict]);
+typedef void (*FhatComputer)(const int, const int, const int, const int,
+        const int, const int [restrict], const Node *const, const Model *,
+        Real [restrict]);
 /****************************************************************************
  * Static Function Declarations
  ****************************************************************************/
+static void CharacteristicWENO(const int, const int, const int, const int,
+        const int, const int [restrict], const Node *const, const Model *,
+        Real [restrict]);
 static void CharacteristicVariable(const int, const int, const int, const int,
         const int, const int, const int, const int [restrict], const Node *const,
         Real [restrict][DIMU], Real [restrict][DIMU]);
@@ -42,29 +49,48 @@ static void InverseProjection(Real [restrict][DIMU], const Real [restrict],
 static FhatReconstructor ReconstructFhat[2] = {
     WENO3,
     WENO5};
+static FhatComputer ComputeInterfaceFlux[3] = {
+    CharacteristicWENO,
+    CharacteristicWENO,
+    HLLC};
 /****************************************************************************
  * Function definitions
  ****************************************************************************/
 void ComputeFhat(const int tn, const int s, const int k, const int j, const int i,
         const int partn[restrict], const Node *const node, const Model *model, Real Fhat[restrict])
 {
-    const int h[DIMS][DIMS] = {{1, 0, 0}, {0, 1, 0}, {0, 0, 1}}; /* direction indicator */
+    ComputeInterfaceFlux[model->sScheme](tn, s, k, j, i, partn, node, model, Fhat);
+    return;
+}
+static void CharacteristicWENO(const int tn, const int s, const int k, const int j, const int i,
+        const int partn[restrict], const Node *const node, const Model *model, Real Fhat[restrict])
+{
+    int st[DIMS] = {0}; /* index strides */
+    IndexStride(partn, st);
     const int idxL = IndexNode(k, j, i, partn[Y], partn[X]);
-    const int idxR = IndexNode(k + h[s][Z], j + h[s][Y], i + h[s][X], partn[Y], partn[X]);
+    const int idxR = idxL + st[s];
     /* evaluate interface values by averaging */
     Real Uo[DIMUo]; /* store averaged primitives */
-    SymmetricAverage(model->jacobMean, model->gamma, node[idxL].U[tn], node[idxR].U[tn], Uo);
+    const Real gamma = SymmetricAverage(model->jacobMean, model, node[idxL].U[tn], node[idxR].U[tn], Uo);
     /* decompose Jacobian matrix */
     Real Lambda[DIMU]; /* eigenvalues */
     Real L[DIMU][DIMU]; /* vector space {Ln} */
     Real R[DIMU][DIMU]; /* vector space {Rn} */
-    Eigenvalue(s, Uo, Lambda);
-    EigenvectorL(s, model->gamma, Uo, L);
+    int splitter = model->fluxSplit; /* flux vector splitting method */
+    EigenvectorL(s, gamma, Uo, L);
     EigenvectorR(s, Uo, R);
+    if (0.0 < model->pcCut) { /* low Mach preconditioned eigensystem */
+        const Real beta2 = PreconditionParameter(model->pcCut, Uo);
+        PreconditionedEigenvalue(s, beta2, Uo, Lambda);
+        PreconditionEigenvector(s, beta2, Uo, Lambda, L, R);
+        splitter = (0 == splitter) ? PRECONLLF : splitter;
+    } else {
+        Eigenvalue(s, Uo, Lambda);
+    }
     /* flux vector splitting */
     Real LambdaP[DIMU]; /* eigenvalues */
     Real LambdaN[DIMU]; /* eigenvalues */
-    EigenvalueSplitting(model->fluxSplit, Lambda, LambdaP, LambdaN);
+    EigenvalueSplitting(splitter, Lambda, LambdaP, LambdaN);
     /* construct local characteristic variables for all potential stencils */
     Real W[FTN][DIMU];
     CharacteristicVariable(tn, s, k, j, i, model->sL, model->sR, partn, node, L, W);
@@ -86,12 +112,12 @@ static void CharacteristicVariable(const int tn, const int s, const int k, const
         const int i, const int sL, const int sR, const int partn[restrict],
         const Node *const node, Real L[restrict][DIMU], Real W[restrict][DIMU])
 {
-    const int h[DIMS][DIMS] = {{1, 0, 0}, {0, 1, 0}, {0, 0, 1}}; /* direction indicator */
-    int idx = 0; /* linear array index math variable */
+    int st[DIMS] = {0}; /* index strides */
+    IndexStride(partn, st);
+    const int idx = IndexNode(k, j, i, partn[Y], partn[X]);
     const Real *restrict U = NULL;
     for (int n = sL, m = 0; n <= sR; ++n, ++m) {
-        idx = IndexNode(k + n * h[s][Z], j + n * h[s][Y], i + n * h[s][X], partn[Y], partn[X]);
-        U = node[idx].U[tn];
+        U = node[idx + n * st[s]].U[tn];
         for (int r = 0; r < DIMU; ++r) {
             W[m][r] = 0.0;
             for (int c = 0; c < DIMU; ++c) {
@@ -0,0 +1,154 @@
+/****************************************************************************
+ *                              ArtraCFD                                    *
+ *                          <By Huangrui Mo>                                *
+ * Copyright (C) Huangrui Mo <huangrui.mo@gmail.com>                        *
+ * This file is part of ArtraCFD.                                           *
+ * ArtraCFD is free software: you can redistribute it and/or modify it      *
+ * under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or        *
+ * (at your option) any later version.                                      *
+ ****************************************************************************/
+/****************************************************************************
+ * Required Header Files
+ ****************************************************************************/
+#include "convergence.h"
+#include <stdio.h> /* standard library for input and output */
+#include <string.h> /* manipulating strings */
+#include <math.h> /* common mathematical functions */
+#include <float.h> /* size of floating point values */
+#include "solid_dynamics.h"
+#include "cfd_commons.h"
+#include "commons.h"
+/****************************************************************************
+ * Data Structure Declarations
+ ****************************************************************************/
+/****************************************************************************
+ * Function definitions
+ ****************************************************************************/
+void MarkMonitor(const Time *time, const Space *space, Monitor *mt)
+{
+    if (0 != time->stepC % time->cvgW) {
+        return;
+    }
+    const Partition *const part = &(space->part);
+    const Node *const node = space->node;
+    int idx = 0; /* linear array index math variable */
+    if (NULL == mt->U) {
+        mt->U = AssignStorage(part->n[Z] * part->n[Y] * part->n[X] * sizeof(*mt->U));
+        mt->F = AssignStorage(MaxInt(time->cvgB, 1) * sizeof(*mt->F));
+    }
+    for (int k = part->ns[PIN][Z][MIN]; k < part->ns[PIN][Z][MAX]; ++k) {
+        for (int j = part->ns[PIN][Y][MIN]; j < part->ns[PIN][Y][MAX]; ++j) {
+            for (int i = part->ns[PIN][X][MIN]; i < part->ns[PIN][X][MAX]; ++i) {
+                idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
+                memcpy(mt->U[idx], node[idx].U[TO], DIMU * sizeof(*mt->U[idx]));
+            }
+        }
+    }
+    return;
+}
+/*
+ * The residual of each conservative variable is normalized by its value
+ * at the first sample. The normalizer is bounded below by a fraction of
+ * the largest first sample residual, so variables resting at round-off
+ * level, such as the collapsed velocity component, do not stall the
+ * convergence. The force change of
+ * a body is measured relative to its total force magnitude, and is taken
+ * as unconverged at the first sample as there is no earlier reference.
+ */
+int CheckConvergence(const Real dt, const Time *time, Space *space, const Model *model,
+        Monitor *mt)
+{
+    if (0 != time->stepC % time->cvgW) {
+        return 0;
+    }
+    const Partition *const part = &(space->part);
+    const Node *const node = space->node;
+    const Geometry *const geo = &(space->geo);
+    const Polyhedron *poly = NULL;
+    const Real zero = 0.0;
+    int idx = 0; /* linear array index math variable */
+    int count = 0; /* number of fluid nodes */
+    Real L2[DIMU] = {zero}; /* L2 norms of dU/dt */
+    Real Linf[DIMU] = {zero}; /* Linf norms of dU/dt */
+    Real L2max = zero; /* maximum L2 norm of the first sample */
+    const Real least = 1.0e-6; /* least normalizer relative to L2max */
+    Real res = zero; /* maximum normalized residual */
+    Real dF = zero; /* maximum relative force change */
+    Real dU = zero;
+    RealVec F = {zero}; /* total force */
+    RealVec dFv = {zero}; /* total force change */
+    for (int k = part->ns[PIN][Z][MIN]; k < part->ns[PIN][Z][MAX]; ++k) {
+        for (int j = part->ns[PIN][Y][MIN]; j < part->ns[PIN][Y][MAX]; ++j) {
+            for (int i = part->ns[PIN][X][MIN]; i < part->ns[PIN][X][MAX]; ++i) {
+                idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
+                if (0 != node[idx].did) {
+                    continue;
+                }
+                ++count;
+                for (int dim = 0; dim < DIMU; ++dim) {
+                    dU = fabs(node[idx].U[TO][dim] - mt->U[idx][dim]) / dt;
+                    L2[dim] = L2[dim] + dU * dU;
+                    Linf[dim] = MaxReal(Linf[dim], dU);
+                }
+            }
+        }
+    }
+    for (int dim = 0; dim < DIMU; ++dim) {
+        L2[dim] = sqrt(L2[dim] / (Real)MaxInt(count, 1));
+        if (0 == mt->sampleN) {
+            mt->L2o[dim] = L2[dim];
+            L2max = MaxReal(L2max, L2[dim]);
+        }
+    }
+    if (0 == mt->sampleN) {
+        for (int dim = 0; dim < DIMU; ++dim) {
+            mt->L2o[dim] = MaxReal(mt->L2o[dim], least * L2max);
+        }
+    }
+    for (int dim = 0; dim < DIMU; ++dim) {
+        if (zero < mt->L2o[dim]) {
+            res = MaxReal(res, L2[dim] / mt->L2o[dim]);
+        }
+    }
+    if (0 < time->cvgB) {
+        IntegrateSurfaceForce(space, model);
+    }
+    for (int n = 0; n < time->cvgB; ++n) {
+        poly = geo->poly + geo->pos[time->cvgId[n] - 1];
+        for (int s = 0; s < DIMS; ++s) {
+            F[s] = poly->Fp[s] + poly->Fv[s];
+        }
+        for (int s = 0; s < DIMS; ++s) {
+            dFv[s] = F[s] - mt->F[n][s];
+        }
+        dF = (0 == mt->sampleN) ? 1.0 : MaxReal(dF, Norm(dFv) / MaxReal(Norm(F), FLT_MIN));
+        memcpy(mt->F[n], F, DIMS * sizeof(*F));
+    }
+    if (0 == time->mute) {
+        FILE *fp = Fopen("convergence.csv", "a");
+        if ((0 == mt->sampleN) && (0 == time->restart)) {
+            fprintf(fp, "# step, time, L2 rho, rho_u, rho_v, rho_w, rho_eT, Linf rho, rho_u, rho_v, rho_w, rho_eT, residual, force change\n");
+        }
+        fprintf(fp, "%d, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g\n",
+                time->stepC, time->now, L2[0], L2[1], L2[2], L2[3], L2[4],
+                Linf[0], Linf[1], Linf[2], Linf[3], Linf[4], res, dF);
+        fclose(fp);
+    }
+    ShowInfo("  residual: %.6g; force change: %.6g\n", res, dF);
+    ++mt->sampleN;
+    if ((time->cvgTol[0] > res) && (time->cvgTol[1] >= dF) && (1 < mt->sampleN)) {
+        ++mt->passN;
+    } else {
+        mt->passN = 0;
+    }
+    return (time->cvgN <= mt->passN) ? 1 : 0;
+}
+void FinalizeMonitor(Monitor *mt)
+{
+    RetrieveStorage(mt->U);
+    RetrieveStorage(mt->F);
+    memset(mt, 0, sizeof(*mt)); /* ready for another run */
+    return;
+}
+/* a good practice: end file with a newline */
@@ -0,0 +1,63 @@
+/****************************************************************************
+ *                              ArtraCFD                                    *
+ *                          <By Huangrui Mo>                                *
+ * Copyright (C) Huangrui Mo <huangrui.mo@gmail.com>                        *
+ * This file is part of ArtraCFD.                                           *
+ * ArtraCFD is free software: you can redistribute it and/or modify it      *
+ * under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or        *
+ * (at your option) any later version.                                      *
+ ****************************************************************************/
+/****************************************************************************
+ * Header File Guards to Avoid Interdependence
+ ****************************************************************************/
+#ifndef ARTRACFD_CONVERGENCE_H_ /* if undefined */
+#define ARTRACFD_CONVERGENCE_H_ /* set a unique marker */
+/****************************************************************************
+ * Required Header Files
+ ****************************************************************************/
+#include "commons.h"
+/****************************************************************************
+ * Data Structure Declarations
+ ****************************************************************************/
+typedef struct {
+    int sampleN; /* number of samples taken */
+    int passN; /* number of consecutive converged samples */
+    Real L2o[DIMU]; /* residual L2 norms of the first sample */
+    Real (*restrict U)[DIMU]; /* field data at the start of a sampling step */
+    RealVec *restrict F; /* total force of monitored bodies at the last sample */
+} Monitor; /* convergence monitor carried across steps */
+/****************************************************************************
+ * Public Functions Declaration
+ ****************************************************************************/
+/*
+ * Convergence monitor marking
+ *
+ * Function
+ *      Keep a copy of the conservative field at the start of a sampling
+ *      step. Steps that are not sampling steps are ignored.
+ */
+extern void MarkMonitor(const Time *, const Space *, Monitor *);
+/*
+ * Steady state convergence check
+ *
+ * Function
+ *      At the end of a sampling step, compute the L2 and Linf norms of
+ *      dU/dt for each conservative variable and the relative change of
+ *      the total force on the monitored bodies, and record them.
+ *
+ * Returns
+ *      1 -- the residual and force tolerances have held for the required
+ *           number of consecutive samples
+ *      0 -- not converged or not a sampling step
+ */
+extern int CheckConvergence(const Real dt, const Time *, Space *, const Model *, Monitor *);
+/*
+ * Convergence monitor finalization
+ *
+ * Function
+ *      Release the storage of the monitor.
+ */
+extern void FinalizeMonitor(Monitor *);
+#endif
+/* a good practice: end file with a newline */
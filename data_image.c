@@ -0,0 +1,313 @@
+/****************************************************************************
+ *                              ArtraCFD                                    *
+ *                          <By Huangrui Mo>                                *
+ * Copyright (C) Huangrui Mo <huangrui.mo@gmail.com>                        *
+ * This file is part of ArtraCFD.                                           *
+ * ArtraCFD is free software: you can redistribute it and/or modify it      *
+ * under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or        *
+ * (at your option) any later version.                                      *
+ ****************************************************************************/
+/****************************************************************************
+ * Required Header Files
+ ****************************************************************************/
+#include "data_image.h"
+#include <stdio.h> /* standard library for input and output */
+#include <stdint.h> /* fixed width integer types */
+#include <math.h> /* common mathematical functions */
+#include "cfd_commons.h"
+#include "commons.h"
+/****************************************************************************
+ * Static Function Declarations
+ ****************************************************************************/
+static void ExtractSlice(const int, const int, const int, int [restrict][LIMIT],
+        const Space *, const Model *, Real [restrict]);
+static Real DensityGradient(const int, const int, const int, int [restrict][LIMIT],
+        const Partition *, const Node *);
+static void MapColor(const int, const Real, unsigned char [restrict]);
+static void WritePng(const char *, const int, const int, const unsigned char *);
+static void WritePngChunk(FILE *, const char *, const unsigned char *, const size_t,
+        const uint32_t [restrict]);
+static void WritePfm(const char *, const int, const int, const Real *);
+static void PutUint32(unsigned char [restrict], const uint32_t);
+/****************************************************************************
+ * Global Variables Definition with Private Scope
+ ****************************************************************************/
+static const char *const imgVar[4] = {"rho", "p", "schlieren", "did"};
+/****************************************************************************
+ * Function definitions
+ ****************************************************************************/
+void WriteSliceImageData(const Time *time, const Space *space, const Model *model)
+{
+    if (0 == time->imgN) {
+        return;
+    }
+    String fname = {'\0'};
+    const Partition *const part = &(space->part);
+    const RealVec sMin = {part->domain[X][MIN], part->domain[Y][MIN], part->domain[Z][MIN]};
+    const RealVec dd = {part->dd[X], part->dd[Y], part->dd[Z]};
+    const IntVec ng = {part->ng[X], part->ng[Y], part->ng[Z]};
+    int box[DIMS][LIMIT] = {{0}}; /* physical node range */
+    int a = 0, u = 0, v = 0; /* normal and in-plane axes */
+    int var = 0; /* sliced variable */
+    int w = 0, h = 0; /* image width and height */
+    int slice = 0; /* node layer of slice */
+    Real *val = NULL; /* sliced values */
+    unsigned char *rgb = NULL; /* colour mapped pixels */
+    Real vMin = 0.0, vMax = 0.0; /* colour map range */
+    for (int s = 0; s < DIMS; ++s) {
+        box[s][MIN] = part->ns[PHY][s][MIN];
+        box[s][MAX] = part->ns[PHY][s][MAX];
+    }
+    for (int n = 0; n < time->imgN; ++n) {
+        a = (int)time->img[n][0];
+        u = (a + 1) % DIMS;
+        v = (a + 2) % DIMS;
+        var = (int)time->img[n][2];
+        w = box[u][MAX] - box[u][MIN];
+        h = box[v][MAX] - box[v][MIN];
+        slice = ConfineSpace(MapNode(time->img[n][1], sMin[a], dd[a], ng[a]), box[a][MIN], box[a][MAX]);
+        val = AssignStorage(w * h * sizeof(*val));
+        ExtractSlice(a, var, slice, box, space, model, val);
+        if (IMGPFM == time->imgF) {
+            snprintf(fname, sizeof(fname), "%s%03d_%s_%05d.pfm", "slice_", n + 1, imgVar[var], time->stepC);
+            WritePfm(fname, w, h, val);
+            RetrieveStorage(val);
+            continue;
+        }
+        /* colour map range is fixed if given, adaptive otherwise */
+        vMin = time->img[n][3];
+        vMax = time->img[n][4];
+        if (vMin >= vMax) {
+            vMin = val[0];
+            vMax = val[0];
+            for (int m = 1; m < w * h; ++m) {
+                vMin = MinReal(vMin, val[m]);
+                vMax = MaxReal(vMax, val[m]);
+            }
+        }
+        rgb = AssignStorage(3 * w * h * sizeof(*rgb));
+        for (int m = 0; m < w * h; ++m) {
+            MapColor(var, (vMax > vMin) ? (val[m] - vMin) / (vMax - vMin) : 0.0, rgb + 3 * m);
+        }
+        snprintf(fname, sizeof(fname), "%s%03d_%s_%05d.png", "slice_", n + 1, imgVar[var], time->stepC);
+        WritePng(fname, w, h, rgb);
+        RetrieveStorage(rgb);
+        RetrieveStorage(val);
+    }
+    return;
+}
+/*
+ * Values are stored row by row with the first in-plane axis running
+ * fastest and rows ordered from the top of the image, that is, from
+ * the maximum of the second in-plane axis. The in-plane axes follow
+ * the normal axis cyclically to keep the slices right-handed.
+ */
+static void ExtractSlice(const int a, const int var, const int slice, int box[restrict][LIMIT],
+        const Space *space, const Model *model, Real val[restrict])
+{
+    const Partition *const part = &(space->part);
+    const Node *const node = space->node;
+    const int u = (a + 1) % DIMS;
+    const int v = (a + 2) % DIMS;
+    const int w = box[u][MAX] - box[u][MIN];
+    const Real zero = 0.0;
+    const Real ks = 10.0; /* schlieren amplification */
+    IntVec ijk = {0}; /* node index */
+    int idx = 0; /* linear array index math variable */
+    int m = 0; /* pixel index */
+    Real Uo[DIMUo] = {0.0};
+    Real gMax = zero; /* maximum density gradient */
+    ijk[a] = slice;
+    for (int r = box[v][MAX] - 1; r >= box[v][MIN]; --r) {
+        ijk[v] = r;
+        for (int c = box[u][MIN]; c < box[u][MAX]; ++c) {
+            ijk[u] = c;
+            idx = IndexNode(ijk[Z], ijk[Y], ijk[X], part->n[Y], part->n[X]);
+            m = (box[v][MAX] - 1 - r) * w + c - box[u][MIN];
+            switch (var) {
+                case IMGRHO:
+                    MapPrimitive(model, node[idx].U[TO], Uo);
+                    val[m] = Uo[0];
+                    break;
+                case IMGP:
+                    MapPrimitive(model, node[idx].U[TO], Uo);
+                    val[m] = Uo[4];
+                    break;
+                case IMGSCH:
+                    val[m] = DensityGradient(ijk[Z], ijk[Y], ijk[X], box, part, node);
+                    gMax = MaxReal(gMax, val[m]);
+                    break;
+                default: /* geometry identifier in input order */
+                    val[m] = (0 < node[idx].did) ? space->geo.poly[node[idx].did-1].pid : node[idx].did;
+                    break;
+            }
+        }
+    }
+    /* numerical schlieren: exp(-k |grad(rho)| / max|grad(rho)|) */
+    if (IMGSCH == var) {
+        for (m = 0; m < w * (box[v][MAX] - box[v][MIN]); ++m) {
+            val[m] = (zero < gMax) ? exp(-ks * val[m] / gMax) : 1.0;
+        }
+    }
+    return;
+}
+/*
+ * Central differences are used at inner nodes and one-sided differences
+ * at domain boundaries, so only physical nodes are referenced.
+ */
+static Real DensityGradient(const int k, const int j, const int i, int box[restrict][LIMIT],
+        const Partition *part, const Node *node)
+{
+    const IntVec n = {i, j, k};
+    IntVec nL = {0}; /* left neighbour */
+    IntVec nR = {0}; /* right neighbour */
+    Real g = 0.0; /* squared gradient magnitude */
+    Real dr = 0.0; /* density difference */
+    for (int s = 0; s < DIMS; ++s) {
+        for (int r = 0; r < DIMS; ++r) {
+            nL[r] = n[r];
+            nR[r] = n[r];
+        }
+        nL[s] = MaxInt(n[s] - 1, box[s][MIN]);
+        nR[s] = MinInt(n[s] + 1, box[s][MAX] - 1);
+        if (nL[s] == nR[s]) {
+            continue;
+        }
+        dr = (node[IndexNode(nR[Z], nR[Y], nR[X], part->n[Y], part->n[X])].U[TO][0] -
+                node[IndexNode(nL[Z], nL[Y], nL[X], part->n[Y], part->n[X])].U[TO][0]) *
+            part->dd[s] / (Real)(nR[s] - nL[s]);
+        g = g + dr * dr;
+    }
+    return sqrt(g);
+}
+/*
+ * Schlieren images use a grey scale from dark (strong gradient) to
+ * white; other variables use a blue-cyan-yellow-red rainbow map.
+ */
+static void MapColor(const int var, const Real f, unsigned char rgb[restrict])
+{
+    const Real t = MinReal(MaxReal(f, 0.0), 1.0);
+    if (IMGSCH == var) {
+        rgb[0] = (unsigned char)(255.0 * t + 0.5);
+        rgb[1] = rgb[0];
+        rgb[2] = rgb[0];
+        return;
+    }
+    rgb[0] = (unsigned char)(255.0 * MinReal(MaxReal(1.5 - fabs(4.0 * t - 3.0), 0.0), 1.0) + 0.5);
+    rgb[1] = (unsigned char)(255.0 * MinReal(MaxReal(1.5 - fabs(4.0 * t - 2.0), 0.0), 1.0) + 0.5);
+    rgb[2] = (unsigned char)(255.0 * MinReal(MaxReal(1.5 - fabs(4.0 * t - 1.0), 0.0), 1.0) + 0.5);
+    return;
+}
+/*
+ * The image data is wrapped in a zlib stream of stored deflate blocks.
+ * Skipping compression keeps the writer dependency free and its cost at
+ * a single pass over the pixels; slices are small compared with a full
+ * field dump in either case.
+ */
+static void WritePng(const char *fname, const int w, const int h, const unsigned char *rgb)
+{
+    const unsigned char signature[8] = {137, 80, 78, 71, 13, 10, 26, 10};
+    const size_t rowN = 1 + 3 * (size_t)w; /* filter byte and pixels */
+    const size_t rawN = rowN * (size_t)h;
+    const size_t blockMax = 65535; /* maximum length of a stored block */
+    const size_t blockN = (rawN + blockMax - 1) / blockMax;
+    const size_t zN = 2 + rawN + 5 * blockN + 4;
+    unsigned char *z = AssignStorage(zN * sizeof(*z));
+    unsigned char ihdr[13] = {0};
+    uint32_t crcTab[256] = {0};
+    uint32_t c = 0; /* crc table entry */
+    uint32_t s1 = 1, s2 = 0; /* adler checksum sums */
+    size_t pos = 0; /* position in zlib stream */
+    size_t raw = 0; /* position in raw image data */
+    size_t len = 0; /* length of current block */
+    unsigned char byte = 0;
+    for (uint32_t n = 0; n < 256; ++n) {
+        c = n;
+        for (int k = 0; k < 8; ++k) {
+            c = (c & 1) ? (0xEDB88320u ^ (c >> 1)) : (c >> 1);
+        }
+        crcTab[n] = c;
+    }
+    z[pos++] = 0x78; /* deflate with 32K window */
+    z[pos++] = 0x01; /* no preset dictionary, fastest level */
+    while (raw < rawN) {
+        len = (rawN - raw < blockMax) ? (rawN - raw) : blockMax;
+        z[pos++] = (raw + len == rawN) ? 1 : 0; /* final block flag, stored type */
+        z[pos++] = (unsigned char)(len & 0xFF);
+        z[pos++] = (unsigned char)(len >> 8);
+        z[pos++] = (unsigned char)(~len & 0xFF);
+        z[pos++] = (unsigned char)((~len >> 8) & 0xFF);
+        for (size_t m = raw; m < raw + len; ++m) {
+            /* each row starts with filter type none */
+            byte = (0 == m % rowN) ? 0 : rgb[(m / rowN) * 3 * (size_t)w + m % rowN - 1];
+            z[pos++] = byte;
+            s1 = (s1 + byte) % 65521;
+            s2 = (s2 + s1) % 65521;
+        }
+        raw = raw + len;
+    }
+    PutUint32(z + pos, (s2 << 16) | s1);
+    PutUint32(ihdr, (uint32_t)w);
+    PutUint32(ihdr + 4, (uint32_t)h);
+    ihdr[8] = 8; /* bit depth */
+    ihdr[9] = 2; /* truecolour */
+    FILE *fp = Fopen(fname, "wb");
+    fwrite(signature, sizeof(signature), 1, fp);
+    WritePngChunk(fp, "IHDR", ihdr, sizeof(ihdr), crcTab);
+    WritePngChunk(fp, "IDAT", z, zN, crcTab);
+    WritePngChunk(fp, "IEND", NULL, 0, crcTab);
+    fclose(fp);
+    RetrieveStorage(z);
+    return;
+}
+static void WritePngChunk(FILE *fp, const char *type, const unsigned char *data, const size_t n,
+        const uint32_t crcTab[restrict])
+{
+    unsigned char word[4] = {0};
+    uint32_t crc = 0xFFFFFFFFu;
+    for (int m = 0; m < 4; ++m) {
+        crc = crcTab[(crc ^ (unsigned char)type[m]) & 0xFF] ^ (crc >> 8);
+    }
+    for (size_t m = 0; m < n; ++m) {
+        crc = crcTab[(crc ^ data[m]) & 0xFF] ^ (crc >> 8);
+    }
+    PutUint32(word, (uint32_t)n);
+    fwrite(word, sizeof(word), 1, fp);
+    fwrite(type, 1, 4, fp);
+    if (0 < n) {
+        fwrite(data, n, 1, fp);
+    }
+    PutUint32(word, crc ^ 0xFFFFFFFFu);
+    fwrite(word, sizeof(word), 1, fp);
+    return;
+}
+/*
+ * Portable float map: a short text header followed by single precision
+ * values in host byte order, declared by the sign of the scale (negative
+ * for little endian), with rows ordered from the bottom.
+ */
+static void WritePfm(const char *fname, const int w, const int h, const Real *val)
+{
+    float *row = AssignStorage(w * sizeof(*row));
+    FILE *fp = Fopen(fname, "wb");
+    fprintf(fp, "Pf\n%d %d\n%s\n", w, h, BigEndian() ? "1.0" : "-1.0");
+    for (int r = h - 1; r >= 0; --r) {
+        for (int c = 0; c < w; ++c) {
+            row[c] = (float)val[r * w + c];
+        }
+        fwrite(row, sizeof(*row), w, fp);
+    }
+    fclose(fp);
+    RetrieveStorage(row);
+    return;
+}
+static void PutUint32(unsigned char byte[restrict], const uint32_t n)
+{
+    byte[0] = (unsigned char)(n >> 24);
+    byte[1] = (unsigned char)(n >> 16);
+    byte[2] = (unsigned char)(n >> 8);
+    byte[3] = (unsigned char)n;
+    return;
+}
+/* a good practice: end file with a newline */
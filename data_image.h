@@ -0,0 +1,36 @@
+/****************************************************************************
+ *                              ArtraCFD                                    *
+ *                          <By Huangrui Mo>                                *
+ * Copyright (C) Huangrui Mo <huangrui.mo@gmail.com>                        *
+ * This file is part of ArtraCFD.                                           *
+ * ArtraCFD is free software: you can redistribute it and/or modify it      *
+ * under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or        *
+ * (at your option) any later version.                                      *
+ ****************************************************************************/
+/****************************************************************************
+ * Header File Guards to Avoid Interdependence
+ ****************************************************************************/
+#ifndef ARTRACFD_DATA_IMAGE_H_ /* if undefined */
+#define ARTRACFD_DATA_IMAGE_H_ /* set a unique marker */
+/****************************************************************************
+ * Required Header Files
+ ****************************************************************************/
+#include "commons.h"
+/****************************************************************************
+ * Data Structure Declarations
+ ****************************************************************************/
+/****************************************************************************
+ * Public Functions Declaration
+ ****************************************************************************/
+/*
+ * Slice image output
+ *
+ * Function
+ *      Extract each configured axis-aligned slice of density, pressure,
+ *      numerical schlieren, or geometry identifier, and write it as a
+ *      colour mapped PNG image or a portable float map indexed by step.
+ */
+extern void WriteSliceImageData(const Time *, const Space *, const Model *);
+#endif
+/* a good practice: end file with a newline */
@@ -14,9 +14,16 @@
 #include "data_probe.h"
 #include <stdio.h> /* standard library for input and output */
 #include <stdlib.h> /* support for abs operation */
+#include <math.h> /* common mathematical functions */
 #include "computational_geometry.h"
+#include "immersed_boundary.h"
 #include "cfd_commons.h"
 #include "commons.h"
+/****************************************************************************
+ * Static Function Declarations
+ ****************************************************************************/
+static int SphereRings(const Real, const Real);
+static void SphereSample(const int, const int, const int, const int, Real [restrict]);
 /****************************************************************************
  * Function definitions
  ****************************************************************************/
@@ -51,7 +58,7 @@ void WritePointProbeData(const Time *time, const Space *space, const Model *mode
         j = ConfineSpace(MapNode(p1[Y], sMin[Y], dd[Y], ng[Y]), nMin[Y], nMax[Y]);
         k = ConfineSpace(MapNode(p1[Z], sMin[Z], dd[Z], ng[Z]), nMin[Z], nMax[Z]);
         idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
-        MapPrimitive(model->gamma, model->gasR, node[idx].U[TO], Uo);
+        MapPrimitive(model, node[idx].U[TO], Uo);
         fprintf(fp, "%.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g\n",
                 time->now, Uo[0], Uo[1], Uo[2], Uo[3], Uo[4], Uo[5]);
         fclose(fp);
@@ -108,7 +115,7 @@ void WriteLineProbeData(const Time *time, const Space *space, const Model *model
             p2[X] = MapPoint(i, sMin[X], d[X], ng[X]);
             p2[Y] = MapPoint(j, sMin[Y], d[Y], ng[Y]);
             p2[Z] = MapPoint(k, sMin[Z], d[Z], ng[Z]);
-            MapPrimitive(model->gamma, model->gasR, node[idx].U[TO], Uo);
+            MapPrimitive(model, node[idx].U[TO], Uo);
             fprintf(fp, "%.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g\n",
                     p2[X], p2[Y], p2[Z], Uo[0], Uo[1], Uo[2], Uo[3], Uo[4], Uo[5]);
         }
@@ -118,7 +125,7 @@ void WriteLineProbeData(const Time *time, const Space *space, const Model *model
 }
 void WriteCurveProbeData(const Time *time, const Space *space, const Model *model)
 {
-    if (0 == time->dataN[PROCV]) {
+    if (CURVEGHOST != time->dataN[PROCV]) {
         return;
     }
     FILE *fp = NULL;
@@ -141,7 +148,7 @@ void WriteCurveProbeData(const Time *time, const Space *space, const Model *mode
     RealVec N = {0.0}; /* normal */
     int box[DIMS][LIMIT] = {{0}}; /* bounding box in node space */
     for (int n = 0; n < geo->totN; ++n) {
-        poly = geo->poly + n;
+        poly = geo->poly + geo->pos[n];
         snprintf(fname, sizeof(fname), "%s%03d_%05d.csv", "curve_probe_", n + 1, time->stepC);
         fp = Fopen(fname, "w");
         fprintf(fp, "# x, y, z, Nx, Ny, Nz, rho, u, v, w, p, T <time=%.6g>\n", time->now);
@@ -154,14 +161,14 @@ void WriteCurveProbeData(const Time *time, const Space *space, const Model *mode
             for (int j = box[Y][MIN]; j < box[Y][MAX]; ++j) {
                 for (int i = box[X][MIN]; i < box[X][MAX]; ++i) {
                     idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
-                    if ((1 != node[idx].gst) || (n + 1 != node[idx].did)) {
+                    if ((1 != node[idx].gst) || (geo->pos[n] + 1 != node[idx].did)) {
                         continue;
                     }
                     pG[X] = MapPoint(i, sMin[X], d[X], ng[X]);
                     pG[Y] = MapPoint(j, sMin[Y], d[Y], ng[Y]);
                     pG[Z] = MapPoint(k, sMin[Z], d[Z], ng[Z]);
                     ComputeGeometricData(pG, node[idx].fid, poly, pO, pI, N);
-                    MapPrimitive(model->gamma, model->gasR, node[idx].U[TO], Uo);
+                    MapPrimitive(model, node[idx].U[TO], Uo);
                     fprintf(fp, "%.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g\n",
                             pO[X], pO[Y], pO[Z], N[X], N[Y], N[Z], Uo[0], Uo[1], Uo[2], Uo[3], Uo[4], Uo[5]);
                 }
@@ -181,7 +188,7 @@ void WriteSurfaceForceData(const Time *time, const Space *space, const Model *mo
     const Geometry *const geo = &(space->geo);
     const Polyhedron *poly = NULL;
     for (int n = 0; n < geo->totN; ++n) {
-        poly = geo->poly + n;
+        poly = geo->poly + geo->pos[n];
         snprintf(fname, sizeof(fname), "%s%03d.csv", "surface_force_", n + 1);
         fp = Fopen(fname, "a");
         if (0 == time->stepC) { /* initialization step */
@@ -195,5 +202,126 @@ void WriteSurfaceForceData(const Time *time, const Space *space, const Model *mo
     }
     return;
 }
+/*
+ * The surface field samples each triangulated geometry at its facet
+ * centroids and each analytical sphere at cell centred points of a
+ * latitude-longitude parametrization, or of a circle if a dimension
+ * is collapsed. Sphere samples lead the point list as vertex cells,
+ * followed by the vertices and facets of triangulated geometries.
+ * Samples outside the physical domain carry zero data and a zero id.
+ */
+void ComputeSurfaceField(const Space *space, const Model *model, Surface *surf)
+{
+    const Partition *const part = &(space->part);
+    const Node *const node = space->node;
+    const Geometry *const geo = &(space->geo);
+    const Polyhedron *poly = NULL;
+    const Real h = MinReal(part->d[X], MinReal(part->d[Y], part->d[Z])); /* sample spacing */
+    const int axis = ((COLLAPSEX <= part->collapse) && (COLLAPSEZ >= part->collapse)) ?
+        part->collapse - COLLAPSEX : -1; /* collapsed dimension of a planar problem */
+    Real UoO[DIMUo] = {0.0};
+    RealVec tau = {0.0}; /* wall shear stress */
+    RealVec pO = {0.0}; /* boundary point */
+    RealVec N = {0.0}; /* normal */
+    int ringN = 0; /* parametrization rings of a sphere */
+    int ptN = 0; /* point count */
+    int cellN = 0; /* cell count */
+    int skip = 0; /* sample outside the physical domain */
+    /* count points and cells */
+    surf->vertN = 0;
+    surf->faceN = 0;
+    surf->pointN = 0;
+    for (int n = 0; n < geo->totN; ++n) {
+        poly = geo->poly + geo->pos[n];
+        if (0 < poly->faceN) {
+            surf->faceN = surf->faceN + poly->faceN;
+            surf->pointN = surf->pointN + poly->vertN;
+            continue;
+        }
+        ringN = SphereRings(poly->r, h);
+        surf->vertN = surf->vertN + ((0 > axis) ? 2 * ringN * ringN : 2 * ringN);
+    }
+    surf->pointN = surf->pointN + surf->vertN;
+    surf->v = AssignStorage(surf->pointN * sizeof(*surf->v));
+    surf->f = NULL;
+    if (0 < surf->faceN) {
+        surf->f = AssignStorage(surf->faceN * sizeof(*surf->f));
+    }
+    surf->data = AssignStorage((surf->vertN + surf->faceN) * sizeof(*surf->data));
+    /* analytical spheres */
+    for (int n = 0; n < geo->sphN; ++n) {
+        poly = geo->poly + geo->pos[n];
+        ringN = SphereRings(poly->r, h);
+        for (int m = 0; m < ((0 > axis) ? ringN : 1); ++m) {
+            for (int l = 0; l < 2 * ringN; ++l) {
+                SphereSample(axis, ringN, m, l, N);
+                for (int s = 0; s < DIMS; ++s) {
+                    pO[s] = poly->O[s] + poly->r * N[s];
+                    surf->v[ptN][s] = pO[s];
+                }
+                skip = ComputeSurfaceData(TO, pO, N, poly, part, node, model, UoO, tau);
+                surf->data[cellN][0] = UoO[4];
+                surf->data[cellN][1] = UoO[5];
+                surf->data[cellN][2] = tau[X];
+                surf->data[cellN][3] = tau[Y];
+                surf->data[cellN][4] = tau[Z];
+                surf->data[cellN][5] = (0 == skip) ? n + 1 : 0;
+                ++ptN;
+                ++cellN;
+            }
+        }
+    }
+    /* triangulated polyhedrons */
+    for (int n = geo->sphN; n < geo->totN; ++n) {
+        poly = geo->poly + geo->pos[n];
+        for (int m = 0; m < poly->faceN; ++m) {
+            for (int s = 0; s < DIMS; ++s) {
+                pO[s] = (poly->v[poly->f[m][0]][s] + poly->v[poly->f[m][1]][s] + poly->v[poly->f[m][2]][s]) / 3.0;
+                N[s] = poly->Nf[m][s];
+            }
+            for (int s = 0; s < POLYN; ++s) {
+                surf->f[cellN - surf->vertN][s] = ptN + poly->f[m][s];
+            }
+            skip = ComputeSurfaceData(TO, pO, N, poly, part, node, model, UoO, tau);
+            surf->data[cellN][0] = UoO[4];
+            surf->data[cellN][1] = UoO[5];
+            surf->data[cellN][2] = tau[X];
+            surf->data[cellN][3] = tau[Y];
+            surf->data[cellN][4] = tau[Z];
+            surf->data[cellN][5] = (0 == skip) ? n + 1 : 0;
+            ++cellN;
+        }
+        for (int m = 0; m < poly->vertN; ++m, ++ptN) {
+            for (int s = 0; s < DIMS; ++s) {
+                surf->v[ptN][s] = poly->v[m][s];
+            }
+        }
+    }
+    return;
+}
+static int SphereRings(const Real r, const Real h)
+{
+    return MinInt(MaxInt((int)ceil(PI * r / h), 2), SURFRING);
+}
+/*
+ * Normal of the sample at ring m and meridian l, with ringN rings of
+ * polar angle and 2 * ringN meridians of azimuth, or of the circle
+ * normal to the collapsed dimension axis.
+ */
+static void SphereSample(const int axis, const int ringN, const int m, const int l, Real N[restrict])
+{
+    const Real phi = PI * (l + 0.5) / ringN; /* azimuth */
+    if (0 <= axis) {
+        N[axis] = 0.0;
+        N[(axis + 1) % DIMS] = cos(phi);
+        N[(axis + 2) % DIMS] = sin(phi);
+        return;
+    }
+    const Real theta = PI * (m + 0.5) / ringN; /* polar angle */
+    N[X] = sin(theta) * cos(phi);
+    N[Y] = sin(theta) * sin(phi);
+    N[Z] = cos(theta);
+    return;
+}
 /* a good practice: end file with a newline */
 
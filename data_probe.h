@@ -27,6 +27,7 @@ extern void WritePointProbeData(const Time *, const Space *, const Model *);
 extern void WriteLineProbeData(const Time *, const Space *, const Model *);
 extern void WriteCurveProbeData(const Time *, const Space *, const Model *);
 extern void WriteSurfaceForceData(const Time *, const Space *, const Model *);
+extern void ComputeSurfaceField(const Space *, const Model *, Surface *);
 #endif
 /* a good practice: end file with a newline */
 
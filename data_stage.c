@@ -0,0 +1,301 @@
+/****************************************************************************
+ *                              ArtraCFD                                    *
+ *                          <By Huangrui Mo>                                *
+ * Copyright (C) Huangrui Mo <huangrui.mo@gmail.com>                        *
+ * This file is part of ArtraCFD.                                           *
+ * ArtraCFD is free software: you can redistribute it and/or modify it      *
+ * under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or        *
+ * (at your option) any later version.                                      *
+ ****************************************************************************/
+/****************************************************************************
+ * Required Header Files
+ ****************************************************************************/
+#define _POSIX_C_SOURCE 200809L /* expose POSIX threads and signals under -std=c99 */
+#include "data_stage.h"
+#include <stdio.h> /* standard library for input and output */
+#include <stdlib.h> /* dynamic memory allocation and exit */
+#include <string.h> /* manipulating strings */
+#include <signal.h> /* signal handling */
+#include <pthread.h> /* POSIX threads */
+#include <unistd.h> /* POSIX file access */
+#include <sys/stat.h> /* directory creation */
+#include "commons.h"
+/****************************************************************************
+ * Data Structure Declarations
+ ****************************************************************************/
+typedef enum {
+    QUEUEN = 256, /* capacity of the drain queue */
+    RANKN = 3, /* drain ranks: data, index, state log */
+} StageConst;
+struct Stage {
+    int stop; /* drain termination flag */
+    int head; /* count of drained queue entries */
+    int tail; /* count of queued entries */
+    int pendN; /* number of files written since the last commit */
+    String stage; /* local staging directory */
+    String drain; /* destination directory */
+    String queue[QUEUEN]; /* files waiting for draining */
+    String pend[QUEUEN]; /* files written since the last commit */
+    pthread_t tid; /* drain thread */
+    pthread_mutex_t lock; /* guard of the queue */
+    pthread_cond_t cond; /* queue state change */
+};
+/****************************************************************************
+ * Static Function Declarations
+ ****************************************************************************/
+static void *DrainStage(void *);
+static int CopyFile(const char *, const char *);
+static int InQueue(const Stage *, const char *);
+static void FormPath(char [], const char *, const char *);
+static int RankFile(const char *);
+static void CommitPending(Stage *);
+static void CatchSignal(int);
+/****************************************************************************
+ * Global Variables Definition with Private Scope
+ ****************************************************************************/
+static volatile sig_atomic_t signaled = 0;
+/****************************************************************************
+ * Function definitions
+ ****************************************************************************/
+void InitializeStage(const Time *time)
+{
+    FileTable *const files = BoundFileTable();
+    if ((0 != time->mute) || (NULL != files->stage) ||
+            ('\0' == time->stage[0]) || (0 == strcmp(time->stage, "none"))) {
+        return;
+    }
+    Stage *const sg = AssignStorage(sizeof(*sg));
+    FormPath(sg->stage, NULL, time->stage);
+    FormPath(sg->drain, NULL, ('\0' == time->drain[0]) ? "." : time->drain);
+    mkdir(sg->stage, 0755);
+    mkdir(sg->drain, 0755);
+    if ((0 != access(sg->stage, W_OK)) || (0 != access(sg->drain, W_OK))) {
+        ShowError("staging directories not writable: %s, %s", sg->stage, sg->drain);
+    }
+    pthread_mutex_init(&(sg->lock), NULL);
+    pthread_cond_init(&(sg->cond), NULL);
+    if (0 != pthread_create(&(sg->tid), NULL, DrainStage, sg)) {
+        ShowError("failed to start the drain thread");
+    }
+    files->stage = sg;
+    atexit(FinalizeStage);
+    struct sigaction act; /* checkpoint signal action */
+    memset(&act, 0, sizeof(act));
+    act.sa_handler = CatchSignal;
+    sigemptyset(&(act.sa_mask));
+    sigaction(SIGUSR1, &act, NULL);
+    return;
+}
+void StagePath(const char *fname, const char *mode, char path[])
+{
+    Stage *const sg = BoundFileTable()->stage;
+    if ((NULL == sg) || ('/' == fname[0])) {
+        FormPath(path, NULL, fname);
+        return;
+    }
+    String dest = {'\0'}; /* destination copy of the file */
+    FormPath(dest, sg->drain, fname);
+    if (('r' == mode[0]) && (NULL == strchr(mode, '+'))) { /* read only */
+        FormPath(path, NULL, (0 == access(dest, R_OK)) ? dest : fname);
+        return;
+    }
+    FormPath(path, sg->stage, fname);
+    pthread_mutex_lock(&(sg->lock));
+    while (InQueue(sg, fname)) { /* never modify a file under draining */
+        pthread_cond_wait(&(sg->cond), &(sg->lock));
+    }
+    if (('w' != mode[0]) && (0 != access(path, F_OK)) && (0 == access(dest, R_OK))) {
+        CopyFile(dest, path); /* seed updates and appends after restart */
+    }
+    int n = 0;
+    while ((n < sg->pendN) && (0 != strcmp(sg->pend[n], fname))) {
+        ++n;
+    }
+    if (n == sg->pendN) {
+        if (QUEUEN == sg->pendN) { /* an early commit would break the drain order */
+            pthread_mutex_unlock(&(sg->lock));
+            ShowError("more than %d files staged between commits", QUEUEN);
+        }
+        FormPath(sg->pend[sg->pendN], NULL, fname);
+        ++(sg->pendN);
+    }
+    pthread_mutex_unlock(&(sg->lock));
+    return;
+}
+void CommitStage(void)
+{
+    Stage *const sg = BoundFileTable()->stage;
+    if (NULL == sg) {
+        return;
+    }
+    pthread_mutex_lock(&(sg->lock));
+    CommitPending(sg);
+    pthread_mutex_unlock(&(sg->lock));
+    return;
+}
+void FlushStage(void)
+{
+    Stage *const sg = BoundFileTable()->stage;
+    if (NULL == sg) {
+        return;
+    }
+    pthread_mutex_lock(&(sg->lock));
+    CommitPending(sg);
+    while (sg->head != sg->tail) {
+        pthread_cond_wait(&(sg->cond), &(sg->lock));
+    }
+    pthread_mutex_unlock(&(sg->lock));
+    return;
+}
+void FinalizeStage(void)
+{
+    Stage *const sg = BoundFileTable()->stage;
+    if (NULL == sg) {
+        return;
+    }
+    pthread_mutex_lock(&(sg->lock));
+    CommitPending(sg);
+    sg->stop = 1;
+    pthread_cond_broadcast(&(sg->cond));
+    pthread_mutex_unlock(&(sg->lock));
+    pthread_join(sg->tid, NULL);
+    pthread_cond_destroy(&(sg->cond));
+    pthread_mutex_destroy(&(sg->lock));
+    BoundFileTable()->stage = NULL;
+    RetrieveStorage(sg);
+    return;
+}
+int StageSignaled(void)
+{
+    const int flag = (0 != signaled);
+    signaled = 0;
+    return flag;
+}
+/*
+ * Move pending files into the queue by drain rank, the lock should be held.
+ */
+static void CommitPending(Stage *sg)
+{
+    for (int r = 0; r < RANKN; ++r) {
+        for (int n = 0; n < sg->pendN; ++n) {
+            if (r != RankFile(sg->pend[n])) {
+                continue;
+            }
+            while (QUEUEN == sg->tail - sg->head) {
+                pthread_cond_wait(&(sg->cond), &(sg->lock));
+            }
+            FormPath(sg->queue[sg->tail % QUEUEN], NULL, sg->pend[n]);
+            ++(sg->tail);
+        }
+    }
+    sg->pendN = 0;
+    pthread_cond_broadcast(&(sg->cond));
+    return;
+}
+static int RankFile(const char *fname)
+{
+    const char *ext = strrchr(fname, '.');
+    if (0 == strcmp(fname, "artracfd.log")) {
+        return 2;
+    }
+    if ((NULL != ext) && ((0 == strcmp(ext, ".pvd")) || (0 == strcmp(ext, ".case")))) {
+        return 1;
+    }
+    return 0;
+}
+static int InQueue(const Stage *sg, const char *fname)
+{
+    for (int n = sg->head; n < sg->tail; ++n) {
+        if (0 == strcmp(sg->queue[n % QUEUEN], fname)) {
+            return 1;
+        }
+    }
+    return 0;
+}
+static void *DrainStage(void *arg)
+{
+    Stage *const sg = arg;
+    String fname = {'\0'}; /* file under draining */
+    String src = {'\0'}; /* staged copy */
+    String dest = {'\0'}; /* destination copy */
+    pthread_mutex_lock(&(sg->lock));
+    while (1) {
+        while ((sg->head == sg->tail) && (0 == sg->stop)) {
+            pthread_cond_wait(&(sg->cond), &(sg->lock));
+        }
+        if (sg->head == sg->tail) { /* stopped and emptied */
+            break;
+        }
+        FormPath(fname, NULL, sg->queue[sg->head % QUEUEN]);
+        pthread_mutex_unlock(&(sg->lock));
+        FormPath(src, sg->stage, fname);
+        FormPath(dest, sg->drain, fname);
+        if (0 != CopyFile(src, dest)) {
+            ShowWarning("failed to drain staged file: %s", fname);
+        }
+        pthread_mutex_lock(&(sg->lock));
+        ++(sg->head);
+        pthread_cond_broadcast(&(sg->cond));
+    }
+    pthread_mutex_unlock(&(sg->lock));
+    return arg;
+}
+/*
+ * Copy through a temporary file and rename it, so that readers of the
+ * destination never see a partially copied file.
+ */
+static int CopyFile(const char *src, const char *dest)
+{
+    char buf[BUFSIZ]; /* copy buffer */
+    String tmp = {'\0'}; /* temporary destination */
+    const int len = snprintf(tmp, sizeof(String), "%s.part", dest);
+    if ((0 > len) || ((int)sizeof(String) <= len)) {
+        return 1;
+    }
+    FILE *fi = fopen(src, "rb");
+    if (NULL == fi) {
+        return 1;
+    }
+    FILE *fo = fopen(tmp, "wb");
+    if (NULL == fo) {
+        fclose(fi);
+        return 1;
+    }
+    size_t n = 0; /* bytes of the current block */
+    int fail = 0; /* copy failure flag */
+    while (0 < (n = fread(buf, 1, sizeof(buf), fi))) {
+        if (n != fwrite(buf, 1, n, fo)) {
+            fail = 1;
+            break;
+        }
+    }
+    fail = fail || ferror(fi);
+    fclose(fi);
+    fail = (0 != fclose(fo)) || fail;
+    if ((0 != fail) || (0 != rename(tmp, dest))) {
+        remove(tmp);
+        return 1;
+    }
+    return 0;
+}
+/*
+ * Compose dir/fname, or fname alone without dir, into a string; a
+ * truncated path is an error rather than a silently different file.
+ */
+static void FormPath(char path[], const char *dir, const char *fname)
+{
+    const int len = (NULL == dir) ? snprintf(path, sizeof(String), "%s", fname) :
+        snprintf(path, sizeof(String), "%s/%s", dir, fname);
+    if ((0 > len) || ((int)sizeof(String) <= len)) {
+        ShowError("path exceeds the string length: %s", fname);
+    }
+    return;
+}
+static void CatchSignal(int sig)
+{
+    signaled = sig;
+    return;
+}
+/* a good practice: end file with a newline */
+
@@ -0,0 +1,83 @@
+/****************************************************************************
+ *                              ArtraCFD                                    *
+ *                          <By Huangrui Mo>                                *
+ * Copyright (C) Huangrui Mo <huangrui.mo@gmail.com>                        *
+ * This file is part of ArtraCFD.                                           *
+ * ArtraCFD is free software: you can redistribute it and/or modify it      *
+ * under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or        *
+ * (at your option) any later version.                                      *
+ ****************************************************************************/
+/****************************************************************************
+ * Header File Guards to Avoid Interdependence
+ ****************************************************************************/
+#ifndef ARTRACFD_DATA_STAGE_H_ /* if undefined */
+#define ARTRACFD_DATA_STAGE_H_ /* set a unique marker */
+/****************************************************************************
+ * Required Header Files
+ ****************************************************************************/
+#include "commons.h"
+/****************************************************************************
+ * Data Structure Declarations
+ ****************************************************************************/
+/****************************************************************************
+ * Public Functions Declaration
+ ****************************************************************************/
+/*
+ * Output staging
+ *
+ * Function
+ *      Route output files to a local staging directory and start a drain
+ *      thread that copies finished files to the destination directory.
+ *      Staging is off when the staging directory is empty or "none", or
+ *      when output is muted. The staging state is kept in the file table
+ *      bound to the calling thread.
+ */
+extern void InitializeStage(const Time *);
+/*
+ * Staged file path
+ *
+ * Function
+ *      Map a file name to the path that should be opened with the mode.
+ *      Files opened for writing are placed in the staging directory and
+ *      recorded for the next commit; files opened for reading are taken
+ *      from the destination directory when they exist there. Paths that
+ *      exceed the string length and more files than the queue capacity
+ *      between commits are errors.
+ */
+extern void StagePath(const char *fname, const char *mode, char path[]);
+/*
+ * Commit staged files
+ *
+ * Function
+ *      Hand the files written since the last commit to the drain thread.
+ *      Data files are drained before the .pvd and .case index files that
+ *      refer to them, and the state log is drained last, so that the log
+ *      in the destination always points to a complete snapshot.
+ */
+extern void CommitStage(void);
+/*
+ * Flush staged files
+ *
+ * Function
+ *      Commit and wait until every staged file reaches the destination.
+ */
+extern void FlushStage(void);
+/*
+ * Finalize staging
+ *
+ * Function
+ *      Flush staged files and terminate the drain thread.
+ */
+extern void FinalizeStage(void);
+/*
+ * Checkpoint signal
+ *
+ * Function
+ *      Return whether a checkpoint signal (SIGUSR1) arrived since the last
+ *      query, and clear the record.
+ */
+extern int StageSignaled(void);
+#endif
+/* a good practice: end file with a newline */
+
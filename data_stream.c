@@ -13,11 +13,14 @@
  ****************************************************************************/
 #include "data_stream.h"
 #include <stdio.h> /* standard library for input and output */
+#include <stdlib.h> /* sorting */
 #include <string.h> /* manipulating strings */
 #include <float.h> /* size of floating point values */
 #include "paraview.h"
 #include "ensight.h"
 #include "data_probe.h"
+#include "data_image.h"
+#include "data_stage.h"
 #include "commons.h"
 /****************************************************************************
  * Function Pointers
@@ -28,6 +31,14 @@ typedef void (*StructuredDataWriter)(const Time *, const Space *, const Model *)
 typedef void (*StructuredDataReader)(Time *, Space *, const Model *);
 typedef void (*PolyDataWriter)(const Time *, const Geometry *const);
 typedef void (*PolyDataReader)(const Time *, Geometry *const);
+typedef void (*SurfaceDataWriter)(const Time *, const Surface *);
+/****************************************************************************
+ * Data Structure Declarations
+ ****************************************************************************/
+typedef struct {
+    Real time; /* total wall time of geometry phases */
+    int gid; /* geometry in input order */
+} CostRank;
 /****************************************************************************
  * Static Function Declarations
  ****************************************************************************/
@@ -37,7 +48,10 @@ static void WriteFieldData(const Time *, const Space *, const Model *);
 static void ReadFieldData(Time *, Space *, const Model *);
 static void WriteGeometryData(const Time *, const Geometry *const);
 static void ReadGeometryData(const Time *, Geometry *const);
+static void WriteSurfaceField(const Time *, const Space *, const Model *);
 static void WriteStateData(const Time *);
+static void WriteCostData(const Time *, const Geometry *const);
+static int CompareCost(const void *, const void *);
 /****************************************************************************
  * Global Variables Definition with Private Scope
  ****************************************************************************/
@@ -65,12 +79,22 @@ static PolyDataWriter WritePolyData[2] = {
 static PolyDataReader ReadPolyData[2] = {
     ReadPolyDataParaview,
     ReadPolyDataEnsight};
+static SurfaceDataWriter WriteSurfaceData[2] = {
+    WriteSurfaceDataParaview,
+    WriteSurfaceDataEnsight};
 /****************************************************************************
  * Function definitions
  ****************************************************************************/
 void WriteData(const int n, const Time *time, const Space *space, const Model *model)
 {
     UnifiedWriteData[n](time, space, model);
+    CommitStage();
+    return;
+}
+void WriteImageData(const Time *time, const Space *space, const Model *model)
+{
+    WriteSliceImageData(time, space, model);
+    CommitStage();
     return;
 }
 void ReadData(const int n, Time *time, Space *space, const Model *model)
@@ -82,7 +106,9 @@ static void WriteSpaceData(const Time *time, const Space *space, const Model *mo
 {
     WriteFieldData(time, space, model);
     WriteGeometryData(time, &(space->geo));
+    WriteSurfaceField(time, space, model);
     WriteStateData(time);
+    WriteCostData(time, &(space->geo));
     return;
 }
 static void ReadSpaceData(Time *time, Space *space, const Model *model)
@@ -117,6 +143,19 @@ static void ReadGeometryData(const Time *time, Geometry *const geo)
     ReadPolyData[time->dataStreamer](time, geo);
     return;
 }
+static void WriteSurfaceField(const Time *time, const Space *space, const Model *model)
+{
+    if ((CURVESURF != time->dataN[PROCV]) || (0 == space->geo.totN)) {
+        return;
+    }
+    Surface surf = {0};
+    ComputeSurfaceField(space, model, &surf);
+    WriteSurfaceData[time->dataStreamer](time, &surf);
+    RetrieveStorage(surf.v);
+    RetrieveStorage(surf.f);
+    RetrieveStorage(surf.data);
+    return;
+}
 static void WriteStateData(const Time *time)
 {
     const char *fname = "artracfd.log";
@@ -128,13 +167,64 @@ static void WriteStateData(const Time *time)
     fclose(fp);
     return;
 }
+/*
+ * Rank geometries by the wall time accumulated in geometry phases since
+ * the start of the run, and list the most expensive ones with their
+ * measures in each phase. Times of concurrent work units are summed.
+ */
+static void WriteCostData(const Time *time, const Geometry *const geo)
+{
+    if ((NULL == geo->cost) || (0 == geo->totN)) {
+        return;
+    }
+    const char *phase[COSTP] = {"classify", "reconstruct", "force"};
+    const Real (*cost)[COSTM] = NULL;
+    const int rankN = (geo->costN < geo->totN) ? geo->costN : geo->totN;
+    CostRank *rank = AssignStorage(geo->totN * sizeof(*rank));
+    for (int n = 0; n < geo->totN; ++n) {
+        rank[n].gid = n;
+        for (int p = 0; p < COSTP; ++p) {
+            rank[n].time = rank[n].time + geo->cost[n][p][COSTTIME];
+        }
+    }
+    qsort(rank, geo->totN, sizeof(*rank), CompareCost);
+    String fname = {'\0'};
+    snprintf(fname, sizeof(fname), "%s%05d.csv", "geometry_cost_", time->dataC);
+    FILE *fp = Fopen(fname, "w");
+    fprintf(fp, "# rank, body, faces, time");
+    for (int p = 0; p < COSTP; ++p) {
+        fprintf(fp, ", %s time, %s ghosts, %s facets, %s box", phase[p], phase[p], phase[p], phase[p]);
+    }
+    fprintf(fp, "\n");
+    for (int n = 0; n < rankN; ++n) {
+        cost = (const Real (*)[COSTM])geo->cost[rank[n].gid];
+        fprintf(fp, "%d, %d, %d, %.6g", n + 1, rank[n].gid + 1, geo->poly[geo->pos[rank[n].gid]].faceN, rank[n].time);
+        for (int p = 0; p < COSTP; ++p) {
+            fprintf(fp, ", %.6g, %.15g, %.15g, %.15g", cost[p][COSTTIME], cost[p][COSTNODE],
+                    cost[p][COSTFACET], cost[p][COSTBOX]);
+        }
+        fprintf(fp, "\n");
+    }
+    fclose(fp);
+    RetrieveStorage(rank);
+    return;
+}
+static int CompareCost(const void *x, const void *y)
+{
+    const CostRank *cx = x;
+    const CostRank *cy = y;
+    if (cx->time != cy->time) {
+        return (cx->time > cy->time) ? -1 : 1;
+    }
+    return cx->gid - cy->gid;
+}
 void WritePolyStateData(const int pm, const int pn, FILE *fp, const Geometry *const geo)
 {
     const char *fmtI = "  %.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %d\n";
     const char *fmtJ = "  %.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g\n";
     const Polyhedron *poly = NULL;
     for (int n = pm; n < pn; ++n) {
-        poly = geo->poly + n;
+        poly = geo->poly + geo->pos[n];
         fprintf(fp, fmtI,
                 poly->O[X], poly->O[Y], poly->O[Z], poly->r,
                 poly->V[TO][X], poly->V[TO][Y], poly->V[TO][Z],
@@ -158,7 +248,7 @@ void ReadPolyStateData(const int pm, const int pn, FILE *fp, Geometry *const geo
     Polyhedron *poly  = NULL;
     const Real zero = 0.0;
     for (int n = pm; n < pn; ++n) {
-        poly = geo->poly + n;
+        poly = geo->poly + geo->pos[n];
         Sread(fp, 16, fmtI,
                 &(poly->O[X]), &(poly->O[Y]), &(poly->O[Z]), &(poly->r),
                 &(poly->V[TO][X]), &(poly->V[TO][Y]), &(poly->V[TO][Z]),
@@ -24,6 +24,7 @@
  * Public Functions Declaration
  ****************************************************************************/
 extern void WriteData(const int n, const Time *, const Space *, const Model *);
+extern void WriteImageData(const Time *, const Space *, const Model *);
 extern void ReadData(const int n, Time *, Space *, const Model *);
 extern void WritePolyStateData(const int pm, const int pn, FILE *fp, const Geometry *const);
 extern void ReadPolyStateData(const int pm, const int pn, FILE *fp, Geometry *const);
@@ -59,23 +59,25 @@ static void ComputeFvhatX(const int tn, const int k, const int j, const int i,
         const int partn[restrict], const Real dd[restrict], const Node *const node,
         const Model *model, Real Fvhat[restrict])
 {
+    int st[DIMS] = {0}; /* index strides */
+    IndexStride(partn, st);
     const int idx = IndexNode(k, j, i, partn[Y], partn[X]);
-    const int idxS = IndexNode(k, j - 1, i, partn[Y], partn[X]);
-    const int idxN = IndexNode(k, j + 1, i, partn[Y], partn[X]);
-    const int idxF = IndexNode(k - 1, j, i, partn[Y], partn[X]);
-    const int idxB = IndexNode(k + 1, j, i, partn[Y], partn[X]);
+    const int idxS = idx - st[Y];
+    const int idxN = idx + st[Y];
+    const int idxF = idx - st[Z];
+    const int idxB = idx + st[Z];
 
-    const int idxE = IndexNode(k, j, i + 1, partn[Y], partn[X]);
-    const int idxSE = IndexNode(k, j - 1, i + 1, partn[Y], partn[X]);
-    const int idxNE = IndexNode(k, j + 1, i + 1, partn[Y], partn[X]);
-    const int idxFE = IndexNode(k - 1, j, i + 1, partn[Y], partn[X]);
-    const int idxBE = IndexNode(k + 1, j, i + 1, partn[Y], partn[X]);
+    const int idxE = idx + st[X];
+    const int idxSE = idx - st[Y] + st[X];
+    const int idxNE = idx + st[Y] + st[X];
+    const int idxFE = idx - st[Z] + st[X];
+    const int idxBE = idx + st[Z] + st[X];
 
     const Real *restrict U = node[idx].U[tn];
     const Real u = U[1] / U[0];
     const Real v = U[2] / U[0];
     const Real w = U[3] / U[0];
-    const Real T = ComputeTemperature(model->cv, U);
+    const Real T = ComputeTemperature(model, U);
 
     U = node[idxS].U[tn];
     const Real uS = U[1] / U[0];
@@ -97,7 +99,7 @@ static void ComputeFvhatX(const int tn, const int k, const int j, const int i,
     const Real uE = U[1] / U[0];
     const Real vE = U[2] / U[0];
     const Real wE = U[3] / U[0];
-    const Real TE = ComputeTemperature(model->cv, U);
+    const Real TE = ComputeTemperature(model, U);
 
     U = node[idxSE].U[tn];
     const Real uSE = U[1] / U[0];
@@ -144,23 +146,25 @@ static void ComputeFvhatY(const int tn, const int k, const int j, const int i,
         const int partn[restrict], const Real dd[restrict], const Node *const node,
         const Model *model, Real Fvhat[restrict])
 {
+    int st[DIMS] = {0}; /* index strides */
+    IndexStride(partn, st);
     const int idx = IndexNode(k, j, i, partn[Y], partn[X]);
-    const int idxW = IndexNode(k, j, i - 1, partn[Y], partn[X]);
-    const int idxE = IndexNode(k, j, i + 1, partn[Y], partn[X]);
-    const int idxF = IndexNode(k - 1, j, i, partn[Y], partn[X]);
-    const int idxB = IndexNode(k + 1, j, i, partn[Y], partn[X]);
+    const int idxW = idx - st[X];
+    const int idxE = idx + st[X];
+    const int idxF = idx - st[Z];
+    const int idxB = idx + st[Z];
 
-    const int idxN = IndexNode(k, j + 1, i, partn[Y], partn[X]);
-    const int idxWN = IndexNode(k, j + 1, i - 1, partn[Y], partn[X]);
-    const int idxEN = IndexNode(k, j + 1, i + 1, partn[Y], partn[X]);
-    const int idxFN = IndexNode(k - 1, j + 1, i, partn[Y], partn[X]);
-    const int idxBN = IndexNode(k + 1, j + 1, i, partn[Y], partn[X]);
+    const int idxN = idx + st[Y];
+    const int idxWN = idx + st[Y] - st[X];
+    const int idxEN = idx + st[Y] + st[X];
+    const int idxFN = idx - st[Z] + st[Y];
+    const int idxBN = idx + st[Z] + st[Y];
 
     const Real *restrict U = node[idx].U[tn];
     const Real u = U[1] / U[0];
     const Real v = U[2] / U[0];
     const Real w = U[3] / U[0];
-    const Real T = ComputeTemperature(model->cv, U);
+    const Real T = ComputeTemperature(model, U);
 
     U = node[idxW].U[tn];
     const Real uW = U[1] / U[0];
@@ -182,7 +186,7 @@ static void ComputeFvhatY(const int tn, const int k, const int j, const int i,
     const Real uN = U[1] / U[0];
     const Real vN = U[2] / U[0];
     const Real wN = U[3] / U[0];
-    const Real TN = ComputeTemperature(model->cv, U);
+    const Real TN = ComputeTemperature(model, U);
 
     U = node[idxWN].U[tn];
     const Real uWN = U[1] / U[0];
@@ -229,23 +233,25 @@ static void ComputeFvhatZ(const int tn, const int k, const int j, const int i,
         const int partn[restrict], const Real dd[restrict], const Node *const node,
         const Model *model, Real Fvhat[restrict])
 {
+    int st[DIMS] = {0}; /* index strides */
+    IndexStride(partn, st);
     const int idx = IndexNode(k, j, i, partn[Y], partn[X]);
-    const int idxW = IndexNode(k, j, i - 1, partn[Y], partn[X]);
-    const int idxE = IndexNode(k, j, i + 1, partn[Y], partn[X]);
-    const int idxS = IndexNode(k, j - 1, i, partn[Y], partn[X]);
-    const int idxN = IndexNode(k, j + 1, i, partn[Y], partn[X]);
+    const int idxW = idx - st[X];
+    const int idxE = idx + st[X];
+    const int idxS = idx - st[Y];
+    const int idxN = idx + st[Y];
 
-    const int idxB = IndexNode(k + 1, j, i, partn[Y], partn[X]);
-    const int idxWB = IndexNode(k + 1, j, i - 1, partn[Y], partn[X]);
-    const int idxEB = IndexNode(k + 1, j, i + 1, partn[Y], partn[X]);
-    const int idxSB = IndexNode(k + 1, j - 1, i, partn[Y], partn[X]);
-    const int idxNB = IndexNode(k + 1, j + 1, i, partn[Y], partn[X]);
+    const int idxB = idx + st[Z];
+    const int idxWB = idx + st[Z] - st[X];
+    const int idxEB = idx + st[Z] + st[X];
+    const int idxSB = idx + st[Z] - st[Y];
+    const int idxNB = idx + st[Z] + st[Y];
 
     const Real *restrict U = node[idx].U[tn];
     const Real u = U[1] / U[0];
     const Real v = U[2] / U[0];
     const Real w = U[3] / U[0];
-    const Real T = ComputeTemperature(model->cv, U);
+    const Real T = ComputeTemperature(model, U);
 
     U = node[idxW].U[tn];
     const Real uW = U[1] / U[0];
@@ -267,7 +273,7 @@ static void ComputeFvhatZ(const int tn, const int k, const int j, const int i,
     const Real uB = U[1] / U[0];
     const Real vB = U[2] / U[0];
     const Real wB = U[3] / U[0];
-    const Real TB = ComputeTemperature(model->cv, U);
+    const Real TB = ComputeTemperature(model, U);
 
     U = node[idxWB].U[tn];
     const Real uWB = U[1] / U[0];
@@ -12,13 +12,32 @@
  * Required Header Files
  ****************************************************************************/
 #include "domain_partition.h"
+#include <string.h> /* manipulating strings */
+#include "cfd_commons.h"
 #include "commons.h"
+/****************************************************************************
+ * Data Structure Declarations
+ ****************************************************************************/
+typedef enum {
+    COSTF = 1, /* cost weight of a fluid node */
+    COSTG = 4, /* estimated cost weight of a ghost node until measured */
+    COSTS = 0, /* cost weight of a solid node */
+} PartitionConst;
+/****************************************************************************
+ * Static Function Declarations
+ ****************************************************************************/
+static void BisectWorkload(const int, const int, int [restrict][LIMIT],
+        Partition *const, const Node *const);
+static Real ComputeCost(int [restrict][LIMIT], const int, Real [restrict],
+        const Partition *const, const Node *const);
 /****************************************************************************
  * Function definitions
  ****************************************************************************/
 void PartitionDomain(Space *space)
 {
     Partition *const part = &(space->part);
+    part->ghostCost = COSTG;
+    part->active = part->thread;
     /*
      * Outward facing surface unit normal vector of domain boundary
      * Surface normal vector can provide great advantage: every surface can
@@ -148,5 +167,115 @@ void PartitionDomain(Space *space)
     part->pathSep[0] = part->pathSep[part->gl];
     return;
 }
+void BalanceWorkload(Space *space)
+{
+    Partition *const part = &(space->part);
+    const Real tol = 1.1; /* tolerated ratio of the maximum to the mean unit cost */
+    Real cost = 0.0; /* cost of current unit */
+    Real max = 0.0; /* maximum unit cost */
+    Real sum = 0.0; /* total cost */
+    if ((1 == part->unitN) && (1 == part->active)) { /* a single unit is always balanced */
+        return;
+    }
+    if (part->active == part->unitN) {
+        for (int u = 0; u < part->unitN; ++u) {
+            cost = ComputeCost(part->unit[u], X, NULL, part, space->node);
+            max = MaxReal(max, cost);
+            sum = sum + cost;
+        }
+        if (max * part->unitN <= tol * sum) {
+            return;
+        }
+    }
+    int box[DIMS][LIMIT] = {{0}}; /* interior node box */
+    for (int s = 0; s < DIMS; ++s) {
+        box[s][MIN] = part->ns[PIN][s][MIN];
+        box[s][MAX] = part->ns[PIN][s][MAX];
+    }
+    part->unitN = part->active;
+    BisectWorkload(0, part->unitN, box, part, space->node);
+    return;
+}
+/*
+ * Split the box along its longest side at the node layer that best
+ * divides the cost in proportion to the number of units on each side.
+ */
+static void BisectWorkload(const int u, const int un, int box[restrict][LIMIT],
+        Partition *const part, const Node *const node)
+{
+    int s = X; /* split direction */
+    for (int q = Y; q < DIMS; ++q) {
+        if ((box[q][MAX] - box[q][MIN]) > (box[s][MAX] - box[s][MIN])) {
+            s = q;
+        }
+    }
+    const int len = box[s][MAX] - box[s][MIN];
+    if ((1 == un) || (2 > len)) { /* keep box in the first unit, leave the rest empty */
+        for (int q = 0; q < DIMS; ++q) {
+            part->unit[u][q][MIN] = box[q][MIN];
+            part->unit[u][q][MAX] = box[q][MAX];
+        }
+        for (int v = u + 1; v < u + un; ++v) {
+            for (int q = 0; q < DIMS; ++q) {
+                part->unit[v][q][MIN] = box[q][MIN];
+                part->unit[v][q][MAX] = box[q][MIN];
+            }
+        }
+        return;
+    }
+    const int ul = un / 2; /* units of the lower side */
+    Real layer[len]; /* cost of each node layer */
+    const Real target = ComputeCost(box, s, layer, part, node) * ul / un;
+    Real acc = layer[0]; /* accumulated cost of the lower side */
+    int cut = 1; /* layers of the lower side */
+    while ((cut < len - 1) && (acc + layer[cut] - target < target - acc)) {
+        acc = acc + layer[cut];
+        ++cut;
+    }
+    int sub[DIMS][LIMIT] = {{0}}; /* node box of one side */
+    memcpy(sub, box, sizeof sub);
+    sub[s][MAX] = box[s][MIN] + cut;
+    BisectWorkload(u, ul, sub, part, node);
+    memcpy(sub, box, sizeof sub);
+    sub[s][MIN] = box[s][MIN] + cut;
+    BisectWorkload(u + ul, un - ul, sub, part, node);
+    return;
+}
+/*
+ * Return the cost of the box, and store the cost of each node layer
+ * normal to direction s into layer if it is not null.
+ */
+static Real ComputeCost(int box[restrict][LIMIT], const int s, Real layer[restrict],
+        const Partition *const part, const Node *const node)
+{
+    const Real weight[3] = {COSTF, part->ghostCost, COSTS};
+    int idx = 0; /* linear array index math variable */
+    int w = 0; /* node type for the weight */
+    Real sum = 0.0; /* total cost */
+    if (NULL != layer) {
+        for (int m = 0; m < box[s][MAX] - box[s][MIN]; ++m) {
+            layer[m] = 0.0;
+        }
+    }
+    for (int k = box[Z][MIN]; k < box[Z][MAX]; ++k) {
+        for (int j = box[Y][MIN]; j < box[Y][MAX]; ++j) {
+            for (int i = box[X][MIN]; i < box[X][MAX]; ++i) {
+                idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
+                w = (0 == node[idx].did) ? 0 : ((0 < node[idx].gst) ? 1 : 2);
+                sum = sum + weight[w];
+                if (NULL != layer) {
+                    const IntVec n = {i, j, k};
+                    layer[n[s] - box[s][MIN]] = layer[n[s] - box[s][MIN]] + weight[w];
+                }
+            }
+        }
+    }
+    return sum;
+}
+void RunWorkUnits(const Partition *const part, UnitWorker work, void *arg)
+{
+    RunWorkItems(part->pool, part->unitN, work, arg);
+    return;
+}
 /* a good practice: end file with a newline */
 
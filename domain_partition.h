@@ -20,6 +20,11 @@
 /****************************************************************************
  * Data Structure Declarations
  ****************************************************************************/
+/*
+ * A unit worker receives the index of its work unit, takes the node box
+ * from part->unit of that index, and keys any per-unit result by it.
+ */
+typedef void (*UnitWorker)(const int, void *);
 /****************************************************************************
  * Public Functions Declaration
  ****************************************************************************/
@@ -31,6 +36,27 @@
  *      for each partitions.
  */
 extern void PartitionDomain(Space *);
+/*
+ * Workload balance
+ *
+ * Function
+ *      Estimate the cost of each interior node from the geometric field,
+ *      with unit cost for fluid nodes, no cost for solid nodes, and the
+ *      ghost node cost of the partition, a fixed estimate until measured by
+ *      the kernel tuner. Split the interior node box by recursive bisection
+ *      into one work unit per worker thread in use with balanced cost. Existing units are kept
+ *      until the motion of bodies drives the imbalance out of tolerance.
+ */
+extern void BalanceWorkload(Space *);
+/*
+ * Run work units
+ *
+ * Function
+ *      Apply the worker to the index of every work unit concurrently on the
+ *      worker thread pool of the partition, the worker takes the node box
+ *      of the unit from the partition. Units are run as work items.
+ */
+extern void RunWorkUnits(const Partition *const, UnitWorker, void *);
 #endif
 /* a good practice: end file with a newline */
 
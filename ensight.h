@@ -37,6 +37,7 @@ typedef struct {
     EnStr gtag; /* geometry name tag */
     EnStr vtag; /* variable name tag */
     EnStr dtype; /* data type */
+    EnStr vloc; /* variable location: node or element */
     int part[LIMIT]; /* part control */
     int scaN; /* number of scalar variables */
     char sca[ENSCAN][ENVARSTR]; /* scalar variables */
@@ -56,6 +57,10 @@ extern void ReadStructuredDataEnsight(Time *, Space *, const Model *);
  */
 extern void WritePolyDataEnsight(const Time *, const Geometry *const);
 extern void ReadPolyDataEnsight(const Time *, Geometry *const);
+/*
+ * Surface field writer
+ */
+extern void WriteSurfaceDataEnsight(const Time *, const Surface *);
 #endif
 /* a good practice: end file with a newline */
 
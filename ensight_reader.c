@@ -117,7 +117,7 @@ static void ReadStructuredData(Space *space, const Model *model, EnSet *enSet)
                                 break;
                             case 4: /* p */
                                 U[4] = 0.5 * (U[1] * U[1] + U[2] * U[2] + U[3] * U[3]) / U[0] +
-                                    data / (model->gamma - 1.0);
+                                    ComputeInternalEnergy(model, U[0], data);
                                 break;
                             default:
                                 break;
@@ -195,7 +195,7 @@ static void ReadPolygonPolyData(const int pm, const int pn, Geometry *const geo,
     Fread(enSet->str, sizeof(EnStr), 1, fp);
     Fread(enSet->str, sizeof(EnStr), 1, fp);
     for (int p = enSet->part[MIN], pnum = 1; p < enSet->part[MAX]; ++p, ++pnum) {
-        poly = geo->poly + p;
+        poly = geo->poly + geo->pos[p];
         Fread(enSet->str, sizeof(EnStr), 1, fp);
         Fread(&pnum, sizeof(int), 1, fp);
         Fread(enSet->str, sizeof(EnStr), 1, fp);
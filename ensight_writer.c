@@ -30,6 +30,8 @@ static void PolygonPolyDataWriter(const Time *, const Geometry *const);
 static void WritePolygonPolyData(const int, const int, const Geometry *const, EnSet *);
 static void WritePolyVariable(const int, const int, const Geometry *const, EnSet *);
 static void WritePolyState(const int, const int, const Geometry *const, EnSet *);
+static void WriteSurfaceGeometry(const Surface *, EnSet *);
+static void WriteSurfaceVariable(const Surface *, EnSet *);
 /****************************************************************************
  * Function definitions
  ****************************************************************************/
@@ -44,6 +46,7 @@ void WriteStructuredDataEnsight(const Time *time, const Space *space, const Mode
         .gtag = {'\0'},
         .vtag = "*****",
         .dtype = "block",
+        .vloc = "node",
         .part = {PIO, PIO + 1},
         .scaN = 7,
         .sca = {"rho", "u", "v", "w", "p", "T", "did"},
@@ -71,11 +74,11 @@ static void InitializeTransientCaseFile(EnSet *enSet)
     fprintf(fp, "\n");
     fprintf(fp, "VARIABLE\n");
     for (int n = 0; n < enSet->scaN; ++n) {
-        fprintf(fp, "scalar per node:  1  %3s  %s%s.%s\n",
+        fprintf(fp, "scalar per %s:  1  %3s  %s%s.%s\n", enSet->vloc,
                 enSet->sca[n], enSet->rname, enSet->vtag, enSet->sca[n]);
     }
     for (int n = 0; n < enSet->vecN; ++n) {
-        fprintf(fp, "vector per node:  1  %3s  %s%s.%s\n",
+        fprintf(fp, "vector per %s:  1  %3s  %s%s.%s\n", enSet->vloc,
                 enSet->vec[n], enSet->rname, enSet->vtag, enSet->vec[n]);
     }
     fprintf(fp, "\n");
@@ -106,11 +109,11 @@ static void WriteCaseFile(const Time *time, EnSet *enSet)
     fprintf(fp, "constant per case:  Time  %.6g\n", time->now);
     fprintf(fp, "constant per case:  Step  %d\n", time->stepC);
     for (int n = 0; n < enSet->scaN; ++n) {
-        fprintf(fp, "scalar per node:     %3s  %s.%s\n",
+        fprintf(fp, "scalar per %s:     %3s  %s.%s\n", enSet->vloc,
                 enSet->sca[n], enSet->bname, enSet->sca[n]);
     }
     for (int n = 0; n < enSet->vecN; ++n) {
-        fprintf(fp, "vector per node:     %3s  %s.%s\n",
+        fprintf(fp, "vector per %s:     %3s  %s.%s\n", enSet->vloc,
                 enSet->vec[n], enSet->bname, enSet->vec[n]);
     }
     fprintf(fp, "\n");
@@ -135,6 +138,8 @@ static void WriteGeometryFile(const Space *space, EnSet *enSet)
     /*
      * Write the geometry file in Binary Form.
      * Maximums: maximum number of nodes in a part is 2GB.
+     * A uniform block is given by its origin and spacing, since node
+     * coordinates of the uniform grid carry no further information.
      */
     snprintf(enSet->fname, sizeof(EnStr), "%s.geo", enSet->rname);
     FILE *fp = Fopen(enSet->fname, "wb");
@@ -159,22 +164,19 @@ static void WriteGeometryFile(const Space *space, EnSet *enSet)
         fwrite(&pnum, sizeof(int), 1, fp);
         snprintf(enSet->str, sizeof(EnStr), "part %d", p);
         fwrite(enSet->str, sizeof(EnStr), 1, fp);
-        strncpy(enSet->str, enSet->dtype, sizeof(EnStr));
+        snprintf(enSet->str, sizeof(EnStr), "%s uniform", enSet->dtype);
         fwrite(enSet->str, sizeof(EnStr), 1, fp);
         ne[X] = part->ns[p][X][MAX] - part->ns[p][X][MIN];
         ne[Y] = part->ns[p][Y][MAX] - part->ns[p][Y][MIN];
         ne[Z] = part->ns[p][Z][MAX] - part->ns[p][Z][MIN];
         fwrite(ne, sizeof(int), 3, fp);
         for (int s = 0; s < DIMS; ++s) {
-            for (int k = part->ns[p][Z][MIN]; k < part->ns[p][Z][MAX]; ++k) {
-                for (int j = part->ns[p][Y][MIN]; j < part->ns[p][Y][MAX]; ++j) {
-                    for (int i = part->ns[p][X][MIN]; i < part->ns[p][X][MAX]; ++i) {
-                        ne[X] = i; ne[Y] = j; ne[Z] = k;
-                        data = MapPoint(ne[s], part->domain[s][MIN], part->d[s], part->ng[s]);
-                        fwrite(&data, sizeof(EnReal), 1, fp);
-                    }
-                }
-            }
+            data = MapPoint(part->ns[p][s][MIN], part->domain[s][MIN], part->d[s], part->ng[s]);
+            fwrite(&data, sizeof(EnReal), 1, fp);
+        }
+        for (int s = 0; s < DIMS; ++s) {
+            data = part->d[s];
+            fwrite(&data, sizeof(EnReal), 1, fp);
         }
     }
     fclose(fp);
@@ -226,13 +228,13 @@ static void WriteStructuredData(const Space *space, const Model *model, EnSet *e
                                 data = U[3] / U[0];
                                 break;
                             case 4: /* p */
-                                data = ComputePressure(model->gamma, U);
+                                data = ComputePressure(model, U);
                                 break;
                             case 5: /* T */
-                                data = ComputeTemperature(model->cv, U);
+                                data = ComputeTemperature(model, U);
                                 break;
                             case 6: /* node flag */
-                                data = node[idx].did;
+                                data = (0 < node[idx].did) ? space->geo.poly[node[idx].did-1].pid : node[idx].did;
                                 break;
                             default:
                                 break;
@@ -294,6 +296,7 @@ static void PointPolyDataWriter(const Time *time, const Geometry *const geo)
         .gtag = "*****",
         .vtag = "*****",
         .dtype = "coordinates",
+        .vloc = "node",
         .part = {0, 1},
         .scaN = 2,
         .sca = {"r", "did"},
@@ -338,7 +341,7 @@ static void WritePointPolyData(const int pm, const int pn, const Geometry *const
         fwrite(&ne, sizeof(int), 1, fp);
         for (int s = 0; s < DIMS; ++s) {
             for (int n = pm; n < pn; ++n) {
-                data = geo->poly[n].O[s];
+                data = geo->poly[geo->pos[n]].O[s];
                 fwrite(&data, sizeof(EnReal), 1, fp);
             }
         }
@@ -366,6 +369,7 @@ static void PolygonPolyDataWriter(const Time *time, const Geometry *const geo)
         .gtag = "*****",
         .vtag = "*****",
         .dtype = "coordinates",
+        .vloc = "node",
         .part = {geo->sphN, geo->totN},
         .scaN = 0,
         .sca = {{'\0'}},
@@ -400,7 +404,7 @@ static void WritePolygonPolyData(const int pm, const int pn, const Geometry *con
     strncpy(enSet->str, "element id off", sizeof(EnStr));
     fwrite(enSet->str, sizeof(EnStr), 1, fp);
     for (int p = enSet->part[MIN], pnum = 1; p < enSet->part[MAX]; ++p, ++pnum) {
-        poly = geo->poly + p;
+        poly = geo->poly + geo->pos[p];
         strncpy(enSet->str, "part", sizeof(EnStr));
         fwrite(enSet->str, sizeof(EnStr), 1, fp);
         fwrite(&pnum, sizeof(int), 1, fp);
@@ -453,7 +457,7 @@ static void WritePolyVariable(const int pm, const int pn, const Geometry *const
             for (int n = pm; n < pn; ++n) {
                 switch (s) {
                     case 0:
-                        data = geo->poly[n].r;
+                        data = geo->poly[geo->pos[n]].r;
                         break;
                     case 1:
                         data = n + 1;
@@ -480,7 +484,7 @@ static void WritePolyVariable(const int pm, const int pn, const Geometry *const
             fwrite(enSet->str, sizeof(EnStr), 1, fp);
             for (int n = 0; n < DIMS; ++n) {
                 for (int m = pm; m < pn; ++m) {
-                    data = geo->poly[m].V[TO][n];
+                    data = geo->poly[geo->pos[m]].V[TO][n];
                     fwrite(&data, sizeof(EnReal), 1, fp);
                 }
             }
@@ -497,5 +501,140 @@ static void WritePolyState(const int pm, const int pn, const Geometry *const geo
     fclose(fp);
     return;
 }
+void WriteSurfaceDataEnsight(const Time *time, const Surface *surf)
+{
+    EnSet enSet = { /* initialize environment */
+        .rname = "surface",
+        .bname = {'\0'},
+        .fname = {'\0'},
+        .str = {'\0'},
+        .fmt = "%s%05d",
+        .gtag = "*****",
+        .vtag = "*****",
+        .dtype = "coordinates",
+        .vloc = "element",
+        .part = {0, 1},
+        .scaN = 3,
+        .sca = {"p", "T", "did"},
+        .vecN = 1,
+        .vec = {"tau"},
+    };
+    snprintf(enSet.bname, sizeof(EnStr), enSet.fmt, enSet.rname, time->dataC);
+    if (0 == time->stepC) { /* initialization step */
+        InitializeTransientCaseFile(&enSet);
+    }
+    WriteCaseFile(time, &enSet);
+    WriteSurfaceGeometry(surf, &enSet);
+    WriteSurfaceVariable(surf, &enSet);
+    return;
+}
+/*
+ * All geometries are written as a single part, with the sphere samples
+ * as point elements followed by the facets as tria3 elements.
+ */
+static void WriteSurfaceGeometry(const Surface *surf, EnSet *enSet)
+{
+    snprintf(enSet->fname, sizeof(EnStr), "%s.geo", enSet->bname);
+    FILE *fp = Fopen(enSet->fname, "wb");
+    EnReal data = 0.0; /* the Ensight data format */
+    int pnum = 1; /* part number */
+    /* description at the beginning */
+    strncpy(enSet->str, "C Binary", sizeof(EnStr));
+    fwrite(enSet->str, sizeof(EnStr), 1, fp);
+    strncpy(enSet->str, "Ensight Geometry File", sizeof(EnStr));
+    fwrite(enSet->str, sizeof(EnStr), 1, fp);
+    strncpy(enSet->str, "Written by ArtraCFD", sizeof(EnStr));
+    fwrite(enSet->str, sizeof(EnStr), 1, fp);
+    /* node id and extents settings */
+    strncpy(enSet->str, "node id off", sizeof(EnStr));
+    fwrite(enSet->str, sizeof(EnStr), 1, fp);
+    strncpy(enSet->str, "element id off", sizeof(EnStr));
+    fwrite(enSet->str, sizeof(EnStr), 1, fp);
+    strncpy(enSet->str, "part", sizeof(EnStr));
+    fwrite(enSet->str, sizeof(EnStr), 1, fp);
+    fwrite(&pnum, sizeof(int), 1, fp);
+    strncpy(enSet->str, enSet->rname, sizeof(EnStr));
+    fwrite(enSet->str, sizeof(EnStr), 1, fp);
+    strncpy(enSet->str, enSet->dtype, sizeof(EnStr));
+    fwrite(enSet->str, sizeof(EnStr), 1, fp);
+    fwrite(&(surf->pointN), sizeof(int), 1, fp);
+    for (int s = 0; s < DIMS; ++s) {
+        for (int n = 0; n < surf->pointN; ++n) {
+            data = surf->v[n][s];
+            fwrite(&data, sizeof(EnReal), 1, fp);
+        }
+    }
+    if (0 < surf->vertN) {
+        strncpy(enSet->str, "point", sizeof(EnStr));
+        fwrite(enSet->str, sizeof(EnStr), 1, fp);
+        fwrite(&(surf->vertN), sizeof(int), 1, fp);
+        for (int n = 1; n <= surf->vertN; ++n) {
+            fwrite(&n, sizeof(int), 1, fp);
+        }
+    }
+    if (0 < surf->faceN) {
+        strncpy(enSet->str, "tria3", sizeof(EnStr));
+        fwrite(enSet->str, sizeof(EnStr), 1, fp);
+        fwrite(&(surf->faceN), sizeof(int), 1, fp);
+        for (int n = 0, m = 0; n < surf->faceN; ++n) {
+            for (int s = 0; s < POLYN; ++s) {
+                m = surf->f[n][s] + 1;
+                fwrite(&m, sizeof(int), 1, fp);
+            }
+        }
+    }
+    fclose(fp);
+    return;
+}
+/*
+ * The values for each element type are output in the element order of
+ * the geometry file, vector components one after another.
+ */
+static void WriteSurfaceVariable(const Surface *surf, EnSet *enSet)
+{
+    FILE *fp = NULL;
+    EnReal data = 0.0; /* the Ensight data format */
+    const int sca[ENSCAN] = {0, 1, 5}; /* data column of each scalar variable */
+    const int vec[ENVECN] = {2}; /* leading data column of each vector variable */
+    const int cell[3] = {0, surf->vertN, surf->vertN + surf->faceN}; /* cell range of each element type */
+    int pnum = 1; /* part number */
+    for (int s = 0; s < enSet->scaN + enSet->vecN; ++s) {
+        if (s < enSet->scaN) {
+            snprintf(enSet->fname, sizeof(EnStr), "%s.%s", enSet->bname, enSet->sca[s]);
+            strncpy(enSet->str, "scalar variable", sizeof(EnStr));
+        } else {
+            snprintf(enSet->fname, sizeof(EnStr), "%s.%s", enSet->bname, enSet->vec[s - enSet->scaN]);
+            strncpy(enSet->str, "vector variable", sizeof(EnStr));
+        }
+        fp = Fopen(enSet->fname, "wb");
+        /* first line description per file */
+        fwrite(enSet->str, sizeof(EnStr), 1, fp);
+        strncpy(enSet->str, "part", sizeof(EnStr));
+        fwrite(enSet->str, sizeof(EnStr), 1, fp);
+        fwrite(&pnum, sizeof(int), 1, fp);
+        for (int e = 0; e < 2; ++e) {
+            if (cell[e] == cell[e + 1]) {
+                continue;
+            }
+            strncpy(enSet->str, (0 == e) ? "point" : "tria3", sizeof(EnStr)); /* element type */
+            fwrite(enSet->str, sizeof(EnStr), 1, fp);
+            if (s < enSet->scaN) {
+                for (int n = cell[e]; n < cell[e + 1]; ++n) {
+                    data = surf->data[n][sca[s]];
+                    fwrite(&data, sizeof(EnReal), 1, fp);
+                }
+                continue;
+            }
+            for (int m = 0; m < DIMS; ++m) {
+                for (int n = cell[e]; n < cell[e + 1]; ++n) {
+                    data = surf->data[n][vec[s - enSet->scaN] + m];
+                    fwrite(&data, sizeof(EnReal), 1, fp);
+                }
+            }
+        }
+        fclose(fp);
+    }
+    return;
+}
 /* a good practice: end file with a newline */
 
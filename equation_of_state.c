@@ -0,0 +1,159 @@
+/****************************************************************************
+ *                              ArtraCFD                                    *
+ *                          <By Huangrui Mo>                                *
+ * Copyright (C) Huangrui Mo <huangrui.mo@gmail.com>                        *
+ * This file is part of ArtraCFD.                                           *
+ * ArtraCFD is free software: you can redistribute it and/or modify it      *
+ * under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or        *
+ * (at your option) any later version.                                      *
+ ****************************************************************************/
+/****************************************************************************
+ * Required Header Files
+ ****************************************************************************/
+#include "equation_of_state.h"
+#include <stdio.h> /* standard library for input and output */
+#include <math.h> /* common mathematical functions */
+#include "cfd_commons.h"
+#include "commons.h"
+/****************************************************************************
+ * Static Function Declarations
+ ****************************************************************************/
+static int TableCell(const Real, const Real, const int, Real *);
+static Real IsobaricTemperature(const Material *, const Real, const Real);
+/****************************************************************************
+ * Function definitions
+ ****************************************************************************/
+/*
+ * The table file holds a "table begin" section with the entry numbers of
+ * density and internal energy, the density range, the internal energy range,
+ * and then one line of pressure, temperature, speed of sound per entry with
+ * internal energy running fastest. Axes are uniform so that a lookup needs
+ * no search, and the three states of an entry are stored together so that
+ * a lookup touches four adjacent records only. Values are in SI units.
+ */
+void LoadEquationOfState(Model *model)
+{
+    if (EOSIDEAL == model->eos) {
+        return;
+    }
+    Material *const mat = model->mat;
+    const char *fname = "artracfd.eos";
+    FILE *fp = Fopen(fname, "r");
+    const char *fmtI = ParseFormat("%lg, %lg");
+    const char *fmtJ = ParseFormat("%lg, %lg, %lg");
+    Real bound[2][LIMIT] = {{0.0}}; /* table range of density and internal energy */
+    ReadInLine(fp, "table begin");
+    Sread(fp, 2, "%d, %d", mat->tn + 0, mat->tn + 1);
+    Sread(fp, 2, fmtI, &(bound[0][MIN]), &(bound[0][MAX]));
+    Sread(fp, 2, fmtI, &(bound[1][MIN]), &(bound[1][MAX]));
+    if ((2 > mat->tn[0]) || (2 > mat->tn[1]) ||
+            (bound[0][MIN] >= bound[0][MAX]) || (bound[1][MIN] >= bound[1][MAX])) {
+        ShowError("illegal table size or range: %s", fname);
+    }
+    /* normalize by reference values */
+    const Real refE = model->refV * model->refV;
+    const Real refP = model->refRho * refE;
+    const Real ref[2] = {model->refRho, refE};
+    for (int s = 0; s < 2; ++s) {
+        bound[s][MIN] = bound[s][MIN] / ref[s];
+        bound[s][MAX] = bound[s][MAX] / ref[s];
+        mat->t0[s] = bound[s][MIN];
+        mat->dd[s] = (Real)(mat->tn[s] - 1) / (bound[s][MAX] - bound[s][MIN]);
+    }
+    const int totN = mat->tn[0] * mat->tn[1];
+    mat->tab = AssignStorage(totN * sizeof(*mat->tab));
+    for (int n = 0; n < totN; ++n) {
+        Sread(fp, 3, fmtJ, mat->tab[n] + EOSP, mat->tab[n] + EOST, mat->tab[n] + EOSC);
+        mat->tab[n][EOSP] = mat->tab[n][EOSP] / refP;
+        mat->tab[n][EOST] = mat->tab[n][EOST] / model->refT;
+        mat->tab[n][EOSC] = mat->tab[n][EOSC] / model->refV;
+    }
+    fclose(fp);
+    return;
+}
+/*
+ * Locate the table cell containing the normalized coordinate x and
+ * return the cell index with the interpolation weight in w.
+ */
+static int TableCell(const Real x, const Real dd, const int tn, Real *w)
+{
+    const Real f = x * dd;
+    const int i = MinInt(MaxInt((int)floor(f), 0), tn - 2);
+    *w = MinReal(MaxReal(f - i, 0.0), 1.0);
+    return i;
+}
+void LookupEos(const Material *mat, const Real rho, const Real e, Real pTc[restrict])
+{
+    Real wi = 0.0, wj = 0.0; /* interpolation weights */
+    const int i = TableCell(rho - mat->t0[0], mat->dd[0], mat->tn[0], &wi);
+    const int j = TableCell(e - mat->t0[1], mat->dd[1], mat->tn[1], &wj);
+    const Real *restrict T00 = mat->tab[i * mat->tn[1] + j];
+    const Real *restrict T01 = mat->tab[i * mat->tn[1] + j + 1];
+    const Real *restrict T10 = mat->tab[(i + 1) * mat->tn[1] + j];
+    const Real *restrict T11 = mat->tab[(i + 1) * mat->tn[1] + j + 1];
+    for (int n = 0; n < EOSN; ++n) {
+        pTc[n] = (1.0 - wi) * ((1.0 - wj) * T00[n] + wj * T01[n]) +
+            wi * ((1.0 - wj) * T10[n] + wj * T11[n]);
+    }
+    return;
+}
+Real InverseEos(const Material *mat, const Real rho, const Real p)
+{
+    Real wi = 0.0; /* interpolation weight */
+    const int i = TableCell(rho - mat->t0[0], mat->dd[0], mat->tn[0], &wi);
+    const Real (*T0)[EOSN] = (const Real (*)[EOSN])(mat->tab + i * mat->tn[1]);
+    const Real (*T1)[EOSN] = T0 + mat->tn[1];
+    /* bisection for the internal energy interval that brackets p */
+    int jL = 0, jR = mat->tn[1] - 1, jM = 0;
+    while (1 < jR - jL) {
+        jM = (jL + jR) / 2;
+        if (p < (1.0 - wi) * T0[jM][EOSP] + wi * T1[jM][EOSP]) {
+            jR = jM;
+        } else {
+            jL = jM;
+        }
+    }
+    const Real pL = (1.0 - wi) * T0[jL][EOSP] + wi * T1[jL][EOSP];
+    const Real pR = (1.0 - wi) * T0[jR][EOSP] + wi * T1[jR][EOSP];
+    const Real eL = mat->t0[1] + jL / mat->dd[1];
+    if (0.0 == pR - pL) {
+        return eL;
+    }
+    /* linear interpolation, extrapolation beyond the table */
+    return eL + (p - pL) / (pR - pL) / mat->dd[1];
+}
+/*
+ * The temperature along a density entry at fixed pressure is found by the
+ * inverse lookup of the internal energy, and the density interval that
+ * brackets T is located by bisection over the density entries.
+ */
+Real DensityEos(const Material *mat, const Real p, const Real T)
+{
+    int iL = 0, iR = mat->tn[0] - 1, iM = 0;
+    const int fall = (IsobaricTemperature(mat, mat->t0[0] + iR / mat->dd[0], p) <
+            IsobaricTemperature(mat, mat->t0[0], p)); /* temperature falls with density */
+    while (1 < iR - iL) {
+        iM = (iL + iR) / 2;
+        if ((T < IsobaricTemperature(mat, mat->t0[0] + iM / mat->dd[0], p)) == fall) {
+            iL = iM;
+        } else {
+            iR = iM;
+        }
+    }
+    const Real rhoL = mat->t0[0] + iL / mat->dd[0];
+    const Real TL = IsobaricTemperature(mat, rhoL, p);
+    const Real TR = IsobaricTemperature(mat, mat->t0[0] + iR / mat->dd[0], p);
+    if (0.0 == TR - TL) {
+        return rhoL;
+    }
+    /* linear interpolation, extrapolation beyond the table */
+    return rhoL + (T - TL) / (TR - TL) / mat->dd[0];
+}
+static Real IsobaricTemperature(const Material *mat, const Real rho, const Real p)
+{
+    Real pTc[EOSN] = {0.0};
+    LookupEos(mat, rho, InverseEos(mat, rho, p), pTc);
+    return pTc[EOST];
+}
+/* a good practice: end file with a newline */
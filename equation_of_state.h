@@ -0,0 +1,60 @@
+/****************************************************************************
+ *                              ArtraCFD                                    *
+ *                          <By Huangrui Mo>                                *
+ * Copyright (C) Huangrui Mo <huangrui.mo@gmail.com>                        *
+ * This file is part of ArtraCFD.                                           *
+ * ArtraCFD is free software: you can redistribute it and/or modify it      *
+ * under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or        *
+ * (at your option) any later version.                                      *
+ ****************************************************************************/
+/****************************************************************************
+ * Header File Guards to Avoid Interdependence
+ ****************************************************************************/
+#ifndef ARTRACFD_EQUATION_OF_STATE_H_ /* if undefined */
+#define ARTRACFD_EQUATION_OF_STATE_H_ /* set a unique marker */
+/****************************************************************************
+ * Required Header Files
+ ****************************************************************************/
+#include "commons.h"
+/****************************************************************************
+ * Data Structure Declarations
+ ****************************************************************************/
+/****************************************************************************
+ * Public Functions Declaration
+ ****************************************************************************/
+/*
+ * Equation of state loader
+ *
+ * Function
+ *      Load the tabulated equation of state from artracfd.eos and normalize
+ *      it by the reference values. Nothing is done for the ideal gas.
+ */
+extern void LoadEquationOfState(Model *);
+/*
+ * Tabulated equation of state lookup
+ *
+ * Function
+ *      Bilinear interpolation of pressure, temperature and speed of sound
+ *      from density and specific internal energy. States outside the table
+ *      are clamped to the table boundary.
+ */
+extern void LookupEos(const Material *, const Real rho, const Real e, Real pTc[restrict]);
+/*
+ * Inverse lookup
+ *
+ * Function
+ *      Return the specific internal energy for given density and pressure,
+ *      assuming pressure increases monotonically with internal energy.
+ */
+extern Real InverseEos(const Material *, const Real rho, const Real p);
+/*
+ * Density lookup
+ *
+ * Function
+ *      Return the density for given pressure and temperature, assuming
+ *      temperature changes monotonically with density at fixed pressure.
+ */
+extern Real DensityEos(const Material *, const Real p, const Real T);
+#endif
+/* a good practice: end file with a newline */
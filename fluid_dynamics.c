@@ -12,24 +12,65 @@
  * Required Header Files
  ****************************************************************************/
 #include "fluid_dynamics.h"
+#include <stdio.h> /* standard library for input and output */
+#include <string.h> /* manipulating strings */
+#include <math.h> /* common mathematical functions */
+#include <float.h> /* size of floating point values */
 #include "convective_flux.h"
 #include "diffusive_flux.h"
 #include "source_term.h"
 #include "boundary_treatment.h"
+#include "domain_partition.h"
 #include "cfd_commons.h"
 #include "commons.h"
 /****************************************************************************
  * Function Pointers
  ****************************************************************************/
 typedef void (*TimeIntegrator)(const Real, const int, Space *, const Model *);
+/****************************************************************************
+ * Data Structure Declarations
+ ****************************************************************************/
+typedef struct {
+    Real dt; /* time step */
+    Real coeA; /* coefficient of the base time level */
+    Real coeB; /* coefficient of the operator time level */
+    int to; /* base time level */
+    int tn; /* operator time level */
+    int tm; /* target time level */
+    int p; /* solution operator */
+    Space *space; /* space */
+    const Model *model; /* model */
+} SweepTask;
+typedef struct {
+    Real dt; /* physical time step */
+    Real coe[3]; /* backward differentiation coefficients of U(n+1), U(n), U(n-1) */
+    Real alpha; /* pseudo time stage coefficient */
+    int tn; /* stage time level */
+    int tm; /* target time level */
+    Real *res; /* squared momentum residual of each work unit */
+    Real *mag; /* squared acoustic momentum scale of each work unit */
+    const DualTime *dual; /* history of dual time stepping */
+    Space *space; /* space */
+    const Model *model; /* model */
+} PseudoTask;
 /****************************************************************************
  * Static Function Declarations
  ****************************************************************************/
+static void MergeSplitting(const Real, const int, Real *, Space *, const Model *);
+static int SweepOrder(const int, int [restrict]);
 static void DiscretizeTime(const Real, const int, Space *, const Model *);
+static void EvolveSource(const Real, Space *, const Model *);
+static void CompleteStep(const Real, Space *, const Model *);
 static void RungeKutta2(const Real, const int, Space *, const Model *);
 static void RungeKutta3(const Real, const int, Space *, const Model *);
+static void RungeKutta54(const Real, const int, Space *, const Model *);
+static void RungeKutta104(const Real, const int, Space *, const Model *);
+static void CombineLevels(const Real, const Real, const int, const int, const int, Space *);
+static void CombineUnit(const int, void *);
+static void PseudoUnit(const int, void *);
 static void LLLU(const Real, const Real, const Real, const int,
         const int, const int, const int, Space *, const Model *);
+static void SweepUnit(const int, void *);
 static void LU(const Real [restrict], const Real [restrict],
         const Real [restrict], const Real [restrict], Real [restrict]);
 static void SolveOperator(const int, const int, const Real, const Real,
@@ -38,9 +79,11 @@ static void SolveOperator(const int, const int, const Real, const Real,
 /****************************************************************************
  * Global Variables Definition with Private Scope
  ****************************************************************************/
-static TimeIntegrator IntegrateTime[2] = {
+static TimeIntegrator IntegrateTime[4] = {
     RungeKutta2,
-    RungeKutta3};
+    RungeKutta3,
+    RungeKutta54,
+    RungeKutta104};
 /****************************************************************************
  * Function definitions
  ****************************************************************************/
@@ -52,13 +95,19 @@ static TimeIntegrator IntegrateTime[2] = {
  *   a) - operator splitting
  *   b) - operator-by-operator approximation
  */
-void EvolveFluidDynamics(const Real dt, Space *space, const Model *model)
+void EvolveFluidDynamics(const Real dt, const int sync, Real *lag,
+        Space *space, const Model *model)
 {
     if (0 != model->sState) {
-        DiscretizeTime(0.5 * dt, PHI, space, model);
+        EvolveSource(0.5 * dt, space, model);
+        TreatBoundary(TO, 0.0, space, model);
     }
     switch (model->multidim) {
         case OPTSPLIT:
+            if (MERGEN != model->merge) {
+                MergeSplitting(dt, sync, lag, space, model);
+                break;
+            }
             switch (space->part.collapse) {
                 case COLLAPSEN:
                     DiscretizeTime(0.5 * dt, Z, space, model);
@@ -109,14 +158,323 @@ void EvolveFluidDynamics(const Real dt, Space *space, const Model *model)
         default:
             break;
     }
+    CompleteStep(dt, space, model);
+    return;
+}
+/*
+ * Merged Strang splitting.
+ * The split sequence Z(dt/2) Y(dt/2) X(dt/2) X(dt/2) Y(dt/2) Z(dt/2) is
+ * advanced as Z(dt/2) Y(dt/2) X(dt) Y(dt/2) Z(dt/2). Since the two merged
+ * half sweeps solve the same operator back to back, the composition, and
+ * hence the second order splitting error, is unchanged; only the error of
+ * the one dimensional time integrator over the merged sweep differs, which
+ * is of the order of the integrator itself. However, a merged sweep has
+ * the full CFL number of the step instead of half of it, therefore merging
+ * is only enabled for CFL numbers within the one dimensional limit 1.
+ *
+ * When merging across steps, the trailing half sweep of a step is deferred
+ * into lag and fused with the leading half sweep of the next step. The
+ * field data between steps are then not synchronized to a time instant,
+ * therefore a step is synchronized (sync) before data output or solid
+ * dynamics, and merging across steps is disabled with source terms. The
+ * deferred sweep is fused only if the fused sweep does not exceed the
+ * current time step, otherwise it is performed separately.
+ */
+static void MergeSplitting(const Real dt, const int sync, Real *lag,
+        Space *space, const Model *model)
+{
+    int order[DIMS] = {0}; /* sweep directions from outer to inner */
+    const int sN = SweepOrder(space->part.collapse, order);
+    if (0 == sN) {
+        return;
+    }
+    if (0.5 * dt < *lag) {
+        DiscretizeTime(*lag, order[0], space, model);
+        *lag = 0.0;
+    }
+    if (1 == sN) {
+        DiscretizeTime(dt + *lag, order[0], space, model);
+        *lag = 0.0;
+        return;
+    }
+    DiscretizeTime(0.5 * dt + *lag, order[0], space, model);
+    for (int n = 1; n < sN - 1; ++n) {
+        DiscretizeTime(0.5 * dt, order[n], space, model);
+    }
+    DiscretizeTime(dt, order[sN-1], space, model);
+    for (int n = sN - 2; n > 0; --n) {
+        DiscretizeTime(0.5 * dt, order[n], space, model);
+    }
+    if ((MERGEALL == model->merge) && (0 == sync) && (0 == model->sState)) {
+        *lag = 0.5 * dt;
+        return;
+    }
+    DiscretizeTime(0.5 * dt, order[0], space, model);
+    *lag = 0.0;
+    return;
+}
+/*
+ * Dual time stepping.
+ * (a0 U(n+1) + a1 U(n) + a2 U(n-1)) / dt - LU(n+1) = R*(U(n+1)) = 0 is the
+ * second order backward differentiation with variable steps, reduced to
+ * the first order one without history. It is solved by marching
+ * P^-1 dU/dtau + R*(U) = 0 to a steady state in pseudo time, where the
+ * preconditioner P and the preconditioned flux dissipation make both the
+ * pseudo time step and the upwinding scale with the flow speed rather than
+ * the speed of sound. The preconditioning parameter is bounded below by
+ * the squared maximum Mach number of the step. The pseudo time is advanced
+ * by a three stage scheme with local time steps, with the physical time
+ * derivative treated point implicitly at each stage. Iterations stop when
+ * the momentum residual, which carries the convective dynamics of the
+ * step, is reduced by the tolerance, or falls to the round-off of the
+ * acoustic momentum scale over the step, where a converged state such as
+ * a uniform flow cannot reduce it further; the pressure relaxes with the
+ * pseudo acoustic waves and is bounded by the iteration count.
+ * Weiss, J. M., & Smith, W. A. (1995). Preconditioning applied to variable
+ * and constant density flows. AIAA Journal, 33(11), 2050-2057.
+ */
+void EvolveDualTime(const Real dt, const Real mach, DualTime *dual, Space *space, const Model *model)
+{
+    const Partition *const part = &(space->part);
+    Node *const node = space->node;
+    const int nodeN = part->n[Z] * part->n[Y] * part->n[X];
+    const Real alpha[3] = {0.1918, 0.4929, 1.0}; /* pseudo time stage coefficients */
+    if (NULL == dual->Un) {
+        dual->Un = AssignStorage(nodeN * sizeof(*dual->Un));
+        dual->Uh = AssignStorage(nodeN * sizeof(*dual->Uh));
+    }
+    if (0 != model->sState) {
+        EvolveSource(0.5 * dt, space, model);
+        TreatBoundary(TO, 0.0, space, model);
+    }
+    Model pre = *model; /* model with preconditioned flux dissipation */
+    const Real cut = MaxReal(mach, 1.0 / model->pcStep);
+    pre.pcCut = cut * cut;
+    const Real w = (0.0 < dual->dt) ? dt / dual->dt : 0.0; /* step ratio */
+    Real res[part->unitN]; /* squared momentum residual of each work unit */
+    Real mag[part->unitN]; /* squared acoustic momentum scale of each work unit */
+    PseudoTask task = {.dt = dt, .coe = {(1.0 + 2.0 * w) / (1.0 + w), -(1.0 + w), w * w / (1.0 + w)},
+        .alpha = 0.0, .tn = TO, .tm = TO, .res = res, .mag = mag, .dual = dual, .space = space, .model = &pre};
+    for (int idx = 0; idx < nodeN; ++idx) {
+        memcpy(dual->Un[idx], node[idx].U[TO], DIMU * sizeof(*dual->Un[idx]));
+    }
+    Real res0 = 0.0; /* residual of the first iteration */
+    Real resN = 0.0; /* residual of the current iteration */
+    Real magN = 0.0; /* acoustic momentum scale of the current iteration */
+    int n = 0; /* pseudo time iteration count */
+    while (n < model->pcIter) {
+        ++n;
+        for (int m = 0; m < 3; ++m) {
+            task.alpha = alpha[m];
+            task.tn = (0 == m) ? TO : TN;
+            task.tm = (2 == m) ? TO : TN;
+            for (int u = 0; u < part->unitN; ++u) {
+                res[u] = 0.0;
+                mag[u] = 0.0;
+            }
+            /* TM = (I + dt*L)U of the stage level */
+            LLLU(dt, 0.0, 1.0, task.tn, task.tn, TM, DIMS, space, &pre);
+            RunWorkUnits(part, PseudoUnit, &task);
+            TreatBoundary(task.tm, dt, space, model);
+            if (0 == m) {
+                resN = 0.0;
+                magN = 0.0;
+                for (int u = 0; u < part->unitN; ++u) {
+                    resN = resN + res[u];
+                    magN = magN + mag[u];
+                }
+            }
+        }
+        if (1 == n) {
+            res0 = resN;
+        }
+        if ((model->pcTol * model->pcTol * res0 >= resN) ||
+                (DBL_EPSILON * DBL_EPSILON * magN >= dt * dt * resN)) {
+            break;
+        }
+    }
+    /* the current time level becomes the last one */
+    Real (*restrict U)[DIMU] = dual->Uh;
+    dual->Uh = dual->Un;
+    dual->Un = U;
+    dual->dt = dt;
+    ShowInfo("  dual time: iterations=%d; residual=%.6g\n", n,
+            (0.0 < res0) ? sqrt(resN / res0) : 0.0);
+    CompleteStep(dt, space, model);
+    return;
+}
+/*
+ * A pseudo time stage Um = Uo + dUm with
+ * (P^-1 + alpha dtau a0 / dt) dUm = -alpha dtau R*(Un).
+ * With P^-1 = I + (1 / beta2 - 1) a b' and b'a = 1, the inversion is in
+ * closed form by the Sherman-Morrison formula. The local pseudo time step
+ * is bounded by the preconditioned spectral radii in all directions.
+ */
+static void PseudoUnit(const int m, void *arg)
+{
+    const PseudoTask *const task = arg;
+    const Model *const model = task->model;
+    const Partition *const part = &(task->space->part);
+    int (*const box)[LIMIT] = part->unit[m]; /* node box of the unit */
+    Node *const node = task->space->node;
+    const Real cfl = 2.0; /* pseudo time CFL number */
+    int idx = 0; /* linear array index math variable */
+    const Real *restrict Un = NULL; /* stage level */
+    Real Uo[DIMUo] = {0.0}; /* primitive variables of the stage level */
+    Real Lambda[DIMU] = {0.0}; /* preconditioned eigenvalues */
+    Real R[DIMU] = {0.0}; /* dual time residual */
+    Real a[DIMU] = {0.0}; /* pressure derivative of U */
+    Real gamma = 0.0, beta2 = 0.0, rate = 0.0, dtau = 0.0, eps = 0.0, kappa = 0.0, theta = 0.0, bR = 0.0;
+    Real res = 0.0; /* squared momentum residual */
+    Real mag = 0.0; /* squared acoustic momentum scale */
+    for (int k = box[Z][MIN]; k < box[Z][MAX]; ++k) {
+        for (int j = box[Y][MIN]; j < box[Y][MAX]; ++j) {
+            for (int i = box[X][MIN]; i < box[X][MAX]; ++i) {
+                idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
+                if (0 != node[idx].did) {
+                    continue;
+                }
+                Un = node[idx].U[task->tn];
+                for (int n = 0; n < DIMU; ++n) {
+                    R[n] = ((task->coe[0] + 1.0) * Un[n] + task->coe[1] * task->dual->Un[idx][n] +
+                        task->coe[2] * task->dual->Uh[idx][n] - node[idx].U[TM][n]) / task->dt;
+                }
+                res = res + R[1] * R[1] + R[2] * R[2] + R[3] * R[3];
+                gamma = SymmetricAverage(0, model, Un, Un, Uo);
+                mag = mag + Un[0] * Un[0] * Uo[5] * Uo[5];
+                beta2 = PreconditionParameter(model->pcCut, Uo);
+                rate = 0.0;
+                for (int s = 0; s < DIMS; ++s) {
+                    PreconditionedEigenvalue(s, beta2, Uo, Lambda);
+                    rate = rate + MaxReal(fabs(Lambda[0]), fabs(Lambda[4])) * part->dd[s];
+                }
+                dtau = task->alpha * cfl / rate; /* pseudo time step of the stage */
+                eps = dtau * task->coe[0] / task->dt;
+                kappa = 1.0 / beta2 - 1.0;
+                theta = kappa / (1.0 + eps + kappa);
+                a[0] = 1.0 / (Uo[5] * Uo[5]);
+                a[1] = Uo[1] * a[0];
+                a[2] = Uo[2] * a[0];
+                a[3] = Uo[3] * a[0];
+                a[4] = Uo[4] * a[0];
+                bR = (gamma - 1.0) * (0.5 * (Uo[1] * Uo[1] + Uo[2] * Uo[2] + Uo[3] * Uo[3]) * R[0] -
+                        Uo[1] * R[1] - Uo[2] * R[2] - Uo[3] * R[3] + R[4]);
+                for (int n = 0; n < DIMU; ++n) {
+                    node[idx].U[task->tm][n] = node[idx].U[TO][n] - dtau / (1.0 + eps) * (R[n] - theta * a[n] * bR);
+                }
+            }
+        }
+    }
+    task->res[m] = res;
+    task->mag[m] = mag;
+    return;
+}
+void FinalizeFluidDynamics(DualTime *dual)
+{
+    RetrieveStorage(dual->Un);
+    RetrieveStorage(dual->Uh);
+    memset(dual, 0, sizeof(*dual)); /* ready for another run */
+    return;
+}
+void SynchronizeFluidDynamics(Real *lag, Space *space, const Model *model)
+{
+    int order[DIMS] = {0}; /* sweep directions from outer to inner */
+    if ((0.0 < *lag) && (0 < SweepOrder(space->part.collapse, order))) {
+        DiscretizeTime(*lag, order[0], space, model);
+    }
+    *lag = 0.0;
+    return;
+}
+/*
+ * Active sweep directions in the order Z, Y, X with collapsed ones removed.
+ */
+static int SweepOrder(const int collapse, int order[restrict])
+{
+    switch (collapse) {
+        case COLLAPSEN:
+            order[0] = Z; order[1] = Y; order[2] = X;
+            return 3;
+        case COLLAPSEX:
+            order[0] = Z; order[1] = Y;
+            return 2;
+        case COLLAPSEY:
+            order[0] = Z; order[1] = X;
+            return 2;
+        case COLLAPSEZ:
+            order[0] = Y; order[1] = X;
+            return 2;
+        case COLLAPSEXY:
+            order[0] = Z;
+            return 1;
+        case COLLAPSEXZ:
+            order[0] = Y;
+            return 1;
+        case COLLAPSEYZ:
+            order[0] = X;
+            return 1;
+        default:
+            return 0;
+    }
+}
+/*
+ * Trial sweep for performance measurement.
+ * Only the first stage is performed and written to the TN data space,
+ * the TO data space is left untouched.
+ */
+void SweepFluidDynamics(const Real dt, const int s, Space *space, const Model *model)
+{
+    LLLU(dt, 0.0, 1.0, TO, TO, TN, s, space, model);
+    TreatBoundary(TN, dt, space, model);
+    return;
+}
+/*
+ * dU/dt = Phi(U)
+ * The source operator is local, hence it is integrated pointwise in the TO
+ * data space and the boundary is treated once by the caller, instead of
+ * advancing it by the Runge-Kutta stages with boundary treatment after
+ * each stage.
+ */
+static void EvolveSource(const Real dt, Space *space, const Model *model)
+{
+    const Partition *const part = &(space->part);
+    Node *const node = space->node;
+    int idx = 0; /* linear array index math variable */
+    for (int k = part->np[X][Z][MIN]; k < part->np[X][Z][MAX]; ++k) {
+        for (int j = part->np[X][Y][MIN]; j < part->np[X][Y][MAX]; ++j) {
+            for (int i = part->np[X][X][MIN]; i < part->np[X][X][MAX]; ++i) {
+                idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
+                if (0 != node[idx].did) {
+                    continue;
+                }
+                IntegratePhi(dt, model, node[idx].U[TO]);
+            }
+        }
+    }
+    return;
+}
+/*
+ * The second half of the source operator and the sponge layer relaxation
+ * are pointwise in the TO data space and share one boundary treatment.
+ */
+static void CompleteStep(const Real dt, Space *space, const Model *model)
+{
+    if ((0 == model->sState) && (0.0 >= space->part.sponge[0])) {
+        return;
+    }
     if (0 != model->sState) {
-        DiscretizeTime(0.5 * dt, PHI, space, model);
+        EvolveSource(0.5 * dt, space, model);
     }
+    if (0.0 < space->part.sponge[0]) {
+        RelaxSpongeLayer(dt, space, model);
+    }
+    TreatBoundary(TO, 0.0, space, model); /* boundary state of the step is already relaxed */
     return;
 }
 /*
  * dU/dt = LU
  * Computation must start from TO data space and end with TO data space.
+ * The boundary treatment of each stage receives the time of the stage
+ * measured from the TO time level.
  */
 static void DiscretizeTime(const Real dt, const int s, Space *space, const Model *model)
 {
@@ -127,23 +485,135 @@ static void RungeKutta2(const Real dt, const int s, Space *space, const Model *m
 {
     /* solve U1 = LLLU = 0.0 * Un + 1.0 * LLUn */
     LLLU(dt, 0.0, 1.0, TO, TO, TN, s, space, model);
-    TreatBoundary(TN, space, model);
+    TreatBoundary(TN, dt, space, model);
     /* solve U(n+1) = LLLU = 1.0/2.0 * Un + 1.0/2.0 * LLU1 */
     LLLU(dt, 1.0/2.0, 1.0/2.0, TO, TN, TO, s, space, model);
-    TreatBoundary(TO, space, model);
+    TreatBoundary(TO, dt, space, model);
     return;
 }
 static void RungeKutta3(const Real dt, const int s, Space *space, const Model *model)
 {
     /* solve U1 = LLLU = 0.0 * Un + 1.0 * LLUn */
     LLLU(dt, 0.0, 1.0, TO, TO, TN, s, space, model);
-    TreatBoundary(TN, space, model);
+    TreatBoundary(TN, dt, space, model);
     /* solve U2 = LLLU = 3.0/4.0 * Un + 1.0/4.0 * LLU1 */
     LLLU(dt, 3.0/4.0, 1.0/4.0, TO, TN, TM, s, space, model);
-    TreatBoundary(TM, space, model);
+    TreatBoundary(TM, 0.5 * dt, space, model);
     /* solve U(n+1) = LLLU = 1.0/3.0 * Un + 2.0/3.0 * LLU2 */
     LLLU(dt, 1.0/3.0, 2.0/3.0, TO, TM, TO, s, space, model);
-    TreatBoundary(TO, space, model);
+    TreatBoundary(TO, dt, space, model);
+    return;
+}
+/*
+ * Five stage fourth order SSP Runge-Kutta with SSP coefficient 1.508.
+ * The fifth stage combines Un, U2, U3, LLU3, U4 and LLU4. Since U4 is
+ * formed from Un, U3 and LLU3, the contribution of U3 and LLU3 is
+ * replaced by that of U4 and Un, which leaves the register combination
+ * Q = 0.517231671970585 * U2 - 0.020812619136066 * Un for the last stage.
+ * U4 is held in TO, whose boundary treatment relaxes the boundary state
+ * over the time of the fourth stage, hence the last treatment relaxes it
+ * over the rest of the step.
+ * Spiteri, R. J., & Ruuth, S. J. (2002). A new class of optimal high-order
+ * strong-stability-preserving time discretization methods. SIAM Journal on
+ * Numerical Analysis, 40(2), 469-491.
+ */
+static void RungeKutta54(const Real dt, const int s, Space *space, const Model *model)
+{
+    const Real c4 = 0.935010630967653; /* time of the fourth stage */
+    /* solve U1 = LLLU = 0.0 * Un + 1.0 * LLUn */
+    LLLU(0.391752226571890 * dt, 0.0, 1.0, TO, TO, TN, s, space, model);
+    TreatBoundary(TN, 0.391752226571890 * dt, space, model);
+    /* solve U2 = LLLU = 0.444370493651235 * Un + 0.555629506348765 * LLU1 */
+    LLLU(0.663050807850946 * dt, 0.444370493651235, 0.555629506348765, TO, TN, TM, s, space, model);
+    TreatBoundary(TM, 0.586079689311540 * dt, space, model);
+    /* solve U3 = LLLU = 0.620101851488403 * Un + 0.379898148511597 * LLU2 */
+    LLLU(0.663050807850949 * dt, 0.620101851488403, 0.379898148511597, TO, TM, TN, s, space, model);
+    TreatBoundary(TN, 0.474542363121400 * dt, space, model);
+    /* register Q = 0.517231671970585 * U2 - 0.020812619136066 * Un */
+    CombineLevels(-0.020812619136066, 0.517231671970585, TO, TM, TM, space);
+    /* solve U4 = LLLU = 0.178079954393132 * Un + 0.821920045606868 * LLU3 */
+    LLLU(0.663050807850947 * dt, 0.178079954393132, 0.821920045606868, TO, TN, TO, s, space, model);
+    TreatBoundary(TO, c4 * dt, space, model);
+    /* solve U(n+1) = LLLU = 1.0 * Q + 0.503580947165482 * LLU4 */
+    LLLU(0.448800703261391 * dt, 1.0, 0.503580947165482, TM, TO, TM, s, space, model);
+    CombineLevels(0.0, 1.0, TO, TM, TO, space);
+    TreatBoundary(TO, (1.0 - c4) * dt, space, model);
+    return;
+}
+/*
+ * Ten stage fourth order SSP Runge-Kutta with SSP coefficient 6, that is,
+ * six tenths of a forward Euler step per stage. The two register form is
+ * held in TO, TN and TM: stages alternate between TN and TM, and the
+ * intermediate combination of the scheme is folded into the fifth stage
+ * and a pointwise update of TO.
+ * Ketcheson, D. I. (2008). Highly efficient strong stability-preserving
+ * Runge-Kutta methods with low-storage implementations. SIAM Journal on
+ * Scientific Computing, 30(4), 2113-2136.
+ */
+static void RungeKutta104(const Real dt, const int s, Space *space, const Model *model)
+{
+    const Real h = dt / 6.0;
+    /* solve U1 to U4 = LLU of the previous stage */
+    LLLU(h, 0.0, 1.0, TO, TO, TN, s, space, model);
+    TreatBoundary(TN, h, space, model);
+    LLLU(h, 0.0, 1.0, TO, TN, TM, s, space, model);
+    TreatBoundary(TM, 2.0 * h, space, model);
+    LLLU(h, 0.0, 1.0, TO, TM, TN, s, space, model);
+    TreatBoundary(TN, 3.0 * h, space, model);
+    LLLU(h, 0.0, 1.0, TO, TN, TM, s, space, model);
+    TreatBoundary(TM, 4.0 * h, space, model);
+    /* solve U5 = LLLU = 3.0/5.0 * Un + 2.0/5.0 * LLU4 */
+    LLLU(h, 3.0/5.0, 2.0/5.0, TO, TM, TN, s, space, model);
+    TreatBoundary(TN, 2.0 * h, space, model);
+    /* second register Q = 9.0/10.0 * U5 - 1.0/2.0 * Un */
+    CombineLevels(-1.0/2.0, 9.0/10.0, TO, TN, TO, space);
+    /* solve U6 to U9 = LLU of the previous stage */
+    LLLU(h, 0.0, 1.0, TO, TN, TM, s, space, model);
+    TreatBoundary(TM, 3.0 * h, space, model);
+    LLLU(h, 0.0, 1.0, TO, TM, TN, s, space, model);
+    TreatBoundary(TN, 4.0 * h, space, model);
+    LLLU(h, 0.0, 1.0, TO, TN, TM, s, space, model);
+    TreatBoundary(TM, 5.0 * h, space, model);
+    LLLU(h, 0.0, 1.0, TO, TM, TN, s, space, model);
+    TreatBoundary(TN, dt, space, model);
+    /* solve U(n+1) = LLLU = 1.0 * Q + 3.0/5.0 * LLU9 */
+    LLLU(h, 1.0, 3.0/5.0, TO, TN, TO, s, space, model);
+    TreatBoundary(TO, dt, space, model);
+    return;
+}
+/*
+ * Pointwise linear combination of time levels.
+ * Um = coeA * Uo + coeB * Un on the nodes updated by LLLU.
+ */
+static void CombineLevels(const Real coeA, const Real coeB, const int to,
+        const int tn, const int tm, Space *space)
+{
+    SweepTask task = {.dt = 0.0, .coeA = coeA, .coeB = coeB, .to = to,
+        .tn = tn, .tm = tm, .p = NONE, .space = space, .model = NULL};
+    RunWorkUnits(&(space->part), CombineUnit, &task);
+    return;
+}
+static void CombineUnit(const int m, void *arg)
+{
+    const SweepTask *const task = arg;
+    const Partition *const part = &(task->space->part);
+    int (*const box)[LIMIT] = part->unit[m]; /* node box of the unit */
+    Node *const node = task->space->node;
+    int idx = 0; /* linear array index math variable */
+    for (int k = box[Z][MIN]; k < box[Z][MAX]; ++k) {
+        for (int j = box[Y][MIN]; j < box[Y][MAX]; ++j) {
+            for (int i = box[X][MIN]; i < box[X][MAX]; ++i) {
+                idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
+                if (0 != node[idx].did) {
+                    continue;
+                }
+                for (int n = 0; n < DIMU; ++n) {
+                    node[idx].U[task->tm][n] = task->coeA * node[idx].U[task->to][n] +
+                        task->coeB * node[idx].U[task->tn][n];
+                }
+            }
+        }
+    }
     return;
 }
 /*
@@ -157,22 +627,51 @@ static void RungeKutta3(const Real dt, const int s, Space *space, const Model *m
 static void LLLU(const Real dt, const Real coeA, const Real coeB, const int to,
         const int tn, const int tm, const int p, Space *space, const Model *model)
 {
-    const Partition *const part = &(space->part);
-    Node *const node = space->node;
+    SweepTask task = {.dt = dt, .coeA = coeA, .coeB = coeB, .to = to,
+        .tn = tn, .tm = tm, .p = p, .space = space, .model = model};
+    RunWorkUnits(&(space->part), SweepUnit, &task);
+    return;
+}
+/*
+ * Sweep the nodes of a work unit. Each node update only writes the node
+ * itself, therefore units are independent of each other.
+ */
+static void SweepUnit(const int m, void *arg)
+{
+    const SweepTask *const task = arg;
+    const Real dt = task->dt;
+    const Real coeA = task->coeA;
+    const Real coeB = task->coeB;
+    const int to = task->to;
+    const int tn = task->tn;
+    const int tm = task->tm;
+    const int p = task->p;
+    const Model *const model = task->model;
+    const Partition *const part = &(task->space->part);
+    int (*const box)[LIMIT] = part->unit[m]; /* node box of the unit */
+    Node *const node = task->space->node;
+    const int np[DIMS][DIMS][LIMIT] = { /* unit node range with dimension priority */
+        {{box[X][MIN], box[X][MAX]}, {box[Y][MIN], box[Y][MAX]}, {box[Z][MIN], box[Z][MAX]}},
+        {{box[Y][MIN], box[Y][MAX]}, {box[X][MIN], box[X][MAX]}, {box[Z][MIN], box[Z][MAX]}},
+        {{box[Z][MIN], box[Z][MAX]}, {box[X][MIN], box[X][MAX]}, {box[Y][MIN], box[Y][MAX]}}};
     int idx = 0; /* linear array index math variable */
     int i = 0, j = 0, k = 0; /* index with normal order */
     const int h[DIMS][DIMS] = {{1, 0, 0}, {0, 1, 0}, {0, 0, 1}}; /* direction indicator */
-    Real RHS[5][DIMU] = {{0.0}}; /* spatial operator */
-    Real *restrict FhatR = RHS[0]; /* reconstructed numerical convective flux vector */
-    Real *restrict FhatL = RHS[1]; /* reconstructed numerical convective flux vector */
-    Real *restrict FvhatR = RHS[2]; /* reconstructed numerical diffusive flux vector */
-    Real *restrict FvhatL = RHS[3]; /* reconstructed numerical diffusive flux vector */
-    Real *restrict Phi = RHS[4]; /* right hand side vector */
-    Real *temp = NULL;
+    Real Fhat[TILEN][2][DIMU] = {{{0.0}}}; /* reconstructed numerical convective flux vector of each pencil */
+    Real Fvhat[TILEN][2][DIMU] = {{{0.0}}}; /* reconstructed numerical diffusive flux vector of each pencil */
+    int state[TILEN] = {0}; /* flux inheritance state of each pencil */
+    int side[TILEN] = {0}; /* storage slot of the left interface flux of each pencil */
+    Real Phi[DIMU] = {0.0}; /* right hand side vector */
     const IntVec partn = {part->n[X], part->n[Y], part->n[Z]};
     const RealVec dd = {part->dd[X], part->dd[Y], part->dd[Z]};
     const RealVec r = {dt * dd[X], dt * dd[Y], dt * dd[Z]};
     int s = 0, sN = 0; /* space sweep control for the operator p */
+    int tw = 0, td = 0; /* tile width and depth */
+    int nw = 0, nd = 0; /* number of tiles along width and depth */
+    int jt = 0, kt = 0; /* first pencil of current tile */
+    int jN = 0; /* number of pencils along the width of current tile */
+    int js = 0, ks = 0; /* pencil of current tile */
+    int tN = 0; /* number of pencils in current tile */
     switch (p) {
         case PHI: /* source term */
             s = 0; sN = s + 1;
@@ -184,11 +683,36 @@ static void LLLU(const Real dt, const Real coeA, const Real coeB, const int to,
             s = p; sN = s + 1;
             break;
     }
-    /* space sweep with dimension priority */
+    /*
+     * Space sweep with dimension priority. Adjacent pencils are grouped
+     * into tiles of width by depth pencils and advanced together along the
+     * sweep direction, so that for Y and Z sweeps consecutive accesses hit
+     * neighbouring nodes in memory. Tiles are visited with either the depth
+     * or the width index outer. Each node update only reads its own pencil,
+     * therefore the result is independent of the tile shape and order.
+     */
     for (; s < sN; ++s) {
-        for (int ks = part->np[s][Z][MIN]; ks < part->np[s][Z][MAX]; ++ks) {
-            for (int js = part->np[s][Y][MIN]; js < part->np[s][Y][MAX]; ++js) {
-                for (int is = part->np[s][X][MIN], state = 0; is < part->np[s][X][MAX]; ++is) {
+        tw = part->tile[s];
+        td = part->depth[s];
+        nw = (np[s][Y][MAX] - np[s][Y][MIN] + tw - 1) / tw;
+        nd = (np[s][Z][MAX] - np[s][Z][MIN] + td - 1) / td;
+        for (int q = 0; q < nw * nd; ++q) {
+            if (0 == part->order[s]) {
+                jt = np[s][Y][MIN] + (q % nw) * tw;
+                kt = np[s][Z][MIN] + (q / nw) * td;
+            } else {
+                jt = np[s][Y][MIN] + (q / nd) * tw;
+                kt = np[s][Z][MIN] + (q % nd) * td;
+            }
+            jN = MinInt(tw, np[s][Y][MAX] - jt);
+            tN = jN * MinInt(td, np[s][Z][MAX] - kt);
+            for (int t = 0; t < tN; ++t) {
+                state[t] = 0;
+            }
+            for (int is = np[s][X][MIN]; is < np[s][X][MAX]; ++is) {
+                for (int t = 0; t < tN; ++t) {
+                    js = jt + t % jN;
+                    ks = kt + t / jN;
                     switch (s) {
                         case X:
                             i = is; j = js; k = ks;
@@ -204,7 +728,7 @@ static void LLLU(const Real dt, const Real coeA, const Real coeB, const int to,
                     }
                     idx = IndexNode(k, j, i, partn[Y], partn[X]);
                     if (0 != node[idx].did) {
-                        state = 0; /* mark domain change and boundary occurrence */
+                        state[t] = 0; /* mark domain change and boundary occurrence */
                         continue;
                     }
                     switch (p) {
@@ -215,25 +739,20 @@ static void LLLU(const Real dt, const Real coeA, const Real coeB, const int to,
                         default:
                             break;
                     }
-                    switch (state) {
+                    switch (state[t]) {
                         case 1: /* inherit numerical flux from the previous node */
-                            temp = FhatL;
-                            FhatL = FhatR;
-                            FhatR = temp;
-                            temp = FvhatL;
-                            FvhatL = FvhatR;
-                            FvhatR = temp;
+                            side[t] = 1 - side[t];
                             break;
                         default: /* compute numerical flux at left interface */
-                            ComputeFhat(tn, s, k - h[s][Z], j - h[s][Y], i - h[s][X], partn, node, model, FhatL);
-                            ComputeFvhat(tn, s, k - h[s][Z], j - h[s][Y], i - h[s][X], partn, dd, node, model, FvhatL);
-                            state = 1;
+                            ComputeFhat(tn, s, k - h[s][Z], j - h[s][Y], i - h[s][X], partn, node, model, Fhat[t][side[t]]);
+                            ComputeFvhat(tn, s, k - h[s][Z], j - h[s][Y], i - h[s][X], partn, dd, node, model, Fvhat[t][side[t]]);
+                            state[t] = 1;
                             break;
                     }
-                    ComputeFhat(tn, s, k, j, i, partn, node, model, FhatR);
-                    ComputeFvhat(tn, s, k, j, i, partn, dd, node, model, FvhatR);
-                    LU(FhatR, FhatL, FvhatR, FvhatL, Phi);
-                    SolveOperator(model->multidim, s, coeA, coeB, node[idx].U[to], node[idx].U[tn], node[idx].U[tm], r[s], Phi);
+                    ComputeFhat(tn, s, k, j, i, partn, node, model, Fhat[t][1-side[t]]);
+                    ComputeFvhat(tn, s, k, j, i, partn, dd, node, model, Fvhat[t][1-side[t]]);
+                    LU(Fhat[t][1-side[t]], Fhat[t][side[t]], Fvhat[t][1-side[t]], Fvhat[t][side[t]], Phi);
+                    SolveOperator((DIMS == p) ? OPTBYOPT : OPTSPLIT, s, coeA, coeB, node[idx].U[to], node[idx].U[tn], node[idx].U[tm], r[s], Phi);
                 }
             }
         }
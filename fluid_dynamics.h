@@ -20,6 +20,11 @@
 /****************************************************************************
  * Data Structure Declarations
  ****************************************************************************/
+typedef struct {
+    Real dt; /* time step of the last dual time step; zero if no history */
+    Real (*restrict Un)[DIMU]; /* field data at the current time level */
+    Real (*restrict Uh)[DIMU]; /* field data at the last time level */
+} DualTime; /* history of dual time stepping */
 /****************************************************************************
  * Public Functions Declaration
  ****************************************************************************/
@@ -27,9 +32,44 @@
  * Fluid Dynamics
  *
  * Function
- *      Evolve fluid dynamics.
+ *      Evolve fluid dynamics. When split sweeps are merged across steps,
+ *      lag carries the deferred trailing sweep time between calls, and
+ *      sync forces the field data to be synchronized at the end of step.
  */
-extern void EvolveFluidDynamics(const Real dt, Space *, const Model *);
+extern void EvolveFluidDynamics(const Real dt, const int sync, Real *lag,
+        Space *, const Model *);
+/*
+ * Dual time stepping
+ *
+ * Function
+ *      Advance the fluid dynamics by an implicit step of size dt with
+ *      low Mach preconditioned pseudo time iterations. The preconditioning
+ *      is bounded below by mach, the maximum Mach number of the flow, and
+ *      by the inverse of the dual time step bound in acoustic steps.
+ *      The history of the last dual time step is kept in dual for second
+ *      order accuracy and released by FinalizeFluidDynamics. An explicit
+ *      step in between breaks the history, which is then reset by the
+ *      caller with a zero time step.
+ */
+extern void EvolveDualTime(const Real dt, const Real mach, DualTime *dual, Space *, const Model *);
+extern void FinalizeFluidDynamics(DualTime *dual);
+/*
+ * Split sweep synchronization
+ *
+ * Function
+ *      Perform the trailing sweep deferred in lag, such that the field data
+ *      are at a time instant before switching time integration schemes.
+ */
+extern void SynchronizeFluidDynamics(Real *lag, Space *, const Model *);
+/*
+ * Trial sweep
+ *
+ * Function
+ *      Perform one stage of the spatial operator s with boundary treatment
+ *      on the intermediate time level. Used for kernel timing only, the
+ *      field data at the current time level are not modified.
+ */
+extern void SweepFluidDynamics(const Real dt, const int s, Space *, const Model *);
 #endif
 /* a good practice: end file with a newline */
 
@@ -0,0 +1,114 @@
+/****************************************************************************
+ *                              ArtraCFD                                    *
+ *                          <By Huangrui Mo>                                *
+ * Copyright (C) Huangrui Mo <huangrui.mo@gmail.com>                        *
+ * This file is part of ArtraCFD.                                           *
+ * ArtraCFD is free software: you can redistribute it and/or modify it      *
+ * under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or        *
+ * (at your option) any later version.                                      *
+ ****************************************************************************/
+/****************************************************************************
+ * Required Header Files
+ ****************************************************************************/
+#include "geometry_order.h"
+#include <stdio.h> /* standard library for input and output */
+#include <string.h> /* manipulating strings */
+#include "computational_geometry.h"
+#include "cfd_commons.h"
+#include "commons.h"
+/****************************************************************************
+ * Data Structure Declarations
+ ****************************************************************************/
+typedef enum {
+    MORTONB = 10, /* bits of each coordinate in Morton code */
+} OrderConst;
+/****************************************************************************
+ * Static Function Declarations
+ ****************************************************************************/
+static int MortonCode(const Real [restrict], const Partition *const);
+static int SpreadBits(int);
+/****************************************************************************
+ * Function definitions
+ ****************************************************************************/
+/*
+ * Geometries are sorted by the Morton code of centroids with ties broken
+ * by the current storage position, hence the ordering is deterministic.
+ * Analytical polyhedrons stay ahead of triangulated ones as the data
+ * streamers rely on this partition. Note that overlapping geometries
+ * classify shared nodes to the one stored first, which may change with
+ * reordering; physical geometries do not overlap.
+ */
+void ReorderGeometry(Space *space)
+{
+    const Partition *const part = &(space->part);
+    Node *const node = space->node;
+    Geometry *const geo = &(space->geo);
+    if (2 > geo->totN) {
+        return;
+    }
+    int (*key)[EVF] = AssignStorage(geo->totN * sizeof(*key)); /* code, old position */
+    int *map = AssignStorage(geo->totN * sizeof(*map)); /* new position of each old position */
+    Polyhedron *poly = AssignStorage(geo->totN * sizeof(*poly));
+    for (int n = 0; n < geo->totN; ++n) {
+        key[n][0] = MortonCode(geo->poly[n].O, part);
+        key[n][1] = n;
+        key[n][2] = 0;
+        key[n][3] = 0;
+    }
+    QuickSortEdge(geo->sphN, key);
+    QuickSortEdge(geo->stlN, key + geo->sphN);
+    int moved = 0; /* reordering flag */
+    for (int n = 0; n < geo->totN; ++n) {
+        map[key[n][1]] = n;
+        poly[n] = geo->poly[key[n][1]];
+        if (key[n][1] != n) {
+            moved = 1;
+        }
+    }
+    if (moved) {
+        memcpy(geo->poly, poly, geo->totN * sizeof(*poly));
+        for (int n = 0; n < geo->totN; ++n) {
+            geo->pos[n] = map[geo->pos[n]];
+        }
+        /* remap domain identifiers, 0 is the fluid domain */
+        const int totN = part->n[X] * part->n[Y] * part->n[Z];
+        for (int idx = 0; idx < totN; ++idx) {
+            if (0 < node[idx].did) {
+                node[idx].did = map[node[idx].did - 1] + 1;
+            }
+        }
+    }
+    RetrieveStorage(key);
+    RetrieveStorage(map);
+    RetrieveStorage(poly);
+    return;
+}
+/*
+ * Interleave the bits of the quantized coordinates in the domain box.
+ */
+static int MortonCode(const Real p[restrict], const Partition *const part)
+{
+    const int nMax = (1 << MORTONB) - 1;
+    int code = 0;
+    int c = 0; /* quantized coordinate */
+    for (int s = 0; s < DIMS; ++s) {
+        c = (int)((p[s] - part->domain[s][MIN]) /
+                (part->domain[s][MAX] - part->domain[s][MIN]) * nMax);
+        c = MinInt(nMax, MaxInt(0, c));
+        code = code | (SpreadBits(c) << s);
+    }
+    return code;
+}
+/*
+ * Insert two zero bits between each of the lower MORTONB bits.
+ */
+static int SpreadBits(int c)
+{
+    c = (c | (c << 16)) & 0x030000FF;
+    c = (c | (c << 8)) & 0x0300F00F;
+    c = (c | (c << 4)) & 0x030C30C3;
+    c = (c | (c << 2)) & 0x09249249;
+    return c;
+}
+/* a good practice: end file with a newline */
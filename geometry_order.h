@@ -0,0 +1,39 @@
+/****************************************************************************
+ *                              ArtraCFD                                    *
+ *                          <By Huangrui Mo>                                *
+ * Copyright (C) Huangrui Mo <huangrui.mo@gmail.com>                        *
+ * This file is part of ArtraCFD.                                           *
+ * ArtraCFD is free software: you can redistribute it and/or modify it      *
+ * under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or        *
+ * (at your option) any later version.                                      *
+ ****************************************************************************/
+/****************************************************************************
+ * Header File Guards to Avoid Interdependence
+ ****************************************************************************/
+#ifndef ARTRACFD_GEOMETRY_ORDER_H_ /* if undefined */
+#define ARTRACFD_GEOMETRY_ORDER_H_ /* set a unique marker */
+/****************************************************************************
+ * Required Header Files
+ ****************************************************************************/
+#include "commons.h"
+/****************************************************************************
+ * Data Structure Declarations
+ ****************************************************************************/
+/****************************************************************************
+ * Public Functions Declaration
+ ****************************************************************************/
+/*
+ * Geometry reordering
+ *
+ * Function
+ *      Reorder the storage of geometries by the Morton code of their
+ *      centroids, so that geometries neighbouring in space are also
+ *      neighbouring in the geometry list. Analytical and triangulated
+ *      polyhedrons are reordered separately, domain identifiers of nodes
+ *      are remapped, and the input order is kept in the position list
+ *      for data output.
+ */
+extern void ReorderGeometry(Space *);
+#endif
+/* a good practice: end file with a newline */
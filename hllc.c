@@ -0,0 +1,134 @@
+/****************************************************************************
+ *                              ArtraCFD                                    *
+ *                          <By Huangrui Mo>                                *
+ * Copyright (C) Huangrui Mo <huangrui.mo@gmail.com>                        *
+ * This file is part of ArtraCFD.                                           *
+ * ArtraCFD is free software: you can redistribute it and/or modify it      *
+ * under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or        *
+ * (at your option) any later version.                                      *
+ ****************************************************************************/
+/****************************************************************************
+ * Required Header Files
+ ****************************************************************************/
+#include "hllc.h"
+#include "cfd_commons.h"
+#include "commons.h"
+/****************************************************************************
+ * Data Structure Declarations
+ ****************************************************************************/
+typedef enum {
+    SN = 4, /* width of the stencil */
+    CN = 1, /* position index of the left node of the interface in stencil */
+} HLLCConst;
+/****************************************************************************
+ * Static Function Declarations
+ ****************************************************************************/
+static Real VanLeer(const Real, const Real);
+static void StarState(const int, const Real, const Real, const Real [restrict],
+        const Real [restrict], Real [restrict]);
+/****************************************************************************
+ * Function definitions
+ ****************************************************************************/
+/*
+ * Toro, E. F. (2009). Riemann solvers and numerical methods for fluid
+ * dynamics: a practical introduction. Springer.
+ *
+ * The Hancock predictor of the MUSCL-Hancock scheme is replaced by the
+ * Runge-Kutta stages of the method of lines, hence only the limited
+ * reconstruction is performed here. The reconstruction falls back to first
+ * order if it produces non-positive density or pressure.
+ */
+void HLLC(const int tn, const int s, const int k, const int j,
+        const int i, const int partn[restrict], const Node *const node,
+        const Model *model, Real Fhat[restrict])
+{
+    int st[DIMS] = {0}; /* index strides */
+    IndexStride(partn, st);
+    const int idx = IndexNode(k, j, i, partn[Y], partn[X]);
+    const Real zero = 0.0;
+    Real Uo[SN][DIMUo] = {{zero}}; /* primitive variables of the stencil */
+    for (int n = 0; n < SN; ++n) {
+        MapPrimitive(model, node[idx + (n - CN) * st[s]].U[tn], Uo[n]);
+    }
+    /* limited linear reconstruction of the interface states */
+    Real UoL[DIMUo] = {zero};
+    Real UoR[DIMUo] = {zero};
+    for (int r = 0; r < DIMU; ++r) {
+        UoL[r] = Uo[CN][r] + 0.5 * VanLeer(Uo[CN][r] - Uo[CN-1][r], Uo[CN+1][r] - Uo[CN][r]);
+        UoR[r] = Uo[CN+1][r] - 0.5 * VanLeer(Uo[CN+1][r] - Uo[CN][r], Uo[CN+2][r] - Uo[CN+1][r]);
+    }
+    if ((zero >= UoL[0]) || (zero >= UoL[4]) || (zero >= UoR[0]) || (zero >= UoR[4])) {
+        for (int r = 0; r < DIMU; ++r) {
+            UoL[r] = Uo[CN][r];
+            UoR[r] = Uo[CN+1][r];
+        }
+    }
+    Real UL[DIMU] = {zero};
+    Real UR[DIMU] = {zero};
+    MapConservative(model, UoL, UL);
+    MapConservative(model, UoR, UR);
+    /* wave speed estimates */
+    const Real uL = UoL[s+1];
+    const Real uR = UoR[s+1];
+    const Real cL = ComputeSoundSpeed(model, UL);
+    const Real cR = ComputeSoundSpeed(model, UR);
+    const Real SL = MinReal(uL - cL, uR - cR);
+    const Real SR = MaxReal(uL + cL, uR + cR);
+    const Real mL = UoL[0] * (SL - uL);
+    const Real mR = UoR[0] * (SR - uR);
+    const Real Sm = (UoR[4] - UoL[4] + mL * uL - mR * uR) / (mL - mR);
+    /* upwind flux */
+    Real F[DIMU] = {zero};
+    Real Us[DIMU] = {zero}; /* star state */
+    if (zero <= SL) {
+        ConvectiveFlux(s, model, UL, Fhat);
+        return;
+    }
+    if (zero >= SR) {
+        ConvectiveFlux(s, model, UR, Fhat);
+        return;
+    }
+    if (zero <= Sm) {
+        ConvectiveFlux(s, model, UL, F);
+        StarState(s, SL, Sm, UoL, UL, Us);
+        for (int r = 0; r < DIMU; ++r) {
+            Fhat[r] = F[r] + SL * (Us[r] - UL[r]);
+        }
+        return;
+    }
+    ConvectiveFlux(s, model, UR, F);
+    StarState(s, SR, Sm, UoR, UR, Us);
+    for (int r = 0; r < DIMU; ++r) {
+        Fhat[r] = F[r] + SR * (Us[r] - UR[r]);
+    }
+    return;
+}
+/*
+ * Slope limiter of van Leer.
+ */
+static Real VanLeer(const Real dL, const Real dR)
+{
+    const Real zero = 0.0;
+    if (zero >= dL * dR) {
+        return zero;
+    }
+    return 2.0 * dL * dR / (dL + dR);
+}
+/*
+ * Conservative state in the star region on the side with wave speed S.
+ */
+static void StarState(const int s, const Real S, const Real Sm, const Real Uo[restrict],
+        const Real U[restrict], Real Us[restrict])
+{
+    const Real u = Uo[s+1];
+    const Real coe = Uo[0] * (S - u) / (S - Sm);
+    Us[0] = coe;
+    Us[1] = coe * Uo[1];
+    Us[2] = coe * Uo[2];
+    Us[3] = coe * Uo[3];
+    Us[s+1] = coe * Sm;
+    Us[4] = coe * (U[4] / Uo[0] + (Sm - u) * (Sm + Uo[4] / (Uo[0] * (S - u))));
+    return;
+}
+/* a good practice: end file with a newline */
@@ -11,13 +11,17 @@
 /****************************************************************************
  * Required Header Files
  ****************************************************************************/
+#define _POSIX_C_SOURCE 200809L /* expose POSIX threads under -std=c99 */
 #include "immersed_boundary.h"
 #include <stdio.h> /* standard library for input and output */
+#include <pthread.h> /* POSIX threads */
 #include <math.h> /* common mathematical functions */
 #include <stdlib.h> /* mathematical functions on integers */
 #include <float.h> /* size of floating point values */
 #include <string.h> /* manipulating strings */
 #include "computational_geometry.h"
+#include "domain_partition.h"
+#include "timer.h"
 #include "cfd_commons.h"
 #include "commons.h"
 /****************************************************************************
@@ -30,17 +34,38 @@ typedef enum {
     TYPED = -1, /* domain as key reconstruction state */
     TYPEF = -2, /* face as key reconstruction state */
     TYPEL = -3, /* layer as key reconstruction state */
+    SLABMIN = 4096, /* minimum nodes of a slab worth a worker thread */
 } IbmConst;
+typedef struct {
+    const Partition *part; /* partition */
+    Node *node; /* node field */
+    const Polyhedron *poly; /* polyhedron to classify */
+    int did; /* domain identifier of the polyhedron */
+    int box[DIMS][LIMIT]; /* node box of current slab */
+    Real facetN; /* facet tests of current slab */
+} DomainSlab;
+typedef struct {
+    int tn; /* time level */
+    int r; /* ghost layer */
+    Space *space; /* space */
+    const Model *model; /* model */
+} GhostTask;
 /****************************************************************************
  * Static Function Declarations
  ****************************************************************************/
 static void InitializeGeometricField(Space *);
 static void SetDomainField(Space *);
+static void ClassifySlab(const int, void *);
+static void TreatGhostUnit(const int, void *);
 static void SetInterfacialField(Space *, const Model *);
 static int GetInterState(const int, const int, const int, const int, const int,
         const int, const int [restrict][DIMS], const Node *const, const Partition *const);
 static void ApplyWeighting(const Real [restrict], const Real, Real,
         Real [restrict], Real [restrict]);
+static void SurfaceVelocity(const Polyhedron *, const Real [restrict], Real [restrict]);
+static Real WallShearRatio(const Model *, const Real [restrict], const Real [restrict],
+        const Real [restrict], const Real, Real [restrict], Real *);
+static Real WallFunction(const int, const Real, Real *);
 static Real InverseDistanceWeighting(const int, const int [restrict],
         const Real [restrict], const int, const int, const int, const Partition *const,
         const Node *const, const Model *, Real [restrict]);
@@ -48,6 +73,10 @@ static void ReconstructFlow(const int, const int [restrict], const Real [restric
         const int, const int, const int, const Polyhedron *, const Partition *const,
         const Node *const, const Model *, const Real [restrict], const Real [restrict],
         Real [restrict], Real [restrict]);
+/****************************************************************************
+ * Global Variables Definition with Private Scope
+ ****************************************************************************/
+static pthread_mutex_t costLock = PTHREAD_MUTEX_INITIALIZER; /* serialize cost accounting of work units */
 /****************************************************************************
  * Function definitions
  ****************************************************************************/
@@ -67,6 +96,7 @@ void ComputeGeometricField(Space *space, const Model *model)
     InitializeGeometricField(space);
     SetDomainField(space);
     SetInterfacialField(space, model);
+    BalanceWorkload(space);
     return;
 }
 static void InitializeGeometricField(Space *space)
@@ -128,52 +158,96 @@ static void InitializeGeometricField(Space *space)
 static void SetDomainField(Space *space)
 {
     const Partition *const part = &(space->part);
-    Node *const node = space->node;
     const Geometry *const geo = &(space->geo);
     const IntVec nMin = {part->ns[PIN][X][MIN], part->ns[PIN][Y][MIN], part->ns[PIN][Z][MIN]};
     const IntVec nMax = {part->ns[PIN][X][MAX], part->ns[PIN][Y][MAX], part->ns[PIN][Z][MAX]};
     const RealVec sMin = {part->domain[X][MIN], part->domain[Y][MIN], part->domain[Z][MIN]};
-    const RealVec d = {part->d[X], part->d[Y], part->d[Z]};
     const RealVec dd = {part->dd[X], part->dd[Y], part->dd[Z]};
     const IntVec ng = {part->ng[X], part->ng[Y], part->ng[Z]};
-    const Polyhedron *poly = NULL;
+    DomainSlab slab[part->thread]; /* node slabs classified concurrently */
     int box[DIMS][LIMIT] = {{0}}; /* bounding box in node space */
-    int fid = 0; /* store face link */
-    int idx = 0; /* linear array index math variable */
-    RealVec p = {0.0}; /* node point */
-    /* overlapping geometries introduce loop-carried dependence for node mapping */
+    int boxN = 0; /* nodes in bounding box */
+    int slabN = 0; /* number of slabs */
+    int nk = 0; /* node layers of current slab */
+    Timer tm; /* timer for cost accounting */
+    /*
+     * Overlapping geometries introduce loop-carried dependence for node
+     * mapping: a node in several geometries belongs to the one with the
+     * smallest identifier. Geometries are therefore processed in order,
+     * while the node box of each geometry is split into slabs in z that
+     * are independent of each other and classified concurrently.
+     */
     for (int n = 0; n < geo->totN; ++n) {
-        poly = geo->poly + n;
-        if (1 == poly->state) {
+        if (1 == geo->poly[n].state) {
             continue;
         }
         /* determine search range according to bounding box of polyhedron and valid node space */
         for (int s = 0; s < DIMS; ++s) {
-            box[s][MIN] = ConfineSpace(MapNode(poly->box[s][MIN], sMin[s], dd[s], ng[s]), nMin[s], nMax[s]);
-            box[s][MAX] = ConfineSpace(MapNode(poly->box[s][MAX], sMin[s], dd[s], ng[s]), nMin[s], nMax[s]) + 1;
+            box[s][MIN] = ConfineSpace(MapNode(geo->poly[n].box[s][MIN], sMin[s], dd[s], ng[s]), nMin[s], nMax[s]);
+            box[s][MAX] = ConfineSpace(MapNode(geo->poly[n].box[s][MAX], sMin[s], dd[s], ng[s]), nMin[s], nMax[s]) + 1;
         }
-        /* find nodes in geometry, then flag and link to geometry */
-        for (int k = box[Z][MIN]; k < box[Z][MAX]; ++k) {
-            for (int j = box[Y][MIN]; j < box[Y][MAX]; ++j) {
-                for (int i = box[X][MIN]; i < box[X][MAX]; ++i) {
-                    idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
-                    if (0 != node[idx].did) { /* already classified */
-                        continue;
+        TickTime(&tm);
+        boxN = (box[X][MAX] - box[X][MIN]) * (box[Y][MAX] - box[Y][MIN]) * (box[Z][MAX] - box[Z][MIN]);
+        slabN = MaxInt(MinInt(part->thread, MinInt(boxN / SLABMIN, box[Z][MAX] - box[Z][MIN])), 1);
+        nk = (box[Z][MAX] - box[Z][MIN] + slabN - 1) / slabN;
+        for (int m = 0; m < slabN; ++m) {
+            slab[m].part = part;
+            slab[m].node = space->node;
+            slab[m].poly = geo->poly + n;
+            slab[m].did = n + 1;
+            slab[m].facetN = 0.0;
+            memcpy(slab[m].box, box, sizeof box);
+            slab[m].box[Z][MIN] = MinInt(box[Z][MIN] + m * nk, box[Z][MAX]);
+            slab[m].box[Z][MAX] = MinInt(slab[m].box[Z][MIN] + nk, box[Z][MAX]);
+        }
+        RunWorkItems(part->pool, slabN, ClassifySlab, slab);
+        if (NULL != geo->cost) {
+            for (int m = 1; m < slabN; ++m) {
+                slab[0].facetN = slab[0].facetN + slab[m].facetN;
+            }
+            AccountGeometryCost(geo->cost[geo->poly[n].pid - 1][COSTDOMAIN], TockTime(&tm), 0, slab[0].facetN, boxN);
+        }
+    }
+    return;
+}
+/*
+ * Find nodes in geometry within a slab, then flag and link to geometry.
+ */
+static void ClassifySlab(const int m, void *arg)
+{
+    DomainSlab *const slab = (DomainSlab *)arg + m;
+    const Partition *const part = slab->part;
+    Node *const node = slab->node;
+    const Polyhedron *const poly = slab->poly;
+    const RealVec sMin = {part->domain[X][MIN], part->domain[Y][MIN], part->domain[Z][MIN]};
+    const RealVec d = {part->d[X], part->d[Y], part->d[Z]};
+    const IntVec ng = {part->ng[X], part->ng[Y], part->ng[Z]};
+    int fid = 0; /* store face link */
+    int idx = 0; /* linear array index math variable */
+    int tests = 0; /* facet tests of a node */
+    RealVec p = {0.0}; /* node point */
+    for (int k = slab->box[Z][MIN]; k < slab->box[Z][MAX]; ++k) {
+        for (int j = slab->box[Y][MIN]; j < slab->box[Y][MAX]; ++j) {
+            for (int i = slab->box[X][MIN]; i < slab->box[X][MAX]; ++i) {
+                idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
+                if (0 != node[idx].did) { /* already classified */
+                    continue;
+                }
+                p[X] = MapPoint(i, sMin[X], d[X], ng[X]);
+                p[Y] = MapPoint(j, sMin[Y], d[Y], ng[Y]);
+                p[Z] = MapPoint(k, sMin[Z], d[Z], ng[Z]);
+                if (0 >= poly->faceN) { /* analytical polyhedron */
+                    if (poly->r * poly->r >= Dist2(poly->O, p)) {
+                        node[idx].did = slab->did;
+                        node[idx].fid = 0;
                     }
-                    p[X] = MapPoint(i, sMin[X], d[X], ng[X]);
-                    p[Y] = MapPoint(j, sMin[Y], d[Y], ng[Y]);
-                    p[Z] = MapPoint(k, sMin[Z], d[Z], ng[Z]);
-                    if (0 >= poly->faceN) { /* analytical polyhedron */
-                        if (poly->r * poly->r >= Dist2(poly->O, p)) {
-                            node[idx].did = n + 1;
-                            node[idx].fid = 0;
-                        }
-                    } else { /* triangulated polyhedron */
-                        if (PointInPolyhedron(p, poly, &fid)) {
-                            node[idx].did = n + 1;
-                            node[idx].fid = fid;
-                        }
+                } else { /* triangulated polyhedron */
+                    tests = 0;
+                    if (PointInDistanceField(p, poly, &fid, &tests)) {
+                        node[idx].did = slab->did;
+                        node[idx].fid = fid;
                     }
+                    slab->facetN = slab->facetN + tests;
                 }
             }
         }
@@ -203,8 +277,8 @@ static void SetInterfacialField(Space *space, const Model *model)
                     p[Z] = MapPoint(k, part->domain[Z][MIN], part->d[Z], part->ng[Z]);
                     weightSum = InverseDistanceWeighting(TO, n, p, R, TYPEF, node[idx].did, part, node, model, Uo);
                     Normalize(DIMUo, weightSum, Uo);
-                    Uo[0] = Uo[4] / (Uo[5] * model->gasR); /* compute density */
-                    MapConservative(model->gamma, Uo, node[idx].U[TO]);
+                    Uo[0] = ComputeDensity(model, Uo[4], Uo[5]);
+                    MapConservative(model, Uo, node[idx].U[TO]);
                     node[idx].fid = NONE; /* set domain change mark to avoid reconstruction interference */
                 }
                 /* reset interfacial state */
@@ -269,9 +343,26 @@ static int GetInterState(const int sid, const int k, const int j, const int i, c
  */
 void TreatImmersedBoundary(const int tn, Space *space, const Model *model)
 {
-    const Partition *const part = &(space->part);
-    Node *const node = space->node;
-    const Geometry *const geo = &(space->geo);
+    GhostTask task = {.tn = tn, .r = 0, .space = space, .model = model};
+    /* ghost nodes of a layer only depend on fluid nodes and inner layers */
+    for (task.r = 1; task.r <= space->part.gl; ++task.r) { /* layer by layer treatment */
+        RunWorkUnits(&(space->part), TreatGhostUnit, &task);
+    }
+    return;
+}
+/*
+ * Reconstruct the ghost nodes of the current layer within a work unit.
+ */
+static void TreatGhostUnit(const int m, void *arg)
+{
+    const GhostTask *const task = arg;
+    const int tn = task->tn;
+    const int r = task->r;
+    const Model *const model = task->model;
+    const Partition *const part = &(task->space->part);
+    int (*const unit)[LIMIT] = part->unit[m]; /* node box of the unit */
+    Node *const node = task->space->node;
+    const Geometry *const geo = &(task->space->geo);
     const IntVec nMin = {part->ns[PIN][X][MIN], part->ns[PIN][Y][MIN], part->ns[PIN][Z][MIN]};
     const IntVec nMax = {part->ns[PIN][X][MAX], part->ns[PIN][Y][MAX], part->ns[PIN][Z][MAX]};
     const RealVec sMin = {part->domain[X][MIN], part->domain[Y][MIN], part->domain[Z][MIN]};
@@ -291,53 +382,79 @@ void TreatImmersedBoundary(const int tn, Space *space, const Model *model)
     Real UoI[DIMUo] = {0.0};
     Real weightSum = 0.0;
     int box[DIMS][LIMIT] = {{0}}; /* bounding box in node space */
+    int boxN = 0; /* nodes in bounding box */
+    int gstN = 0; /* ghost nodes treated */
+    int facetN = 0; /* facet tests */
+    Timer tm; /* timer for cost accounting */
     for (int n = 0; n < geo->totN; ++n) {
         poly = geo->poly + n;
-        /* determine search range according to bounding box of polyhedron and valid node space */
+        /* determine search range according to bounding box of polyhedron, valid node space, and the unit */
+        boxN = 1;
         for (int s = 0; s < DIMS; ++s) {
             box[s][MIN] = ConfineSpace(MapNode(poly->box[s][MIN], sMin[s], dd[s], ng[s]), nMin[s], nMax[s]);
             box[s][MAX] = ConfineSpace(MapNode(poly->box[s][MAX], sMin[s], dd[s], ng[s]), nMin[s], nMax[s]) + 1;
+            box[s][MIN] = MaxInt(box[s][MIN], unit[s][MIN]);
+            box[s][MAX] = MinInt(box[s][MAX], unit[s][MAX]);
+            boxN = boxN * MaxInt(box[s][MAX] - box[s][MIN], 0);
+        }
+        if ((NULL != geo->cost) && (0 < boxN)) {
+            gstN = 0;
+            facetN = 0;
+            TickTime(&tm);
         }
         /* treat ghost nodes */
-        for (int r = 1; r <= part->gl; ++r) { /* layer by layer treatment */
-            for (int k = box[Z][MIN]; k < box[Z][MAX]; ++k) {
-                for (int j = box[Y][MIN]; j < box[Y][MAX]; ++j) {
-                    for (int i = box[X][MIN]; i < box[X][MAX]; ++i) {
-                        idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
-                        if ((r != node[idx].gst) || (n + 1 != node[idx].did)) {
-                            continue;
-                        }
-                        pG[X] = MapPoint(i, sMin[X], d[X], ng[X]);
-                        pG[Y] = MapPoint(j, sMin[Y], d[Y], ng[Y]);
-                        pG[Z] = MapPoint(k, sMin[Z], d[Z], ng[Z]);
-                        if (model->ibmLayer >= r) { /* immersed boundary treatment */
-                            ComputeGeometricData(pG, node[idx].fid, poly, pO, pI, N);
-                            nI[X] = MapNode(pI[X], sMin[X], dd[X], ng[X]);
-                            nI[Y] = MapNode(pI[Y], sMin[Y], dd[Y], ng[Y]);
-                            nI[Z] = MapNode(pI[Z], sMin[Z], dd[Z], ng[Z]);
-                            /*
-                             * When extremely strong discontinuities exist in the
-                             * domain of dependence of inverse distance weighting,
-                             * WENO's idea may be adopted to avoid discontinuous
-                             * stencils and to only use smooth stencils. However,
-                             * the algorithm will be too complex.
-                             */
-                            ReconstructFlow(tn, nI, pI, R, TYPED, 0, poly, part, node, model, pO, N, UoO, UoI);
-                            DoMethodOfImage(UoI, UoO, UoG);
-                        } else { /* inverse distance weighting */
-                            nG[X] = i; nG[Y] = j; nG[Z] = k;
-                            weightSum = InverseDistanceWeighting(tn, nG, pG, 1, r - 1, n + 1, part, node, model, UoG);
-                            Normalize(DIMUo, weightSum, UoG);
-                        }
-                        UoG[0] = UoG[4] / (UoG[5] * model->gasR); /* compute density */
-                        MapConservative(model->gamma, UoG, node[idx].U[tn]);
+        for (int k = box[Z][MIN]; k < box[Z][MAX]; ++k) {
+            for (int j = box[Y][MIN]; j < box[Y][MAX]; ++j) {
+                for (int i = box[X][MIN]; i < box[X][MAX]; ++i) {
+                    idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
+                    if ((r != node[idx].gst) || (n + 1 != node[idx].did)) {
+                        continue;
+                    }
+                    pG[X] = MapPoint(i, sMin[X], d[X], ng[X]);
+                    pG[Y] = MapPoint(j, sMin[Y], d[Y], ng[Y]);
+                    pG[Z] = MapPoint(k, sMin[Z], d[Z], ng[Z]);
+                    ++gstN;
+                    if (model->ibmLayer >= r) { /* immersed boundary treatment */
+                        facetN = facetN + (0 < poly->faceN);
+                        ComputeGeometricData(pG, node[idx].fid, poly, pO, pI, N);
+                        nI[X] = MapNode(pI[X], sMin[X], dd[X], ng[X]);
+                        nI[Y] = MapNode(pI[Y], sMin[Y], dd[Y], ng[Y]);
+                        nI[Z] = MapNode(pI[Z], sMin[Z], dd[Z], ng[Z]);
+                        /*
+                         * When extremely strong discontinuities exist in the
+                         * domain of dependence of inverse distance weighting,
+                         * WENO's idea may be adopted to avoid discontinuous
+                         * stencils and to only use smooth stencils. However,
+                         * the algorithm will be too complex.
+                         */
+                        ReconstructFlow(tn, nI, pI, R, TYPED, 0, poly, part, node, model, pO, N, UoO, UoI);
+                        DoMethodOfImage(UoI, UoO, UoG);
+                    } else { /* inverse distance weighting */
+                        nG[X] = i; nG[Y] = j; nG[Z] = k;
+                        weightSum = InverseDistanceWeighting(tn, nG, pG, 1, r - 1, n + 1, part, node, model, UoG);
+                        Normalize(DIMUo, weightSum, UoG);
                     }
+                    UoG[0] = ComputeDensity(model, UoG[4], UoG[5]);
+                    MapConservative(model, UoG, node[idx].U[tn]);
                 }
             }
         }
+        if ((NULL != geo->cost) && (0 < boxN)) {
+            AccountGeometryCost(geo->cost[poly->pid - 1][COSTGHOST], TockTime(&tm), gstN, facetN, boxN);
+        }
     }
     return;
 }
+void AccountGeometryCost(Real cost[restrict], const Real time, const int nodeN, const Real facetN, const int boxN)
+{
+    pthread_mutex_lock(&costLock);
+    cost[COSTTIME] = cost[COSTTIME] + time;
+    cost[COSTNODE] = cost[COSTNODE] + nodeN;
+    cost[COSTFACET] = cost[COSTFACET] + facetN;
+    cost[COSTBOX] = cost[COSTBOX] + boxN;
+    pthread_mutex_unlock(&costLock);
+    return;
+}
 void DoMethodOfImage(const Real UoI[restrict], const Real UoO[restrict], Real UoG[restrict])
 {
     /*
@@ -366,13 +483,27 @@ static void ReconstructFlow(const int tn, const int n[restrict], const Real p[re
     const Real weight = one / weightSum;
     /* physical boundary condition enforcement step */
     RealVec Vs = {zero}; /* general motion of boundary point */
-    /* Vs = Vcentroid + W x r */
-    const RealVec r = {pO[X] - poly->O[X], pO[Y] - poly->O[Y], pO[Z] - poly->O[Z]};
-    Cross(poly->W[TO], r, Vs); /* relative motion in translating coordinate system */
-    Vs[X] = poly->V[TO][X] + Vs[X];
-    Vs[Y] = poly->V[TO][Y] + Vs[Y];
-    Vs[Z] = poly->V[TO][Z] + Vs[Z];
-    if (zero < poly->cf) { /* noslip wall */
+    SurfaceVelocity(poly, pO, Vs);
+    if ((zero < poly->cf) && (WALLN != model->wall) && (zero < model->refMu)) { /* modelled noslip wall */
+        /*
+         * The boundary point slips so that the linear profile between the
+         * boundary point and the image point carries the mass flux of the
+         * wall function profile. Matching the modelled shear by the linear
+         * profile instead would need a counter slip of order y+ / u+ times
+         * the image point velocity, hence the modelled shear is exerted in
+         * the surface force integration.
+         */
+        Real UoI[DIMUo] = {zero};
+        RealVec Vt = {zero}; /* relative tangential velocity of image point */
+        Real slip = zero; /* slip velocity relative to image point velocity */
+        for (int n = 0; n < DIMUo; ++n) {
+            UoI[n] = Uo[n] * weight;
+        }
+        WallShearRatio(model, UoI, Vs, N, Dist(p, pO), Vt, &slip);
+        UoO[1] = Vs[X] + slip * Vt[X];
+        UoO[2] = Vs[Y] + slip * Vt[Y];
+        UoO[3] = Vs[Z] + slip * Vt[Z];
+    } else if (zero < poly->cf) { /* noslip wall */
         UoO[1] = Vs[X];
         UoO[2] = Vs[Y];
         UoO[3] = Vs[Z];
@@ -410,6 +541,173 @@ static void ReconstructFlow(const int tn, const int n[restrict], const Real p[re
     Normalize(DIMUo, weightSum, Uo);
     return;
 }
+Real ModelWallShear(const int tn, const Real pI[restrict], const Real pO[restrict], const Real N[restrict],
+        const Polyhedron *poly, const Partition *const part, const Node *const node, const Model *model,
+        Real Vt[restrict])
+{
+    const RealVec sMin = {part->domain[X][MIN], part->domain[Y][MIN], part->domain[Z][MIN]};
+    const RealVec dd = {part->dd[X], part->dd[Y], part->dd[Z]};
+    const IntVec ng = {part->ng[X], part->ng[Y], part->ng[Z]};
+    const IntVec nI = {MapNode(pI[X], sMin[X], dd[X], ng[X]), MapNode(pI[Y], sMin[Y], dd[Y], ng[Y]),
+        MapNode(pI[Z], sMin[Z], dd[Z], ng[Z])}; /* image node */
+    Real UoI[DIMUo] = {0.0};
+    RealVec Vs = {0.0}; /* general motion of boundary point */
+    const Real weightSum = InverseDistanceWeighting(tn, nI, pI, R, TYPED, 0, part, node, model, UoI);
+    Normalize(DIMUo, weightSum, UoI);
+    Real slip = 0.0; /* slip velocity relative to image point velocity */
+    SurfaceVelocity(poly, pO, Vs);
+    return WallShearRatio(model, UoI, Vs, N, Dist(pI, pO), Vt, &slip);
+}
+/*
+ * Reconstruct the boundary point state at a surface point from the image
+ * point one minimum grid spacing along the normal, and the wall shear
+ * stress exerted by fluid there, modelled if a wall model is applied.
+ * Parts of a geometry may lie outside the domain, where no fluid node is
+ * near enough to reconstruct from.
+ */
+int ComputeSurfaceData(const int tn, const Real pO[restrict], const Real N[restrict], const Polyhedron *poly,
+        const Partition *const part, const Node *const node, const Model *model, Real UoO[restrict],
+        Real tau[restrict])
+{
+    const Real zero = 0.0;
+    const RealVec sMin = {part->domain[X][MIN], part->domain[Y][MIN], part->domain[Z][MIN]};
+    const RealVec dd = {part->dd[X], part->dd[Y], part->dd[Z]};
+    const IntVec ng = {part->ng[X], part->ng[Y], part->ng[Z]};
+    const Real h = MinReal(part->d[X], MinReal(part->d[Y], part->d[Z])); /* image point distance */
+    const RealVec pI = {pO[X] + h * N[X], pO[Y] + h * N[Y], pO[Z] + h * N[Z]}; /* image point */
+    const IntVec nI = {MapNode(pI[X], sMin[X], dd[X], ng[X]), MapNode(pI[Y], sMin[Y], dd[Y], ng[Y]),
+        MapNode(pI[Z], sMin[Z], dd[Z], ng[Z])}; /* image node */
+    const IntVec nO = {MapNode(pO[X], sMin[X], dd[X], ng[X]), MapNode(pO[Y], sMin[Y], dd[Y], ng[Y]),
+        MapNode(pO[Z], sMin[Z], dd[Z], ng[Z])}; /* boundary node */
+    Real UoI[DIMUo] = {zero};
+    RealVec Vs = {zero}; /* general motion of boundary point */
+    RealVec Vt = {zero}; /* relative tangential velocity of image point */
+    Real slip = zero; /* slip velocity relative to image point velocity */
+    memset(UoO, 0, DIMUo * sizeof(*UoO));
+    memset(tau, 0, DIMS * sizeof(*tau));
+    if (!InPartBox(nO[Z], nO[Y], nO[X], part->ns[PHY]) || !InPartBox(nI[Z], nI[Y], nI[X], part->ns[PHY])) {
+        return 1;
+    }
+    ReconstructFlow(tn, nI, pI, R, TYPED, 0, poly, part, node, model, pO, N, UoO, UoI);
+    UoO[0] = UoI[0];
+    if ((zero >= model->refMu) || (zero >= poly->cf)) { /* inviscid or slip wall */
+        return 0;
+    }
+    SurfaceVelocity(poly, pO, Vs);
+    const Real ratio = WallShearRatio(model, UoI, Vs, N, h, Vt, &slip);
+    const Real mu = model->refMu * Viscosity(UoO[5] * model->refT);
+    tau[X] = mu * ratio * Vt[X] / h;
+    tau[Y] = mu * ratio * Vt[Y] / h;
+    tau[Z] = mu * ratio * Vt[Z] / h;
+    return 0;
+}
+static void SurfaceVelocity(const Polyhedron *poly, const Real pO[restrict], Real Vs[restrict])
+{
+    /* Vs = Vcentroid + W x r */
+    const RealVec r = {pO[X] - poly->O[X], pO[Y] - poly->O[Y], pO[Z] - poly->O[Z]};
+    Cross(poly->W[TO], r, Vs); /* relative motion in translating coordinate system */
+    Vs[X] = poly->V[TO][X] + Vs[X];
+    Vs[Y] = poly->V[TO][Y] + Vs[Y];
+    Vs[Z] = poly->V[TO][Z] + Vs[Z];
+    return;
+}
+/*
+ * The wall function relates the tangential velocity Ut at wall distance y
+ * to the friction velocity u_tau by u+ = Ut / u_tau and y+ = y * u_tau / nu.
+ * Since y+ * u+ = Ut * y / nu is the known local Reynolds number, u+ is
+ * solved from it, and the wall shear rho * u_tau^2 relative to the linear
+ * profile shear mu * Ut / y is y+ / u+, which is one in the viscous sublayer.
+ * The linear profile keeps the mass flux of the wall function profile when
+ * the slip velocity is (1 - 2 * Y / Re) * Ut, with Y the integral of y+
+ * over u+, which is zero in the viscous sublayer and rises towards one as
+ * the profile turns logarithmic.
+ */
+static Real WallShearRatio(const Model *model, const Real UoI[restrict], const Real Vs[restrict],
+        const Real N[restrict], const Real y, Real Vt[restrict], Real *slip)
+{
+    const Real one = 1.0;
+    RealVec V = {UoI[1] - Vs[X], UoI[2] - Vs[Y], UoI[3] - Vs[Z]}; /* relative velocity */
+    const Real Vn = Dot(V, N);
+    Vt[X] = V[X] - Vn * N[X];
+    Vt[Y] = V[Y] - Vn * N[Y];
+    Vt[Z] = V[Z] - Vn * N[Z];
+    const Real mu = model->refMu * Viscosity(UoI[5] * model->refT);
+    const Real Re = UoI[0] * Norm(Vt) * y / mu;
+    *slip = 0.0;
+    if ((one >= Re) || (WALLN == model->wall)) { /* viscous sublayer or resolved wall */
+        return one;
+    }
+    const Real up = WallFunction(model->wall, Re, slip);
+    *slip = one - 2.0 * *slip / Re;
+    return Re / (up * up);
+}
+/*
+ * Solve u+ from the local Reynolds number Re = y+ * u+, and store the
+ * integral of y+ over u+ from the wall.
+ *
+ * Log law: u+ = y+ in the viscous sublayer and u+ = ln(y+) / kappa + B
+ * above the crossing point, solved by fixed point iteration, which
+ * contracts since its derivative is -1 / (kappa * u+).
+ *
+ * Spalding: y+ = u+ + exp(-kappa * B) * (exp(kappa * u+) - 1 - kappa * u+
+ * - (kappa * u+)^2 / 2 - (kappa * u+)^3 / 6), a single profile through the
+ * buffer layer. u+ * y+(u+) - Re is increasing and convex, and is solved
+ * by Newton iteration safeguarded with bisection on [0, sqrt(Re)], since
+ * y+ >= u+ bounds the root.
+ *
+ * Spalding, D.B., 1961. A single formula for the law of the wall. Journal
+ * of Applied Mechanics, 28(3), pp.455-458.
+ */
+static Real WallFunction(const int wall, const Real Re, Real *Y)
+{
+    const Real kappa = 0.41; /* von karman constant */
+    const Real B = 5.2; /* log law intercept */
+    const Real yc = 11.06; /* crossing point of viscous sublayer and log law */
+    const Real tol = 1.0e-10; /* relative tolerance of iterations */
+    const int itMax = 50; /* maximum iterations */
+    Real upMax = sqrt(Re); /* viscous sublayer value as the upper bound */
+    if (WALLLOG == wall) {
+        if (yc * yc >= Re) {
+            *Y = 0.5 * Re;
+            return upMax;
+        }
+        Real up = log(Re / yc) / kappa + B; /* log law u+ at y+ = Re / yc */
+        for (int it = 0, converge = 0; (itMax > it) && (0 == converge); ++it) {
+            const Real upOld = up;
+            up = log(Re / up) / kappa + B;
+            converge = (tol * up >= fabs(up - upOld));
+        }
+        *Y = 0.5 * yc * yc + (Re / up - yc) / kappa;
+        return up;
+    }
+    const Real e = exp(-kappa * B);
+    Real upMin = 0.0; /* lower bound */
+    Real up = (yc * yc >= Re) ? upMax : MinReal(upMax, log(Re / yc) / kappa + B);
+    Real ku = 0.0;
+    for (int it = 0; itMax > it; ++it) {
+        ku = kappa * up;
+        const Real ex = exp(ku) - 1.0 - ku - 0.5 * ku * ku;
+        const Real yp = up + e * (ex - ku * ku * ku / 6.0);
+        const Real dyp = 1.0 + e * kappa * ex;
+        const Real F = up * yp - Re;
+        if (0.0 < F) {
+            upMax = up;
+        } else {
+            upMin = up;
+        }
+        Real du = F / (yp + up * dyp);
+        if ((upMin >= up - du) || (upMax <= up - du)) { /* safeguard by bisection */
+            du = up - 0.5 * (upMin + upMax);
+        }
+        up = up - du;
+        if (tol * up >= fabs(du)) {
+            break;
+        }
+    }
+    ku = kappa * up;
+    *Y = 0.5 * up * up + e * ((exp(ku) - 1.0) / kappa - up * (1.0 + ku * (0.5 + ku * (1.0 / 6.0 + ku / 24.0))));
+    return up;
+}
 static Real InverseDistanceWeighting(const int tn, const int n[restrict], const Real p[restrict],
         const int h, const int type, const int did, const Partition *const part,
         const Node *const node, const Model *model, Real Uo[restrict])
@@ -429,8 +727,10 @@ static Real InverseDistanceWeighting(const int tn, const int n[restrict], const
      * To preserve symmetry, the search range in each direction should be symmetric, and
      * the search operator on each direction index should be symmetric. In addition,
      * any temporal priority should be strictly prevented in treating the solution nodes.
+     * The search stops once the range covers the whole partition.
      */
-    for (int r = h, tally = 0; 0 == tally; ++r) {
+    const int rMax = MaxInt(part->n[X], MaxInt(part->n[Y], part->n[Z])); /* range bound */
+    for (int r = h, tally = 0; (0 == tally) && (rMax >= r); ++r) {
         for (int kh = -r; kh <= r; ++kh) {
             for (int jh = -r; jh <= r; ++jh) {
                 for (int ih = -r; ih <= r; ++ih) {
@@ -463,7 +763,7 @@ static Real InverseDistanceWeighting(const int tn, const int n[restrict], const
                     ph[X] = MapPoint(nh[X], sMin[X], d[X], ng[X]);
                     ph[Y] = MapPoint(nh[Y], sMin[Y], d[Y], ng[Y]);
                     ph[Z] = MapPoint(nh[Z], sMin[Z], d[Z], ng[Z]);
-                    MapPrimitive(model->gamma, model->gasR, node[idx].U[tn], Uoh);
+                    MapPrimitive(model, node[idx].U[tn], Uoh);
                     ApplyWeighting(Uoh, part->tinyL, Dist2(p, ph), &weightSum, Uo);
                 }
             }
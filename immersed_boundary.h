@@ -37,7 +37,46 @@ extern void ComputeGeometricField(Space *, const Model *);
  *      Apply boundary conditions and treatments for immersed boundaries.
  */
 extern void TreatImmersedBoundary(const int tn, Space *, const Model *);
+/*
+ * Geometry cost accounting
+ *
+ * Function
+ *      Add wall time, ghost nodes, facet tests, and bounding box nodes of a
+ *      geometry phase to the cost record of a geometry. Safe to call from
+ *      concurrent work units.
+ */
+extern void AccountGeometryCost(Real cost[restrict], const Real time, const int nodeN, const Real facetN,
+        const int boxN);
 extern void DoMethodOfImage(const Real UoI[restrict], const Real UoO[restrict], Real UoG[restrict]);
+/*
+ * Wall model
+ *
+ * Function
+ *      Interpolate the flow at the image point of a noslip boundary point,
+ *      store the tangential velocity of the image point relative to the
+ *      wall, and return the ratio of the wall shear given by the wall
+ *      function of the model to the shear of the linear profile between
+ *      the boundary point and the image point.
+ */
+extern Real ModelWallShear(const int tn, const Real pI[restrict], const Real pO[restrict],
+        const Real N[restrict], const Polyhedron *, const Partition *const, const Node *const,
+        const Model *, Real Vt[restrict]);
+/*
+ * Surface data
+ *
+ * Function
+ *      Reconstruct the flow state at a surface point of a geometry and
+ *      the wall shear stress exerted by fluid on the surface. A surface
+ *      point whose boundary or image node is outside the physical domain
+ *      is skipped with zero data.
+ *
+ * Returns
+ *      0 -- successful
+ *      1 -- skipped
+ */
+extern int ComputeSurfaceData(const int tn, const Real pO[restrict], const Real N[restrict],
+        const Polyhedron *, const Partition *const, const Node *const, const Model *, Real UoO[restrict],
+        Real tau[restrict]);
 #endif
 /* a good practice: end file with a newline */
 
@@ -14,14 +14,24 @@
 #include "initialization.h"
 #include <stdio.h> /* standard library for input and output */
 #include <string.h> /* manipulating strings */
+#include <math.h> /* common mathematical functions */
+#include <float.h> /* size of floating point values */
 #include "calculator.h"
 #include "computational_geometry.h"
 #include "immersed_boundary.h"
 #include "boundary_treatment.h"
 #include "data_stream.h"
+#include "domain_partition.h"
 #include "stl.h"
 #include "cfd_commons.h"
 #include "commons.h"
+/****************************************************************************
+ * Data Structure Declarations
+ ****************************************************************************/
+typedef struct {
+    Geometry *geo; /* geometry data */
+    String *fname; /* geometry file name of each triangulated polyhedron */
+} PolyLoad; /* triangulated polyhedrons to be loaded */
 /****************************************************************************
  * Static Function Declarations
  ****************************************************************************/
@@ -29,9 +39,12 @@ static void InitializeSpaceData(Space *, const Model *);
 static void InitializeFieldData(Space *, const Model *);
 static void ApplyInitializer(const int, const Real [restrict],
         Real [restrict], const Partition *const, const Model *);
-static void InitializeGeometryData(Geometry *const);
+static void InitializeGeometryData(const Partition *const, Geometry *const);
+static void LoadPolyhedron(const int, void *);
+static Real ResolvedSpacing(const Partition *const);
 static void WritePolyMassProperty(const Geometry *const);
 static void IdentifyGeometryState(Geometry *const);
+static void InitializeDistanceField(Space *);
 /****************************************************************************
  * Function definitions
  ****************************************************************************/
@@ -42,22 +55,26 @@ void InitializeComputeDomain(Time *time, Space *space, const Model *model)
     } else {
         ReadData(PROSD, time, space, model);
     }
-    ComputeGeometryParameters(space->part.collapse, &(space->geo));
-    WritePolyMassProperty(&(space->geo));
+    ComputeGeometryParameters(space->part.collapse, space->part.pool, &(space->geo));
+    InitializeDistanceField(space);
+    if (0 == time->mute) {
+        WritePolyMassProperty(&(space->geo));
+    }
     ComputeGeometricField(space, model);
-    TreatBoundary(TO, space, model);
+    TreatBoundary(TO, 0.0, space, model);
     IdentifyGeometryState(&(space->geo));
-    if (0 == time->restart) { /* non restart */
+    if ((0 == time->restart) && (0 == time->mute)) { /* non restart */
         WriteData(PROPT, time, space, model);
         WriteData(PROFC, time, space, model);
         WriteData(PROSD, time, space, model);
+        WriteImageData(time, space, model);
     }
     return;
 }
 static void InitializeSpaceData(Space *space, const Model *model)
 {
     InitializeFieldData(space, model);
-    InitializeGeometryData(&(space->geo));
+    InitializeGeometryData(&(space->part), &(space->geo));
     return;
 }
 /*
@@ -80,21 +97,28 @@ static void InitializeFieldData(Space *space, const Model *model)
                 node[idx].lid = NONE;
                 node[idx].gst = NONE;
                 memset(node[idx].U, 1, DIMT * sizeof(*node[idx].U));
-                if (!InPartBox(k, j, i, part->ns[PIN])) {
+                if (!InPartBox(k, j, i, part->ns[PHY])) {
                     continue;
                 }
-                /* geometric field initializer */
-                node[idx].did = 0;
-                node[idx].fid = 0;
-                node[idx].lid = 0;
-                node[idx].gst = 0;
-                /* data field initializer */
+                /*
+                 * data field initializer
+                 * Boundary nodes are initialized as well, since the
+                 * non-reflecting boundary conditions evolve from them.
+                 */
                 pc[X] = MapPoint(i, part->domain[X][MIN], part->d[X], part->ng[X]);
                 pc[Y] = MapPoint(j, part->domain[Y][MIN], part->d[Y], part->ng[Y]);
                 pc[Z] = MapPoint(k, part->domain[Z][MIN], part->d[Z], part->ng[Z]);
                 for (int n = 0; n < part->nIC; ++n) {
                     ApplyInitializer(n, pc, node[idx].U[TO], part, model);
                 }
+                if (!InPartBox(k, j, i, part->ns[PIN])) {
+                    continue;
+                }
+                /* geometric field initializer */
+                node[idx].did = 0;
+                node[idx].fid = 0;
+                node[idx].lid = 0;
+                node[idx].gst = 0;
             }
         }
     }
@@ -156,17 +180,17 @@ static void ApplyInitializer(const int n, const Real pc[restrict], Real U[restri
             break;
     }
     if (1 == flag) { /* current node meets the condition */
-        MapConservative(model->gamma, Uo, U);
+        MapConservative(model, Uo, U);
     }
     return;
 }
-static void InitializeGeometryData(Geometry *const geo)
+static void InitializeGeometryData(const Partition *const part, Geometry *const geo)
 {
     FILE *fp = Fopen("artracfd.geo", "r");
     const char *fmtI = ParseFormat("%lg, %lg, %lg, %lg, %lg, %lg, %lg, %lg, %lg");
+    const char *fmtJ = ParseFormat("%lg, %lg");
     /* read and process file line by line */
     String str = {'\0'}; /* store the current read line */
-    String fname = {'\0'}; /* store the file name */
     while (NULL != fgets(str, sizeof str, fp)) {
         ParseCommand(str);
         if (0 == strncmp(str, "sphere state begin", sizeof str)) {
@@ -174,11 +198,15 @@ static void InitializeGeometryData(Geometry *const geo)
             continue;
         }
         if (0 == strncmp(str, "polyhedron geometry begin", sizeof str)) {
-            for (int n = geo->sphN; n < geo->totN; ++n) {
-                Sread(fp, 1, "%s", fname);
-                ReadStlFile(fname, geo->poly + n);
-                ConvertPolyhedron(geo->poly + n);
+            PolyLoad load = {.geo = geo, .fname = NULL};
+            if (0 < geo->stlN) {
+                load.fname = AssignStorage(geo->stlN * sizeof(*load.fname));
+            }
+            for (int n = 0; n < geo->stlN; ++n) {
+                Sread(fp, 1, "%s", load.fname[n]);
             }
+            RunWorkItems(part->pool, geo->stlN, LoadPolyhedron, &load);
+            RetrieveStorage(load.fname);
             continue;
         }
         if (0 == strncmp(str, "polyhedron state begin", sizeof str)) {
@@ -203,10 +231,69 @@ static void InitializeGeometryData(Geometry *const geo)
             }
             continue;
         }
+        if (0 == strncmp(str, "polyhedron decimation begin", sizeof str)) {
+            const Real h = ResolvedSpacing(part);
+            Real size = 0.0;
+            Real tol = 0.0;
+            for (int n = geo->sphN; n < geo->totN; ++n) {
+                Sread(fp, 2, fmtJ, &size, &tol);
+                DecimatePolyhedron(size * h, tol * h, geo->poly + n);
+            }
+            continue;
+        }
     }
     fclose(fp);
     return;
 }
+/*
+ * Files are read and converted by a pool of workers, so the reading of
+ * some files overlaps the conversion of others, while each polyhedron
+ * keeps the storage position of its input order.
+ */
+static void LoadPolyhedron(const int n, void *arg)
+{
+    const PolyLoad *const load = arg;
+    Polyhedron *const poly = load->geo->poly + load->geo->sphN + n;
+    ReadStlFile(load->fname[n], poly);
+    ConvertPolyhedron(poly);
+    return;
+}
+/*
+ * Smallest grid spacing among the dimensions that are not collapsed.
+ */
+static Real ResolvedSpacing(const Partition *const part)
+{
+    IntVec flat = {0}; /* collapsed dimension indicator */
+    switch (part->collapse) {
+        case COLLAPSEX:
+            flat[X] = 1;
+            break;
+        case COLLAPSEY:
+            flat[Y] = 1;
+            break;
+        case COLLAPSEZ:
+            flat[Z] = 1;
+            break;
+        case COLLAPSEXY:
+            flat[X] = 1; flat[Y] = 1;
+            break;
+        case COLLAPSEXZ:
+            flat[X] = 1; flat[Z] = 1;
+            break;
+        case COLLAPSEYZ:
+            flat[Y] = 1; flat[Z] = 1;
+            break;
+        default:
+            break;
+    }
+    Real h = FLT_MAX;
+    for (int s = 0; s < DIMS; ++s) {
+        if (0 == flat[s]) {
+            h = MinReal(h, part->d[s]);
+        }
+    }
+    return h;
+}
 static void WritePolyMassProperty(const Geometry *const geo)
 {
     FILE *fp = Fopen("geo_mass_property.csv", "w");
@@ -254,5 +341,25 @@ static void IdentifyGeometryState(Geometry *const geo)
     }
     return;
 }
+/*
+ * Interfacial nodes lie within gl node layers of the surface, and a moving
+ * polyhedron resets them together with the next layer; two layers of cell
+ * diagonal beyond gl bound the depth at which the closest face of a node
+ * may be used.
+ */
+static void InitializeDistanceField(Space *space)
+{
+    const Partition *const part = &(space->part);
+    Geometry *const geo = &(space->geo);
+    if (0 >= geo->sdf) {
+        return;
+    }
+    const Real band = (part->gl + 2) * sqrt(part->d[X] * part->d[X] +
+            part->d[Y] * part->d[Y] + part->d[Z] * part->d[Z]);
+    for (int n = geo->sphN; n < geo->totN; ++n) {
+        BuildDistanceField(geo->sdf, band, geo->poly + n);
+    }
+    return;
+}
 /* a good practice: end file with a newline */
 
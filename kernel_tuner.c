@@ -0,0 +1,372 @@
+/****************************************************************************
+ *                              ArtraCFD                                    *
+ *                          <By Huangrui Mo>                                *
+ * Copyright (C) Huangrui Mo <huangrui.mo@gmail.com>                        *
+ * This file is part of ArtraCFD.                                           *
+ * ArtraCFD is free software: you can redistribute it and/or modify it      *
+ * under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or        *
+ * (at your option) any later version.                                      *
+ ****************************************************************************/
+/****************************************************************************
+ * Required Header Files
+ ****************************************************************************/
+#include "kernel_tuner.h"
+#include <stdio.h> /* standard library for input and output */
+#include <stdlib.h> /* dynamic memory allocation and exit */
+#include <string.h> /* manipulating strings */
+#include <float.h> /* size of floating point values */
+#include "fluid_dynamics.h"
+#include "immersed_boundary.h"
+#include "domain_partition.h"
+#include "timer.h"
+#include "cfd_commons.h"
+#include "commons.h"
+/****************************************************************************
+ * Data Structure Declarations
+ ****************************************************************************/
+typedef enum {
+    TUNEN = 6, /* number of candidate tile widths */
+    DEPTHN = 3, /* number of candidate tile depths beyond one */
+    TUNETRY = 3, /* number of timed trials for each candidate */
+    GHOSTMAX = 64, /* bound of the measured cost ratio of ghost nodes */
+} TuneConst;
+/****************************************************************************
+ * Static Function Declarations
+ ****************************************************************************/
+static void ReadProcessorModel(char *, const int);
+static int ReadTuningCache(const char *, const char *, Partition *);
+static void WriteTuningCache(const char *, const char *, const Partition *);
+static int ActiveSweep(const int, const int, const int);
+static int TrySweep(const int, Space *, const Model *, double *);
+static int TryThread(Space *, const Model *, double *);
+static double TimeSweep(const int, Space *, const Model *);
+static double TimeGhost(Space *, const Model *);
+static void MeasureNodeCost(Space *, const Model *);
+/****************************************************************************
+ * Global Variables Definition with Private Scope
+ ****************************************************************************/
+static const int tileCandidate[TUNEN] = {1, 2, 4, 8, 16, TILEN};
+static const int depthCandidate[DEPTHN] = {2, 4, 8};
+/****************************************************************************
+ * Function definitions
+ ****************************************************************************/
+/*
+ * Pencils of X sweeps are contiguous in memory, tiling only pays off for
+ * Y and Z sweeps, where adjacent pencils are adjacent nodes. The search is
+ * by coordinates: the tile width at unit depth first, then the tile depth
+ * at the selected width, and finally the tile loop order of the selected
+ * shape. The number of worker threads in use is searched last by halving
+ * from all threads on the selected tiles, timing the sweeps of all
+ * directions, as small cases may lose more to synchronization than they
+ * gain from threads. Trial sweeps use a zero time step, so the intermediate data
+ * remain a copy of the current data and the boundary treatment works on
+ * physical values.
+ */
+void TuneKernel(const Time *time, Space *space, const Model *model)
+{
+    Partition *const part = &(space->part);
+    if (0 == part->tune) {
+        return;
+    }
+    const char *fname = getenv("ARTRACFD_TUNE"); /* shared tuning cache */
+    if (NULL == fname) {
+        fname = "artracfd.tune";
+    }
+    String cpu = {'\0'}; /* processor model */
+    ReadProcessorModel(cpu, sizeof cpu);
+    if ((0 == time->mute) && (1 == part->tune) && (0 == ReadTuningCache(fname, cpu, part))) {
+        ShowInfo("  tuning cache: tile = %dx%d, %dx%d, %dx%d; order = %d, %d, %d; threads = %d\n",
+                part->tile[X], part->depth[X], part->tile[Y], part->depth[Y],
+                part->tile[Z], part->depth[Z], part->order[X], part->order[Y], part->order[Z],
+                part->active);
+        BalanceWorkload(space);
+        MeasureNodeCost(space, model);
+        return;
+    }
+    double tmin = 0.0; /* minimum time cost */
+    int best = 1; /* best candidate */
+    for (int s = 0; s < DIMS; ++s) {
+        part->tile[s] = 1;
+        part->depth[s] = 1;
+        part->order[s] = 0;
+    }
+    for (int s = Y; s < DIMS; ++s) {
+        if (!ActiveSweep(part->collapse, model->multidim, s)) {
+            continue;
+        }
+        tmin = DBL_MAX;
+        best = 1;
+        for (int n = 0; n < TUNEN; ++n) {
+            part->tile[s] = tileCandidate[n];
+            if (TrySweep(s, space, model, &tmin)) {
+                best = tileCandidate[n];
+            }
+        }
+        part->tile[s] = best;
+        best = 1;
+        for (int n = 0; (n < DEPTHN) && (TILEN >= part->tile[s] * depthCandidate[n]); ++n) {
+            part->depth[s] = depthCandidate[n];
+            if (TrySweep(s, space, model, &tmin)) {
+                best = depthCandidate[n];
+            }
+        }
+        part->depth[s] = best;
+        part->order[s] = 1;
+        if (!TrySweep(s, space, model, &tmin)) {
+            part->order[s] = 0;
+        }
+    }
+    tmin = DBL_MAX;
+    best = part->thread;
+    for (int m = part->thread; 0 < m; m = m / 2) {
+        part->active = m;
+        if (TryThread(space, model, &tmin)) {
+            best = m;
+        }
+    }
+    part->active = best;
+    BalanceWorkload(space);
+    if (0 == time->mute) {
+        WriteTuningCache(fname, cpu, part);
+    }
+    ShowInfo("  tuning result: tile = %dx%d, %dx%d, %dx%d; order = %d, %d, %d; threads = %d\n",
+            part->tile[X], part->depth[X], part->tile[Y], part->depth[Y],
+            part->tile[Z], part->depth[Z], part->order[X], part->order[Y], part->order[Z],
+            part->active);
+    MeasureNodeCost(space, model);
+    return;
+}
+/*
+ * A sweep treats the ghost nodes once, the fluid node cost is the sweep
+ * time less the ghost treatment time. The cost ratio depends on the
+ * geometry of the case, hence it is measured on every run rather than
+ * cached, and the work units are rebalanced with it.
+ */
+static void MeasureNodeCost(Space *space, const Model *model)
+{
+    Partition *const part = &(space->part);
+    const Node *const node = space->node;
+    int idx = 0; /* linear array index math variable */
+    int fluidN = 0; /* interior fluid nodes */
+    int ghostN = 0; /* interior ghost nodes */
+    for (int k = part->ns[PIN][Z][MIN]; k < part->ns[PIN][Z][MAX]; ++k) {
+        for (int j = part->ns[PIN][Y][MIN]; j < part->ns[PIN][Y][MAX]; ++j) {
+            for (int i = part->ns[PIN][X][MIN]; i < part->ns[PIN][X][MAX]; ++i) {
+                idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
+                if (0 == node[idx].did) {
+                    ++fluidN;
+                } else if (0 < node[idx].gst) {
+                    ++ghostN;
+                }
+            }
+        }
+    }
+    if ((0 == fluidN) || (0 == ghostN)) {
+        return;
+    }
+    const double tg = TimeGhost(space, model); /* ghost treatment time */
+    double tf = 0.0; /* fluid node time of all sweeps */
+    int sweepN = 0; /* number of active sweeps */
+    for (int s = 0; s < DIMS; ++s) {
+        if (ActiveSweep(part->collapse, model->multidim, s)) {
+            tf = tf + TimeSweep(s, space, model) - tg;
+            ++sweepN;
+        }
+    }
+    if ((0.0 >= tf) || (0.0 >= tg)) {
+        return;
+    }
+    part->ghostCost = MinReal(MaxReal((sweepN * tg / ghostN) / (tf / fluidN), 1.0), GHOSTMAX);
+    ShowInfo("  tuning result: ghost node cost = %.3g fluid nodes\n", part->ghostCost);
+    BalanceWorkload(space);
+    return;
+}
+static void ReadProcessorModel(char *cpu, const int size)
+{
+    snprintf(cpu, size, "%s", "unknown");
+    FILE *fp = fopen("/proc/cpuinfo", "r");
+    if (NULL == fp) {
+        return;
+    }
+    String str = {'\0'}; /* store the current read line */
+    const char *tag = "model name";
+    char *scanner = NULL;
+    while (NULL != fgets(str, sizeof str, fp)) {
+        if (0 != strncmp(str, tag, strlen(tag))) {
+            continue;
+        }
+        scanner = strchr(str, ':');
+        if (NULL == scanner) {
+            break;
+        }
+        ++scanner;
+        ParseCommand(scanner);
+        if ('\0' != *scanner) {
+            snprintf(cpu, size, "%s", scanner);
+        }
+        break;
+    }
+    fclose(fp);
+    return;
+}
+/*
+ * Each record of the tuning cache is a line of
+ * nx, ny, nz, tile x, tile y, tile z, depth x, depth y, depth z,
+ * order x, order y, order z, threads, threads in use, processor model
+ * Return 0 if a record matches the machine and case.
+ */
+static int ReadTuningCache(const char *fname, const char *cpu, Partition *part)
+{
+    FILE *fp = fopen(fname, "r");
+    if (NULL == fp) {
+        return 1;
+    }
+    String str = {'\0'}; /* store the current read line */
+    IntVec n = {0}; /* node numbers of a record */
+    IntVec tile = {0}; /* tile widths of a record */
+    IntVec depth = {0}; /* tile depths of a record */
+    IntVec order = {0}; /* tile loop orders of a record */
+    int thread = 0; /* worker threads of a record */
+    int active = 0; /* worker threads in use of a record */
+    int offset = 0; /* offset of the processor model in a record */
+    int found = 1;
+    while (NULL != fgets(str, sizeof str, fp)) {
+        ParseCommand(str);
+        if (14 != sscanf(str, "%d, %d, %d, %d, %d, %d, %d, %d, %d, %d, %d, %d, %d, %d, %n",
+                    n + X, n + Y, n + Z, tile + X, tile + Y, tile + Z,
+                    depth + X, depth + Y, depth + Z, order + X, order + Y, order + Z,
+                    &thread, &active, &offset)) {
+            continue;
+        }
+        if ((n[X] != part->n[X]) || (n[Y] != part->n[Y]) || (n[Z] != part->n[Z]) ||
+                (thread != part->thread) || (0 != strcmp(str + offset, cpu))) {
+            continue;
+        }
+        for (int s = 0; s < DIMS; ++s) {
+            part->tile[s] = MinInt(MaxInt(tile[s], 1), TILEN);
+            part->depth[s] = MinInt(MaxInt(depth[s], 1), TILEN / part->tile[s]);
+            part->order[s] = (0 != order[s]);
+        }
+        part->active = MinInt(MaxInt(active, 1), part->thread);
+        found = 0; /* the last matched record is the most recent one */
+    }
+    fclose(fp);
+    return found;
+}
+static void WriteTuningCache(const char *fname, const char *cpu, const Partition *part)
+{
+    FILE *fp = fopen(fname, "a");
+    if (NULL == fp) {
+        ShowWarning("failed to write tuning cache: %s", fname);
+        return;
+    }
+    fprintf(fp, "%d, %d, %d, %d, %d, %d, %d, %d, %d, %d, %d, %d, %d, %d, %s\n",
+            part->n[X], part->n[Y], part->n[Z], part->tile[X], part->tile[Y], part->tile[Z],
+            part->depth[X], part->depth[Y], part->depth[Z], part->order[X], part->order[Y],
+            part->order[Z], part->thread, part->active, cpu);
+    fclose(fp);
+    return;
+}
+static int ActiveSweep(const int collapse, const int multidim, const int s)
+{
+    if (OPTBYOPT == multidim) {
+        return 1;
+    }
+    switch (collapse) {
+        case COLLAPSEN:
+            return 1;
+        case COLLAPSEX:
+            return (X != s);
+        case COLLAPSEY:
+            return (Y != s);
+        case COLLAPSEZ:
+            return (Z != s);
+        case COLLAPSEXY:
+            return (Z == s);
+        case COLLAPSEXZ:
+            return (Y == s);
+        case COLLAPSEYZ:
+            return (X == s);
+        default:
+            return 0;
+    }
+}
+/*
+ * Time the current candidate, return 1 and update the minimum time cost
+ * if it is the fastest so far.
+ */
+static int TrySweep(const int s, Space *space, const Model *model, double *tmin)
+{
+    const Partition *const part = &(space->part);
+    const double tc = TimeSweep(s, space, model);
+    ShowInfo("  tuning: sweep=%d; tile=%dx%d; order=%d; elapsed=%.6gs\n", s,
+            part->tile[s], part->depth[s], part->order[s], tc);
+    if (*tmin > tc) {
+        *tmin = tc;
+        return 1;
+    }
+    return 0;
+}
+/*
+ * Rebalance the work units for the threads in use and time the sweeps of
+ * all directions, return 1 and update the minimum time cost if it is the
+ * fastest so far.
+ */
+static int TryThread(Space *space, const Model *model, double *tmin)
+{
+    const Partition *const part = &(space->part);
+    double tc = 0.0; /* time cost of the sweeps */
+    BalanceWorkload(space);
+    for (int s = 0; s < DIMS; ++s) {
+        if (ActiveSweep(part->collapse, model->multidim, s)) {
+            tc = tc + TimeSweep(s, space, model);
+        }
+    }
+    ShowInfo("  tuning: threads=%d; elapsed=%.6gs\n", part->active, tc);
+    if (*tmin > tc) {
+        *tmin = tc;
+        return 1;
+    }
+    return 0;
+}
+/*
+ * Return the best of a few timed trials after a warm-up sweep.
+ */
+static double TimeSweep(const int s, Space *space, const Model *model)
+{
+    Timer tm; /* timer for computing operations */
+    double tc = 0.0; /* time cost of a trial */
+    double tmin = DBL_MAX; /* minimum time cost */
+    SweepFluidDynamics(0.0, s, space, model);
+    for (int n = 0; n < TUNETRY; ++n) {
+        TickTime(&tm);
+        SweepFluidDynamics(0.0, s, space, model);
+        tc = TockTime(&tm);
+        if (tmin > tc) {
+            tmin = tc;
+        }
+    }
+    return tmin;
+}
+/*
+ * Return the best of a few timed trials of the ghost treatment of the
+ * intermediate data, which a trial sweep also treats.
+ */
+static double TimeGhost(Space *space, const Model *model)
+{
+    Timer tm; /* timer for computing operations */
+    double tc = 0.0; /* time cost of a trial */
+    double tmin = DBL_MAX; /* minimum time cost */
+    TreatImmersedBoundary(TN, space, model);
+    for (int n = 0; n < TUNETRY; ++n) {
+        TickTime(&tm);
+        TreatImmersedBoundary(TN, space, model);
+        tc = TockTime(&tm);
+        if (tmin > tc) {
+            tmin = tc;
+        }
+    }
+    return tmin;
+}
+/* a good practice: end file with a newline */
@@ -0,0 +1,41 @@
+/****************************************************************************
+ *                              ArtraCFD                                    *
+ *                          <By Huangrui Mo>                                *
+ * Copyright (C) Huangrui Mo <huangrui.mo@gmail.com>                        *
+ * This file is part of ArtraCFD.                                           *
+ * ArtraCFD is free software: you can redistribute it and/or modify it      *
+ * under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or        *
+ * (at your option) any later version.                                      *
+ ****************************************************************************/
+/****************************************************************************
+ * Header File Guards to Avoid Interdependence
+ ****************************************************************************/
+#ifndef ARTRACFD_KERNEL_TUNER_H_ /* if undefined */
+#define ARTRACFD_KERNEL_TUNER_H_ /* set a unique marker */
+/****************************************************************************
+ * Required Header Files
+ ****************************************************************************/
+#include "commons.h"
+/****************************************************************************
+ * Data Structure Declarations
+ ****************************************************************************/
+/****************************************************************************
+ * Public Functions Declaration
+ ****************************************************************************/
+/*
+ * Kernel autotuning
+ *
+ * Function
+ *      Select the fastest kernel configuration for the current machine and
+ *      case by timing trial sweeps of the candidate tile widths, tile
+ *      depths, tile loop orders, and numbers of worker threads in use. The
+ *      choice is stored in a tuning cache keyed by processor model, node
+ *      numbers, and worker threads, so that later runs of the same
+ *      configuration skip the search. The cache is neither read nor written
+ *      when output is muted. The cost of a ghost node relative to a fluid
+ *      node is measured for workload balance.
+ */
+extern void TuneKernel(const Time *, Space *, const Model *);
+#endif
+/* a good practice: end file with a newline */
@@ -15,7 +15,12 @@
 #include <stdio.h> /* standard library for input and output */
 #include <string.h> /* manipulating strings */
 #include <math.h> /* common mathematical functions */
+#include <limits.h> /* sizes of integral types */
 #include "boundary_treatment.h"
+#include "geometry_order.h"
+#include "equation_of_state.h"
+#include "domain_partition.h"
+#include "solver_interface.h"
 #include "cfd_commons.h"
 #include "commons.h"
 /****************************************************************************
@@ -24,7 +29,143 @@
 typedef enum {
     TCN = 2, /* position index of center node in stencil */
     TTN = 5, /* number of nodes in a stencil */
+    TRN = 256, /* maximum number of nodes along a test row */
 } TestConst;
+typedef int (*Check)(void);
+typedef struct {
+    Real rho; /* density */
+    Real u; /* velocity */
+    Real p; /* pressure */
+} GasState; /* one-dimensional gas state */
+/****************************************************************************
+ * Static Function Declarations
+ ****************************************************************************/
+static int CheckGeometryOrder(void);
+static int CheckRiemannFlux(void);
+static int CheckEquationOfState(void);
+static int CheckTemporalOrder(void);
+static int CheckSweepMerging(void);
+static int CheckWorkloadBalance(void);
+static int CheckNonreflectingOutflow(void);
+static int CheckDualTime(void);
+static char *WriteIdealGasTable(const Model *);
+static int RunSession(const char *, const int, Real [restrict], int [restrict]);
+static Real ExactDensity(const GasState *, const GasState *, const Real, const Real);
+static Real PressureFunction(const GasState *, const Real, const Real);
+/****************************************************************************
+ * Global Variables Definition with Private Scope
+ ****************************************************************************/
+/*
+ * A one-dimensional shock tube on [0, 1] with 200 cells and a diaphragm at
+ * x = 0.5, the time scheme, spatial scheme, Jacobian average, and equation
+ * of state are filled in by the checks.
+ */
+static const char *shockTube =
+    "space begin\n0, 0, 0\n1, 1, 1\n200, 1, 1\nspace end\n"
+    "time begin\n0\n0.2\n0.6\n0\n1\n0\ntime end\n"
+    "numerical begin\n%d\n%d\n0\n%d\n0\n0\n1\nnumerical end\n"
+    "material begin\n0\n0\n0\n0, 0, 0\nmaterial end\n"
+    "equation of state begin\n%d\nequation of state end\n"
+    "reference begin\n1\n1\n1\n1\nreference end\n"
+    "initialization begin\n0.125\n0\n0\n0\n0.1\ninitialization end\n"
+    "west boundary begin\noutflow\nwest boundary end\n"
+    "east boundary begin\noutflow\neast boundary end\n"
+    "south boundary begin\nperiodic\nsouth boundary end\n"
+    "north boundary begin\nperiodic\nnorth boundary end\n"
+    "front boundary begin\nperiodic\nfront boundary end\n"
+    "back boundary begin\nperiodic\nback boundary end\n"
+    "plane initialization begin\n0.5, 0, 0\n-1, 0, 0\n1\n0\n0\n0\n1\nplane initialization end\n"
+    "probe count begin\n0\n0\n0\n0\nprobe count end\n"
+    "probe control begin\n0\n0\n0\n0\nprobe control end\n";
+/*
+ * A periodic density wave of unit velocity and pressure on [0, 1] with 50
+ * cells, the time scheme and CFL number are filled in by the checks.
+ */
+static const char *densityWave =
+    "space begin\n0, 0, 0\n1, 1, 1\n50, 1, 1\nspace end\n"
+    "time begin\n0\n%g\n%g\n0\n1\n0\ntime end\n"
+    "numerical begin\n%d\n1\n0\n0\n0\n0\n1\nnumerical end\n"
+    "material begin\n0\n0\n0\n0, 0, 0\nmaterial end\n"
+    "reference begin\n1\n1\n1\n1\nreference end\n"
+    "initialization begin\n1+0.2*sin(2*pi*x)\n1\n0\n0\n1\ninitialization end\n"
+    "west boundary begin\nperiodic\nwest boundary end\n"
+    "east boundary begin\nperiodic\neast boundary end\n"
+    "south boundary begin\nperiodic\nsouth boundary end\n"
+    "north boundary begin\nperiodic\nnorth boundary end\n"
+    "front boundary begin\nperiodic\nfront boundary end\n"
+    "back boundary begin\nperiodic\nback boundary end\n"
+    "probe count begin\n0\n0\n0\n0\nprobe count end\n"
+    "probe control begin\n0\n0\n0\n0\nprobe control end\n";
+/*
+ * A periodic density wave travelling diagonally at unit velocities and
+ * pressure on [0, 1] x [0, 1] with 32 x 32 cells, the CFL number, the
+ * time scheme, and the split sweep merging are filled in by the checks.
+ */
+static const char *diagonalWave =
+    "space begin\n0, 0, 0\n1, 1, 1\n32, 32, 1\nspace end\n"
+    "time begin\n0\n0.25\n%g\n0\n1\n0\ntime end\n"
+    "numerical begin\n%d\n1\n0\n0\n0\n0\n1\nnumerical end\n"
+    "splitting begin\n%d\nsplitting end\n"
+    "material begin\n0\n0\n0\n0, 0, 0\nmaterial end\n"
+    "reference begin\n1\n1\n1\n1\nreference end\n"
+    "initialization begin\n1+0.2*sin(2*pi*(x+y))\n1\n1\n0\n1\ninitialization end\n"
+    "west boundary begin\nperiodic\nwest boundary end\n"
+    "east boundary begin\nperiodic\neast boundary end\n"
+    "south boundary begin\nperiodic\nsouth boundary end\n"
+    "north boundary begin\nperiodic\nnorth boundary end\n"
+    "front boundary begin\nperiodic\nfront boundary end\n"
+    "back boundary begin\nperiodic\nback boundary end\n"
+    "probe count begin\n0\n0\n0\n0\nprobe count end\n"
+    "probe control begin\n0\n0\n0\n0\nprobe control end\n";
+/*
+ * A right running acoustic pulse of amplitude 0.01 in pressure on a gas at
+ * rest on [0, 1] with 200 cells, the density and velocity perturbations
+ * follow the simple wave relations with the speed of sound sqrt(1.4). Both
+ * ends are nonreflecting outflows to the unit pressure, the termination
+ * time and the relaxation rate are filled in by the checks.
+ */
+static const char *pressurePulse =
+    "space begin\n0, 0, 0\n1, 1, 1\n200, 1, 1\nspace end\n"
+    "time begin\n0\n%g\n0.6\n0\n1\n0\ntime end\n"
+    "numerical begin\n1\n1\n0\n0\n0\n0\n1\nnumerical end\n"
+    "material begin\n0\n0\n0\n0, 0, 0\nmaterial end\n"
+    "reference begin\n1\n1\n1\n1\nreference end\n"
+    "initialization begin\n"
+    "1+0.01/1.4*exp(0-400*(x-0.5)*(x-0.5))\n"
+    "0.01/1.183216*exp(0-400*(x-0.5)*(x-0.5))\n"
+    "0\n0\n"
+    "1+0.01*exp(0-400*(x-0.5)*(x-0.5))\n"
+    "initialization end\n"
+    "west boundary begin\nnonreflecting outflow\n1\n%g\nwest boundary end\n"
+    "east boundary begin\nnonreflecting outflow\n1\n%g\neast boundary end\n"
+    "south boundary begin\nperiodic\nsouth boundary end\n"
+    "north boundary begin\nperiodic\nnorth boundary end\n"
+    "front boundary begin\nperiodic\nfront boundary end\n"
+    "back boundary begin\nperiodic\nback boundary end\n"
+    "probe count begin\n0\n0\n0\n0\nprobe count end\n"
+    "probe control begin\n0\n0\n0\n0\nprobe control end\n";
+/*
+ * A periodic uniform flow of Mach number 0.042 on [0, 1] with 50 cells,
+ * below the preconditioning threshold 0.1, with dual time steps bounded by
+ * 10 acoustic steps. The hold steps are filled in by the checks.
+ */
+static const char *uniformFlow =
+    "space begin\n0, 0, 0\n1, 1, 1\n50, 1, 1\nspace end\n"
+    "time begin\n0\n100\n0.6\n0\n1\n0\ntime end\n"
+    "numerical begin\n1\n1\n0\n0\n0\n0\n1\nnumerical end\n"
+    "low mach begin\n0.1\n%d\n10\n20\n1.0e-2\nlow mach end\n"
+    "material begin\n0\n0\n0\n0, 0, 0\nmaterial end\n"
+    "reference begin\n1\n1\n1\n1\nreference end\n"
+    "initialization begin\n1\n0.05\n0\n0\n1\ninitialization end\n"
+    "west boundary begin\nperiodic\nwest boundary end\n"
+    "east boundary begin\nperiodic\neast boundary end\n"
+    "south boundary begin\nperiodic\nsouth boundary end\n"
+    "north boundary begin\nperiodic\nnorth boundary end\n"
+    "front boundary begin\nperiodic\nfront boundary end\n"
+    "back boundary begin\nperiodic\nback boundary end\n"
+    "probe count begin\n0\n0\n0\n0\nprobe count end\n"
+    "probe control begin\n0\n0\n0\n0\nprobe control end\n";
+static const char *noGeometry = "count begin\n0\n0\ncount end\n";
 /****************************************************************************
  * Function definitions
  ****************************************************************************/
@@ -117,5 +258,562 @@ void ComputeSolutionFunctional(const Time *time, Space *space, const Model *mode
     fclose(fp);
     return;
 }
+int RunNumericalTests(void)
+{
+    const Check check[] = {
+        CheckGeometryOrder,
+        CheckRiemannFlux,
+        CheckEquationOfState,
+        CheckTemporalOrder,
+        CheckSweepMerging,
+        CheckWorkloadBalance,
+        CheckNonreflectingOutflow,
+        CheckDualTime};
+    const char *name[] = {
+        "geometry reorder round trip",
+        "HLLC and Roe fluxes on Sod problem",
+        "tabulated equation of state",
+        "SSP Runge-Kutta temporal order",
+        "merged split sweeps",
+        "workload balance on a solid field",
+        "pressure pulse through outflow boundary",
+        "dual time stepping of a uniform flow"};
+    const int checkN = sizeof check / sizeof *check;
+    int fail[sizeof check / sizeof *check] = {0}; /* failure flags */
+    int failN = 0; /* number of failed checks */
+    for (int n = 0; n < checkN; ++n) {
+        fail[n] = check[n]();
+        failN = failN + (0 != fail[n]);
+    }
+    /* summary after the logs of solver sessions run by the checks */
+    ShowInfo("Session");
+    for (int n = 0; n < checkN; ++n) {
+        ShowInfo("  %-40s %s\n", name[n], (0 == fail[n]) ? "passed" : "FAILED");
+    }
+    ShowInfo("  %d of %d checks passed\n", checkN - failN, checkN);
+    ShowInfo("Session");
+    return failN;
+}
+/*
+ * Scattered geometries are reordered twice. Storage positions of the input
+ * order and domain identifiers of nodes should still reach the geometries
+ * they referred to, analytical polyhedrons should stay ahead of triangulated
+ * ones, and the second reordering should change nothing. Centroids are
+ * scattered such that the first reordering moves geometries.
+ */
+static int CheckGeometryOrder(void)
+{
+    Space space = {0};
+    Partition *const part = &(space.part);
+    Geometry *const geo = &(space.geo);
+    for (int s = 0; s < DIMS; ++s) {
+        part->n[s] = 4;
+        part->domain[s][MIN] = 0.0;
+        part->domain[s][MAX] = 1.0;
+    }
+    const int totN = part->n[X] * part->n[Y] * part->n[Z];
+    geo->sphN = 5;
+    geo->stlN = 4;
+    geo->totN = geo->sphN + geo->stlN;
+    geo->poly = AssignStorage(geo->totN * sizeof(*geo->poly));
+    geo->pos = AssignStorage(geo->totN * sizeof(*geo->pos));
+    space.node = AssignStorage(totN * sizeof(*space.node));
+    for (int n = 0; n < geo->totN; ++n) {
+        geo->poly[n].pid = n + 1;
+        geo->pos[n] = n;
+        for (int s = 0; s < DIMS; ++s) {
+            geo->poly[n].O[s] = fmod(0.618034 * (n + 1) * (s + 2), 1.0);
+        }
+    }
+    for (int idx = 0; idx < totN; ++idx) {
+        space.node[idx].did = idx % (geo->totN + 1);
+    }
+    int fail = 0; /* failure flag */
+    int did = 0; /* domain identifier after reordering */
+    int moved = 0; /* reordering flag of the first pass */
+    for (int pass = 0; pass < 2; ++pass) {
+        ReorderGeometry(&space);
+        for (int n = 0; n < geo->totN; ++n) {
+            moved = moved || (n != geo->pos[n]);
+            fail = fail || (n + 1 != geo->poly[geo->pos[n]].pid);
+            fail = fail || ((n < geo->sphN) != (geo->poly[n].pid <= geo->sphN));
+        }
+        for (int idx = 0; idx < totN; ++idx) {
+            did = space.node[idx].did;
+            fail = fail || ((0 < did) ? geo->poly[did-1].pid : 0) != idx % (geo->totN + 1);
+        }
+    }
+    fail = fail || (0 == moved);
+    RetrieveStorage(geo->poly);
+    RetrieveStorage(geo->pos);
+    RetrieveStorage(space.node);
+    return fail;
+}
+/*
+ * The Sod problem is solved by MUSCL-HLLC and by WENO5 with the Roe
+ * averaged eigensystem. Both density profiles should be close to the
+ * exact solution in the L1 norm and close to each other.
+ */
+static int CheckRiemannFlux(void)
+{
+    const GasState L = {1.0, 0.0, 1.0}; /* left state */
+    const GasState R = {0.125, 0.0, 0.1}; /* right state */
+    const Real tol[3] = {5.0e-3, 5.0e-3, 2.0e-3}; /* tolerances of L1 norms */
+    String str = {'\0'}; /* case text buffer */
+    char caseText[sizeof str * 8] = {'\0'};
+    Real rho[2][TRN] = {{0.0}}; /* density of HLLC and Roe */
+    int n[DIMS] = {0}; /* node number */
+    int fail = 0; /* failure flag */
+    snprintf(caseText, sizeof caseText, shockTube, RKTHREE, MUSCLHLLC, 0, EOSIDEAL); /* arithmetic average */
+    fail = fail || RunSession(caseText, 0, rho[0], n);
+    snprintf(caseText, sizeof caseText, shockTube, RKTHREE, WENOFIVE, 1, EOSIDEAL); /* Roe average */
+    fail = fail || RunSession(caseText, 0, rho[1], n);
+    if (fail) {
+        return fail;
+    }
+    Real err[3] = {0.0}; /* L1 norms of HLLC, Roe, and their difference */
+    Real x = 0.0; /* node coordinate */
+    for (int i = 0; i < n[X]; ++i) {
+        x = (Real)i / (Real)(n[X] - 1);
+        err[0] = err[0] + fabs(rho[0][i] - ExactDensity(&L, &R, x - 0.5, 0.2));
+        err[1] = err[1] + fabs(rho[1][i] - ExactDensity(&L, &R, x - 0.5, 0.2));
+        err[2] = err[2] + fabs(rho[0][i] - rho[1][i]);
+    }
+    for (int m = 0; m < 3; ++m) {
+        err[m] = err[m] / n[X];
+        fail = fail || (tol[m] < err[m]);
+    }
+    return fail;
+}
+/*
+ * A table is sampled from the ideal gas, in which pressure and temperature
+ * are bilinear in density and internal energy and hence reproduced by the
+ * lookup, while the speed of sound and the density from pressure and
+ * temperature carry the interpolation error. The lookup and its inversions
+ * are compared with the ideal gas over the table, then the Sod problem is
+ * solved with the table and with the ideal gas.
+ */
+static int CheckEquationOfState(void)
+{
+    const Real tol = 1.0e-5; /* relative tolerance of states */
+    const Real tolL1 = 2.0e-4; /* tolerance of L1 norm of density */
+    Material mat = {.tab = NULL};
+    Model ideal = {.eos = EOSIDEAL, .gamma = 1.4, .gasR = 287.058, .refRho = 1.0, .refV = 1.0, .refT = 1.0};
+    ideal.cv = ideal.gasR / (ideal.gamma - 1.0);
+    Model table = ideal;
+    table.eos = EOSTABLE;
+    table.mat = &mat;
+    char *text = WriteIdealGasTable(&ideal);
+    MountMemoryFile("artracfd.eos", text, strlen(text));
+    LoadEquationOfState(&table);
+    UnmountMemoryFiles();
+    const Real h = 1.0 / mat.dd[0]; /* density spacing of the table */
+    int fail = 0; /* failure flag */
+    Real U[DIMU] = {0.0}; /* conservative state */
+    Real Uo[2][DIMUo] = {{0.0}}; /* primitive states of ideal gas and table */
+    Real c[2] = {0.0}; /* speed of sound of ideal gas and table */
+    Real rho = 0.0; /* density */
+    Real e = 0.0; /* specific internal energy */
+    for (int i = 0; i < 14; ++i) {
+        for (int j = 0; j < 17; ++j) {
+            rho = 0.1 + 0.0937 * i;
+            e = 1.1 + 0.1713 * j;
+            U[0] = rho;
+            U[1] = rho * 0.3;
+            U[4] = rho * (e + 0.5 * 0.3 * 0.3);
+            MapPrimitive(&ideal, U, Uo[0]);
+            MapPrimitive(&table, U, Uo[1]);
+            c[0] = ComputeSoundSpeed(&ideal, U);
+            c[1] = ComputeSoundSpeed(&table, U);
+            fail = fail || (tol < fabs(Uo[1][4] / Uo[0][4] - 1.0));
+            fail = fail || (tol < fabs(Uo[1][5] / Uo[0][5] - 1.0));
+            fail = fail || (tol < fabs(c[1] / c[0] - 1.0));
+            fail = fail || (tol < fabs(InverseEos(&mat, rho, Uo[0][4]) / e - 1.0));
+            /*
+             * Temperature inverse to density is interpolated linearly between
+             * entries, where the isobar stays in the table at both entries.
+             */
+            if ((4.0 > e * rho / (rho - h)) && (1.0 < e * rho / (rho + h))) {
+                fail = fail || (tol + 0.5 * h * h / (rho * rho) <
+                        fabs(DensityEos(&mat, Uo[0][4], Uo[0][5]) / rho - 1.0));
+            }
+        }
+    }
+    String str = {'\0'}; /* case text buffer */
+    char caseText[sizeof str * 8] = {'\0'};
+    Real field[2][TRN] = {{0.0}}; /* density of ideal gas and table */
+    int n[DIMS] = {0}; /* node number */
+    snprintf(caseText, sizeof caseText, shockTube, RKTHREE, WENOFIVE, 0, EOSIDEAL);
+    fail = fail || RunSession(caseText, 0, field[0], n);
+    MountMemoryFile("artracfd.eos", text, strlen(text));
+    snprintf(caseText, sizeof caseText, shockTube, RKTHREE, WENOFIVE, 0, EOSTABLE);
+    fail = fail || RunSession(caseText, 0, field[1], n);
+    UnmountMemoryFiles();
+    RetrieveStorage(text);
+    RetrieveStorage(mat.tab);
+    if (fail) {
+        return fail;
+    }
+    Real err = 0.0; /* L1 norm of the density difference */
+    for (int i = 0; i < n[X]; ++i) {
+        err = err + fabs(field[0][i] - field[1][i]);
+    }
+    return (tolL1 < err / n[X]);
+}
+/*
+ * The density wave is advanced by the fourth order SSP Runge-Kutta schemes
+ * with CFL numbers halved in turn on a fixed mesh. The spatial error is
+ * shared with a reference run of a small CFL number, hence the difference
+ * to the reference measures the temporal error, which should fall at the
+ * fourth order.
+ */
+static int CheckTemporalOrder(void)
+{
+    const int scheme[] = {RKFIVEFOUR, RKTENFOUR};
+    const Real cfl[] = {1.6, 0.8, 0.4}; /* CFL numbers halved in turn */
+    const Real cflRef = 0.05; /* CFL number of the reference */
+    const Real end = 0.3; /* termination time */
+    const Real order = 3.5; /* least observed order */
+    String str = {'\0'}; /* case text buffer */
+    char caseText[sizeof str * 8] = {'\0'};
+    Real ref[TRN] = {0.0}; /* reference density */
+    Real rho[TRN] = {0.0}; /* density */
+    Real err[3] = {0.0}; /* max norms of temporal errors */
+    int n[DIMS] = {0}; /* node number */
+    int fail = 0; /* failure flag */
+    for (int m = 0; m < 2; ++m) {
+        snprintf(caseText, sizeof caseText, densityWave, end, cflRef, scheme[m]);
+        fail = fail || RunSession(caseText, 0, ref, n);
+        for (int c = 0; c < 3; ++c) {
+            snprintf(caseText, sizeof caseText, densityWave, end, cfl[c], scheme[m]);
+            fail = fail || RunSession(caseText, 0, rho, n);
+            err[c] = 0.0;
+            for (int i = 0; i < n[X]; ++i) {
+                err[c] = MaxReal(err[c], fabs(rho[i] - ref[i]));
+            }
+        }
+        if (fail) {
+            return fail;
+        }
+        for (int c = 1; c < 3; ++c) {
+            fail = fail || (order > log2(err[c-1] / err[c]));
+        }
+    }
+    return fail;
+}
+/*
+ * The diagonal density wave is advanced by dimension splitting without
+ * merging, with merging within steps, and with merging across steps. A
+ * merged sweep integrates the same operator over the two fused half sweeps,
+ * so only the error of the third order time scheme over the fused sweep
+ * differs, which is at most 2^3 times that of the two half sweeps. The
+ * difference of the merged runs to the unmerged one should hence stay
+ * within that factor of the temporal error of the unmerged run, measured
+ * against a reference run of a small CFL number.
+ */
+static int CheckSweepMerging(void)
+{
+    const Real cfl = 0.8; /* CFL number within the limit of merging */
+    const Real cflRef = 0.1; /* CFL number of the reference */
+    const Real factor = 8.0; /* bound of the temporal error ratio of a fused sweep */
+    String str = {'\0'}; /* case text buffer */
+    char caseText[sizeof str * 8] = {'\0'};
+    Real ref[TRN] = {0.0}; /* reference density */
+    Real rho[MERGEALL + 1][TRN] = {{0.0}}; /* density of each merging */
+    int n[DIMS] = {0}; /* node number */
+    int fail = 0; /* failure flag */
+    snprintf(caseText, sizeof caseText, diagonalWave, cflRef, RKTHREE, MERGEN);
+    fail = fail || RunSession(caseText, 0, ref, n);
+    for (int m = MERGEN; m <= MERGEALL; ++m) {
+        snprintf(caseText, sizeof caseText, diagonalWave, cfl, RKTHREE, m);
+        fail = fail || RunSession(caseText, 0, rho[m], n);
+    }
+    if (fail) {
+        return fail;
+    }
+    Real err = 0.0; /* max norm of the temporal error without merging */
+    Real diff[MERGEALL + 1] = {0.0}; /* max norms of the differences of merged runs */
+    for (int i = 0; i < n[X]; ++i) {
+        err = MaxReal(err, fabs(rho[MERGEN][i] - ref[i]));
+        for (int m = MERGESTEP; m <= MERGEALL; ++m) {
+            diff[m] = MaxReal(diff[m], fabs(rho[m][i] - rho[MERGEN][i]));
+        }
+    }
+    for (int m = MERGESTEP; m <= MERGEALL; ++m) {
+        fail = fail || (factor * err < diff[m]);
+    }
+    return fail;
+}
+/*
+ * A node box is solid except for a fluid ball in a corner, enclosed by a
+ * shell of ghost nodes, such that most layers of any direction carry no
+ * cost. The interior box is split for several numbers of threads, the
+ * units should tile the interior box without overlap, and the maximum
+ * unit cost should be within the tolerance 1.1 of the mean.
+ */
+static int CheckWorkloadBalance(void)
+{
+    const int threadN[] = {2, 3, 4, 8}; /* numbers of threads in use */
+    const Real tol = 1.1; /* tolerated ratio of the maximum to the mean unit cost */
+    const Real radius = 12.0; /* radius of the fluid ball */
+    Space space = {0};
+    Partition *const part = &(space.part);
+    for (int s = 0; s < DIMS; ++s) {
+        part->n[s] = 48;
+        part->ns[PIN][s][MIN] = 1;
+        part->ns[PIN][s][MAX] = part->n[s] - 1;
+    }
+    part->ghostCost = 4.0;
+    part->thread = 8;
+    const int totN = part->n[X] * part->n[Y] * part->n[Z];
+    space.node = AssignStorage(totN * sizeof(*space.node));
+    part->unit = AssignStorage(part->thread * sizeof(*part->unit));
+    int *cover = AssignStorage(totN * sizeof(*cover)); /* coverage count of each node */
+    Node *const node = space.node;
+    int idx = 0; /* linear array index math variable */
+    Real r = 0.0; /* distance to the center of the ball */
+    for (int k = 0; k < part->n[Z]; ++k) {
+        for (int j = 0; j < part->n[Y]; ++j) {
+            for (int i = 0; i < part->n[X]; ++i) {
+                idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
+                r = sqrt((i - 12.0) * (i - 12.0) + (j - 12.0) * (j - 12.0) + (k - 12.0) * (k - 12.0));
+                node[idx].did = (radius > r) ? 0 : 1;
+                node[idx].gst = ((radius <= r) && (radius + 1.0 > r)) ? 1 : 0;
+            }
+        }
+    }
+    const Real weight[3] = {1.0, part->ghostCost, 0.0}; /* fluid, ghost, and solid costs */
+    const int boxN = (part->n[X] - 2) * (part->n[Y] - 2) * (part->n[Z] - 2);
+    int fail = 0; /* failure flag */
+    int nodeN = 0; /* nodes covered by the units */
+    Real cost = 0.0; /* cost of a unit */
+    Real max = 0.0; /* maximum unit cost */
+    Real sum = 0.0; /* total cost */
+    for (int m = 0; m < (int)(sizeof threadN / sizeof *threadN); ++m) {
+        part->active = threadN[m];
+        part->unitN = 0;
+        BalanceWorkload(&space);
+        fail = fail || (threadN[m] != part->unitN);
+        memset(cover, 0, totN * sizeof(*cover));
+        nodeN = 0;
+        max = 0.0;
+        sum = 0.0;
+        for (int u = 0; u < part->unitN; ++u) {
+            for (int s = 0; s < DIMS; ++s) {
+                fail = fail || (part->ns[PIN][s][MIN] > part->unit[u][s][MIN]) ||
+                    (part->ns[PIN][s][MAX] < part->unit[u][s][MAX]);
+            }
+            cost = 0.0;
+            for (int k = part->unit[u][Z][MIN]; k < part->unit[u][Z][MAX]; ++k) {
+                for (int j = part->unit[u][Y][MIN]; j < part->unit[u][Y][MAX]; ++j) {
+                    for (int i = part->unit[u][X][MIN]; i < part->unit[u][X][MAX]; ++i) {
+                        idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
+                        cost = cost + weight[(0 == node[idx].did) ? 0 : ((0 < node[idx].gst) ? 1 : 2)];
+                        fail = fail || (0 != cover[idx]);
+                        ++cover[idx];
+                        ++nodeN;
+                    }
+                }
+            }
+            max = MaxReal(max, cost);
+            sum = sum + cost;
+        }
+        fail = fail || (boxN != nodeN) || (tol * sum < max * part->unitN);
+    }
+    RetrieveStorage(cover);
+    RetrieveStorage(part->unit);
+    RetrieveStorage(space.node);
+    return fail;
+}
+/*
+ * The pressure pulse runs out of the east boundary before the termination
+ * time, then the pressure left in the domain is the reflected wave. The
+ * characteristic condition without relaxation should reflect less than
+ * 0.1% of the amplitude, and the partially nonreflecting condition of the
+ * relaxation rate 0.3 less than 2%, as relaxation towards the reference
+ * pressure lets in a wave proportional to the rate.
+ */
+static int CheckNonreflectingOutflow(void)
+{
+    const Real amp = 0.01; /* pressure amplitude of the pulse */
+    const Real end = 0.8; /* termination time after the pulse has left */
+    const Real rate[2] = {0.0, 0.3}; /* relaxation rates */
+    const Real tol[2] = {1.0e-3, 2.0e-2}; /* tolerated reflections relative to the amplitude */
+    String str = {'\0'}; /* case text buffer */
+    char caseText[sizeof str * 8] = {'\0'};
+    Real p[TRN] = {0.0}; /* pressure */
+    Real ref = 0.0; /* max norm of the reflected pressure */
+    int n[DIMS] = {0}; /* node number */
+    int fail = 0; /* failure flag */
+    for (int m = 0; m < 2; ++m) {
+        snprintf(caseText, sizeof caseText, pressurePulse, end, rate[m], rate[m]);
+        fail = fail || RunSession(caseText, 4, p, n);
+        if (fail) {
+            return fail;
+        }
+        ref = 0.0;
+        for (int i = 0; i < n[X]; ++i) {
+            ref = MaxReal(ref, fabs(p[i] - 1.0));
+        }
+        fail = fail || (tol[m] * amp < ref);
+    }
+    return fail;
+}
+/*
+ * The uniform flow is advanced step by step. The first hold steps should
+ * be explicit steps of the acoustic time step, and all later steps dual
+ * time steps of 10 acoustic time steps, as the Mach number stays below the
+ * threshold. Both kinds of steps should keep the flow uniform within
+ * round-off.
+ */
+static int CheckDualTime(void)
+{
+    const int holdN = 3; /* calm steps before dual time steps */
+    const int stepN = 8; /* steps advanced */
+    const Real ratio = 10.0; /* dual time step in acoustic time steps */
+    const Real tol = 1.0e-10; /* tolerance of round-off */
+    const int var[3] = {0, 1, 4}; /* density, velocity, and pressure */
+    const Real Uo[3] = {1.0, 0.05, 1.0}; /* uniform state */
+    String str = {'\0'}; /* case text buffer */
+    char caseText[sizeof str * 8] = {'\0'};
+    snprintf(caseText, sizeof caseText, uniformFlow, holdN);
+    Session *session = OpenSession(caseText, noGeometry);
+    if (NULL == session) {
+        return 1;
+    }
+    Real dt[stepN]; /* time step of each step */
+    Real now = 0.0; /* time before a step */
+    int fail = 0; /* failure flag */
+    for (int m = 0; (m < stepN) && !fail; ++m) {
+        fail = (1 != AdvanceSession(session, 1));
+        dt[m] = SessionTime(session) - now;
+        now = SessionTime(session);
+    }
+    for (int m = 0; (m < stepN) && !fail; ++m) {
+        fail = (tol < fabs(dt[m] / (((m < holdN) ? 1.0 : ratio) * dt[0]) - 1.0));
+    }
+    Real domain[DIMS][LIMIT] = {{0.0}};
+    int n[DIMS] = {0}; /* node number */
+    SessionMesh(session, n, domain);
+    const int nodeN = n[X] * n[Y] * n[Z];
+    Real *field = AssignStorage(nodeN * sizeof(*field));
+    for (int v = 0; (v < 3) && !fail; ++v) {
+        fail = (SESSIONOK != CopySessionField(session, var[v], field));
+        for (int idx = 0; idx < nodeN; ++idx) {
+            fail = fail || !(tol > fabs(field[idx] - Uo[v]));
+        }
+    }
+    RetrieveStorage(field);
+    CloseSession(session);
+    return fail;
+}
+/*
+ * Table of the ideal gas in the format of artracfd.eos, covering density
+ * in [0.05, 1.5] and internal energy in [1, 4].
+ */
+static char *WriteIdealGasTable(const Model *model)
+{
+    const int tn[2] = {59, 121}; /* entries of density and internal energy */
+    const Real bound[2][LIMIT] = {{0.05, 1.5}, {1.0, 4.0}};
+    const size_t size = (size_t)(tn[0] * tn[1] + 4) * 80; /* text size */
+    char *text = AssignStorage(size);
+    size_t len = snprintf(text, size, "table begin\n%d, %d\n%.17g, %.17g\n%.17g, %.17g\n",
+            tn[0], tn[1], bound[0][MIN], bound[0][MAX], bound[1][MIN], bound[1][MAX]);
+    Real rho = 0.0; /* density */
+    Real e = 0.0; /* specific internal energy */
+    Real p = 0.0; /* pressure */
+    for (int i = 0; i < tn[0]; ++i) {
+        for (int j = 0; j < tn[1]; ++j) {
+            rho = bound[0][MIN] + i * (bound[0][MAX] - bound[0][MIN]) / (tn[0] - 1);
+            e = bound[1][MIN] + j * (bound[1][MAX] - bound[1][MIN]) / (tn[1] - 1);
+            p = (model->gamma - 1.0) * rho * e;
+            len = len + snprintf(text + len, size - len, "%.17g, %.17g, %.17g\n",
+                    p, e / model->cv, sqrt(model->gamma * p / rho));
+        }
+    }
+    return text;
+}
+/*
+ * Run a session to the termination time and copy a primitive variable
+ * along the x axis, which is the leading row of the field.
+ */
+static int RunSession(const char *caseText, const int var, Real field[restrict], int n[restrict])
+{
+    Real domain[DIMS][LIMIT] = {{0.0}};
+    Session *session = OpenSession(caseText, noGeometry);
+    if (NULL == session) {
+        return 1;
+    }
+    int status = AdvanceSession(session, INT_MAX);
+    SessionMesh(session, n, domain);
+    Real *all = AssignStorage(n[X] * n[Y] * n[Z] * sizeof(*all));
+    status = (SESSIONFAIL == status) || (SESSIONOK != CopySessionField(session, var, all));
+    memcpy(field, all, n[X] * sizeof(*field));
+    RetrieveStorage(all);
+    CloseSession(session);
+    return status;
+}
+/*
+ * Exact density of a Riemann problem of the ideal gas with gamma = 1.4 at
+ * position x from the diaphragm and time t. The star pressure is found by
+ * bisection of the pressure functions, see Toro, E.F., 2009. Riemann
+ * Solvers and Numerical Methods for Fluid Dynamics, Chapter 4.
+ */
+static Real ExactDensity(const GasState *L, const GasState *R, const Real x, const Real t)
+{
+    const Real gamma = 1.4;
+    const Real cL = sqrt(gamma * L->p / L->rho);
+    const Real cR = sqrt(gamma * R->p / R->rho);
+    Real pMin = MinReal(L->p, R->p) * 1.0e-6;
+    Real pMax = 10.0 * MaxReal(L->p, R->p);
+    Real p = 0.0; /* star pressure */
+    for (int n = 0; n < 100; ++n) {
+        p = 0.5 * (pMin + pMax);
+        if (0.0 < PressureFunction(L, p, gamma) + PressureFunction(R, p, gamma) + R->u - L->u) {
+            pMax = p;
+        } else {
+            pMin = p;
+        }
+    }
+    const Real u = 0.5 * (L->u + R->u) + 0.5 * (PressureFunction(R, p, gamma) - PressureFunction(L, p, gamma));
+    const Real xi = x / t;
+    const Real gm = (gamma - 1.0) / (gamma + 1.0);
+    if (xi < u) { /* left of the contact */
+        if (p > L->p) { /* shock */
+            const Real S = L->u - cL * sqrt((gamma + 1.0) / (2.0 * gamma) * p / L->p + (gamma - 1.0) / (2.0 * gamma));
+            return (xi < S) ? L->rho : L->rho * (p / L->p + gm) / (gm * p / L->p + 1.0);
+        }
+        const Real c = cL * pow(p / L->p, (gamma - 1.0) / (2.0 * gamma));
+        if (xi < L->u - cL) {
+            return L->rho;
+        }
+        if (xi > u - c) {
+            return L->rho * pow(p / L->p, 1.0 / gamma);
+        }
+        return L->rho * pow(2.0 / (gamma + 1.0) + gm / cL * (L->u - xi), 2.0 / (gamma - 1.0));
+    }
+    if (p > R->p) { /* shock */
+        const Real S = R->u + cR * sqrt((gamma + 1.0) / (2.0 * gamma) * p / R->p + (gamma - 1.0) / (2.0 * gamma));
+        return (xi > S) ? R->rho : R->rho * (p / R->p + gm) / (gm * p / R->p + 1.0);
+    }
+    const Real c = cR * pow(p / R->p, (gamma - 1.0) / (2.0 * gamma));
+    if (xi > R->u + cR) {
+        return R->rho;
+    }
+    if (xi < u + c) {
+        return R->rho * pow(p / R->p, 1.0 / gamma);
+    }
+    return R->rho * pow(2.0 / (gamma + 1.0) - gm / cR * (R->u - xi), 2.0 / (gamma - 1.0));
+}
+static Real PressureFunction(const GasState *K, const Real p, const Real gamma)
+{
+    const Real c = sqrt(gamma * K->p / K->rho);
+    if (p > K->p) {
+        const Real A = 2.0 / ((gamma + 1.0) * K->rho);
+        const Real B = (gamma - 1.0) / (gamma + 1.0) * K->p;
+        return (p - K->p) * sqrt(A / (p + B));
+    }
+    return 2.0 * c / (gamma - 1.0) * (pow(p / K->p, (gamma - 1.0) / (2.0 * gamma)) - 1.0);
+}
 /* a good practice: end file with a newline */
 
@@ -28,6 +28,14 @@
  */
 extern void ComputeSolutionError(Space *);
 extern void ComputeSolutionFunctional(const Time *, Space *, const Model *);
+/*
+ * Numerical tests
+ *
+ * Function
+ *      Run the self checks of numerical components on small synthetic
+ *      problems and report each one. Return the number of failed checks.
+ */
+extern int RunNumericalTests(void);
 #endif
 /* a good practice: end file with a newline */
 
@@ -55,6 +55,10 @@ extern void ReadStructuredDataParaview(Time *, Space *, const Model *);
  */
 extern void WritePolyDataParaview(const Time *, const Geometry *const);
 extern void ReadPolyDataParaview(const Time *, Geometry *const);
+/*
+ * Surface field writer
+ */
+extern void WriteSurfaceDataParaview(const Time *, const Surface *);
 #endif
 /* a good practice: end file with a newline */
 
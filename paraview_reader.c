@@ -36,7 +36,7 @@ void ReadStructuredDataParaview(Time *time, Space *space, const Model *model)
         .rname = "field",
         .bname = {'\0'},
         .fname = {'\0'},
-        .fext = ".vts",
+        .fext = ".vti",
         .fmt = "%s%05d",
         .intType = "Int32",
         .floatType = "Float32",
@@ -114,7 +114,7 @@ static void ReadStructuredData(Space *space, const Model *model, PvSet *pvSet)
                             break;
                         case 4: /* p */
                             U[4] = 0.5 * (U[1] * U[1] + U[2] * U[2] + U[3] * U[3]) / U[0] +
-                                data / (model->gamma - 1.0);
+                                ComputeInternalEnergy(model, U[0], data);
                             break;
                         default:
                             break;
@@ -197,7 +197,7 @@ static void ReadPolygonPolyData(const int pm, const int pn, Geometry *const geo,
     /* get rid of redundant lines */
     ReadInLine(fp, "<PolyData>");
     for (int m = pm; m < pn; ++m) {
-        poly = geo->poly + m;
+        poly = geo->poly + geo->pos[m];
         Sread(fp, 0, "");
         Sread(fp, 0, "");
         Sread(fp, 1, "%*s %*s %d", &(poly->vertN));
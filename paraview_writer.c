@@ -27,6 +27,7 @@ static void PointPolyDataWriter(const Time *, const Geometry *const);
 static void WritePointPolyData(const int, const int, const Geometry *const, PvSet *);
 static void PolygonPolyDataWriter(const Time *, const Geometry *const);
 static void WritePolygonPolyData(const int, const int, const Geometry *const, PvSet *);
+static void WriteSurfaceData(const Surface *, PvSet *);
 /****************************************************************************
  * Function definitions
  ****************************************************************************/
@@ -36,7 +37,7 @@ void WriteStructuredDataParaview(const Time *time, const Space *space, const Mod
         .rname = "field",
         .bname = {'\0'},
         .fname = {'\0'},
-        .fext = ".vts",
+        .fext = ".vti",
         .fmt = "%s%05d",
         .intType = "Int32",
         .floatType = "Float32",
@@ -106,12 +107,18 @@ static void WriteStructuredData(const Space *space, const Model *model, PvSet *p
     const Real *restrict U = NULL;
     int idx = 0; /* linear array index math variable */
     IntVec ne = {0}; /* i, j, k node number in each part */
+    RealVec O = {0.0}; /* coordinates of the first node */
     ne[X] = part->ns[PIO][X][MAX] - part->ns[PIO][X][MIN] - 1;
     ne[Y] = part->ns[PIO][Y][MAX] - part->ns[PIO][Y][MIN] - 1;
     ne[Z] = part->ns[PIO][Z][MAX] - part->ns[PIO][Z][MIN] - 1;
+    for (int s = 0; s < DIMS; ++s) {
+        O[s] = MapPoint(part->ns[PIO][s][MIN], part->domain[s][MIN], part->d[s], part->ng[s]);
+    }
+    /* uniform grid is fully described by origin and spacing */
     fprintf(fp, "<?xml version=\"1.0\"?>\n");
-    fprintf(fp, "<VTKFile type=\"StructuredGrid\" version=\"1.0\" byte_order=\"%s\">\n", pvSet->byteOrder);
-    fprintf(fp, "  <StructuredGrid WholeExtent=\"%d %d %d %d %d %d\">\n", 0, ne[X], 0, ne[Y], 0, ne[Z]);
+    fprintf(fp, "<VTKFile type=\"ImageData\" version=\"1.0\" byte_order=\"%s\">\n", pvSet->byteOrder);
+    fprintf(fp, "  <ImageData WholeExtent=\"%d %d %d %d %d %d\" Origin=\"%.15g %.15g %.15g\" Spacing=\"%.15g %.15g %.15g\">\n",
+            0, ne[X], 0, ne[Y], 0, ne[Z], O[X], O[Y], O[Z], part->d[X], part->d[Y], part->d[Z]);
     fprintf(fp, "    <Piece Extent=\"%d %d %d %d %d %d\">\n", 0, ne[X], 0, ne[Y], 0, ne[Z]);
     fprintf(fp, "      <PointData>\n");
     for (int s = 0; s < pvSet->scaN; ++s) {
@@ -136,13 +143,13 @@ static void WriteStructuredData(const Space *space, const Model *model, PvSet *p
                             data = U[3] / U[0];
                             break;
                         case 4: /* p */
-                            data = ComputePressure(model->gamma, U);
+                            data = ComputePressure(model, U);
                             break;
                         case 5: /* T */
-                            data = ComputeTemperature(model->cv, U);
+                            data = ComputeTemperature(model, U);
                             break;
                         case 6: /* node flag */
-                            data = node[idx].did;
+                            data = (0 < node[idx].did) ? space->geo.poly[node[idx].did-1].pid : node[idx].did;
                             break;
                         case 7: /* face flag */
                             data = node[idx].fid;
@@ -182,23 +189,8 @@ static void WriteStructuredData(const Space *space, const Model *model, PvSet *p
     fprintf(fp, "      </PointData>\n");
     fprintf(fp, "      <CellData>\n");
     fprintf(fp, "      </CellData>\n");
-    fprintf(fp, "      <Points>\n");
-    fprintf(fp, "        <DataArray type=\"%s\" Name=\"points\" NumberOfComponents=\"3\" format=\"ascii\">\n", pvSet->floatType);
-    fprintf(fp, "          ");
-    for (int k = part->ns[PIO][Z][MIN]; k < part->ns[PIO][Z][MAX]; ++k) {
-        for (int j = part->ns[PIO][Y][MIN]; j < part->ns[PIO][Y][MAX]; ++j) {
-            for (int i = part->ns[PIO][X][MIN]; i < part->ns[PIO][X][MAX]; ++i) {
-                Vec[X] = MapPoint(i, part->domain[X][MIN], part->d[X], part->ng[X]);
-                Vec[Y] = MapPoint(j, part->domain[Y][MIN], part->d[Y], part->ng[Y]);
-                Vec[Z] = MapPoint(k, part->domain[Z][MIN], part->d[Z], part->ng[Z]);
-                fprintf(fp, "%.6g %.6g %.6g ", Vec[X], Vec[Y], Vec[Z]);
-            }
-        }
-    }
-    fprintf(fp, "\n        </DataArray>\n");
-    fprintf(fp, "      </Points>\n");
     fprintf(fp, "    </Piece>\n");
-    fprintf(fp, "  </StructuredGrid>\n");
+    fprintf(fp, "  </ImageData>\n");
     fprintf(fp, "</VTKFile>\n");
     fclose(fp);
     return;
@@ -254,7 +246,7 @@ static void WritePointPolyData(const int pm, const int pn, const Geometry *const
         for (int n = pm; n < pn; ++n) {
             switch (s) {
                 case 0:
-                    data = geo->poly[n].r;
+                    data = geo->poly[geo->pos[n]].r;
                     break;
                 case 1:
                     data = n + 1;
@@ -270,9 +262,9 @@ static void WritePointPolyData(const int pm, const int pn, const Geometry *const
         fprintf(fp, "        <DataArray type=\"%s\" Name=\"%s\" NumberOfComponents=\"3\" format=\"ascii\">\n", pvSet->floatType, pvSet->vec[s]);
         fprintf(fp, "          ");
         for (int n = pm; n < pn; ++n) {
-            Vec[X] = geo->poly[n].V[TO][X];
-            Vec[Y] = geo->poly[n].V[TO][Y];
-            Vec[Z] = geo->poly[n].V[TO][Z];
+            Vec[X] = geo->poly[geo->pos[n]].V[TO][X];
+            Vec[Y] = geo->poly[geo->pos[n]].V[TO][Y];
+            Vec[Z] = geo->poly[geo->pos[n]].V[TO][Z];
             fprintf(fp, "%.6g %.6g %.6g ", Vec[X], Vec[Y], Vec[Z]);
         }
         fprintf(fp, "\n        </DataArray>\n");
@@ -284,9 +276,9 @@ static void WritePointPolyData(const int pm, const int pn, const Geometry *const
     fprintf(fp, "        <DataArray type=\"%s\" Name=\"points\" NumberOfComponents=\"3\" format=\"ascii\">\n", pvSet->floatType);
     fprintf(fp, "          ");
     for (int n = pm; n < pn; ++n) {
-        Vec[X] = geo->poly[n].O[X];
-        Vec[Y] = geo->poly[n].O[Y];
-        Vec[Z] = geo->poly[n].O[Z];
+        Vec[X] = geo->poly[geo->pos[n]].O[X];
+        Vec[Y] = geo->poly[geo->pos[n]].O[Y];
+        Vec[Z] = geo->poly[geo->pos[n]].O[Z];
         fprintf(fp, "%.6g %.6g %.6g ", Vec[X], Vec[Y], Vec[Z]);
     }
     fprintf(fp, "\n        </DataArray>\n");
@@ -348,7 +340,7 @@ static void WritePolygonPolyData(const int pm, const int pn, const Geometry *con
     fprintf(fp, "<VTKFile type=\"PolyData\" version=\"1.0\" byte_order=\"%s\">\n", pvSet->byteOrder);
     fprintf(fp, "  <PolyData>\n");
     for (int m = pm; m < pn; ++m) {
-        poly = geo->poly + m;
+        poly = geo->poly + geo->pos[m];
         fprintf(fp, "    <Piece NumberOfPoints=\"%d\" NumberOfVerts=\"0\" NumberOfPolys=\"%d\">\n", poly->vertN, poly->faceN);
         fprintf(fp, "      <!--\n");
         fprintf(fp, "        vertN = %d\n", poly->vertN);
@@ -396,5 +388,139 @@ static void WritePolygonPolyData(const int pm, const int pn, const Geometry *con
     fclose(fp);
     return;
 }
+void WriteSurfaceDataParaview(const Time *time, const Surface *surf)
+{
+    PvSet pvSet = { /* initialize environment */
+        .rname = "surface",
+        .bname = {'\0'},
+        .fname = {'\0'},
+        .fext = ".vtp",
+        .fmt = "%s%05d",
+        .intType = "Int32",
+        .floatType = "Float32",
+        .byteOrder = "LittleEndian",
+        .scaN = 3,
+        .sca = {"p", "T", "did"},
+        .vecN = 1,
+        .vec = {"tau"},
+    };
+    if (BigEndian()) { /* raw data are appended in host byte order */
+        snprintf(pvSet.byteOrder, sizeof(PvStr), "%s", "BigEndian");
+    }
+    snprintf(pvSet.bname, sizeof(PvStr), pvSet.fmt, pvSet.rname, time->dataC);
+    if (0 == time->stepC) { /* initialization step */
+        InitializeTransientCaseFile(&pvSet);
+    }
+    WriteCaseFile(time, &pvSet);
+    WriteSurfaceData(surf, &pvSet);
+    return;
+}
+/*
+ * Data arrays are appended in raw binary after the XML structure. Each
+ * array is preceded by its size in bytes and located by its offset from
+ * the start of the appended data.
+ */
+static void WriteSurfaceData(const Surface *surf, PvSet *pvSet)
+{
+    snprintf(pvSet->fname, sizeof(PvStr), "%s%s", pvSet->bname, pvSet->fext);
+    FILE *fp = Fopen(pvSet->fname, "wb");
+    const int sca[PVSCAN] = {0, 1, 5}; /* data column of each scalar variable */
+    const int vec[PVVECN] = {2}; /* leading data column of each vector variable */
+    const int cellN = surf->vertN + surf->faceN;
+    float data = 0.0f; /* binary float data */
+    unsigned int size = 0; /* byte size of a data array */
+    unsigned int offset = 0; /* offset of a data array in appended data */
+    fprintf(fp, "<?xml version=\"1.0\"?>\n");
+    fprintf(fp, "<VTKFile type=\"PolyData\" version=\"1.0\" byte_order=\"%s\" header_type=\"UInt32\">\n",
+            pvSet->byteOrder);
+    fprintf(fp, "  <PolyData>\n");
+    fprintf(fp, "    <Piece NumberOfPoints=\"%d\" NumberOfVerts=\"%d\" NumberOfPolys=\"%d\">\n",
+            surf->pointN, surf->vertN, surf->faceN);
+    fprintf(fp, "      <PointData>\n");
+    fprintf(fp, "      </PointData>\n");
+    fprintf(fp, "      <CellData>\n");
+    for (int s = 0; s < pvSet->scaN; ++s) {
+        fprintf(fp, "        <DataArray type=\"%s\" Name=\"%s\" format=\"appended\" offset=\"%u\"/>\n",
+                pvSet->floatType, pvSet->sca[s], offset);
+        offset = offset + sizeof(size) + cellN * sizeof(data);
+    }
+    for (int s = 0; s < pvSet->vecN; ++s) {
+        fprintf(fp, "        <DataArray type=\"%s\" Name=\"%s\" NumberOfComponents=\"3\" format=\"appended\" "
+                "offset=\"%u\"/>\n", pvSet->floatType, pvSet->vec[s], offset);
+        offset = offset + sizeof(size) + DIMS * cellN * sizeof(data);
+    }
+    fprintf(fp, "      </CellData>\n");
+    fprintf(fp, "      <Points>\n");
+    fprintf(fp, "        <DataArray type=\"%s\" Name=\"points\" NumberOfComponents=\"3\" format=\"appended\" "
+            "offset=\"%u\"/>\n", pvSet->floatType, offset);
+    offset = offset + sizeof(size) + DIMS * surf->pointN * sizeof(data);
+    fprintf(fp, "      </Points>\n");
+    fprintf(fp, "      <Verts>\n");
+    fprintf(fp, "        <DataArray type=\"%s\" Name=\"connectivity\" format=\"appended\" offset=\"%u\"/>\n",
+            pvSet->intType, offset);
+    offset = offset + sizeof(size) + surf->vertN * sizeof(int);
+    fprintf(fp, "        <DataArray type=\"%s\" Name=\"offsets\" format=\"appended\" offset=\"%u\"/>\n",
+            pvSet->intType, offset);
+    offset = offset + sizeof(size) + surf->vertN * sizeof(int);
+    fprintf(fp, "      </Verts>\n");
+    fprintf(fp, "      <Polys>\n");
+    fprintf(fp, "        <DataArray type=\"%s\" Name=\"connectivity\" format=\"appended\" offset=\"%u\"/>\n",
+            pvSet->intType, offset);
+    offset = offset + sizeof(size) + POLYN * surf->faceN * sizeof(int);
+    fprintf(fp, "        <DataArray type=\"%s\" Name=\"offsets\" format=\"appended\" offset=\"%u\"/>\n",
+            pvSet->intType, offset);
+    fprintf(fp, "      </Polys>\n");
+    fprintf(fp, "    </Piece>\n");
+    fprintf(fp, "  </PolyData>\n");
+    fprintf(fp, "  <AppendedData encoding=\"raw\">\n");
+    fprintf(fp, "   _");
+    for (int s = 0; s < pvSet->scaN; ++s) {
+        size = cellN * sizeof(data);
+        fwrite(&size, sizeof(size), 1, fp);
+        for (int n = 0; n < cellN; ++n) {
+            data = surf->data[n][sca[s]];
+            fwrite(&data, sizeof(data), 1, fp);
+        }
+    }
+    for (int s = 0; s < pvSet->vecN; ++s) {
+        size = DIMS * cellN * sizeof(data);
+        fwrite(&size, sizeof(size), 1, fp);
+        for (int n = 0; n < cellN; ++n) {
+            for (int m = 0; m < DIMS; ++m) {
+                data = surf->data[n][vec[s] + m];
+                fwrite(&data, sizeof(data), 1, fp);
+            }
+        }
+    }
+    size = DIMS * surf->pointN * sizeof(data);
+    fwrite(&size, sizeof(size), 1, fp);
+    for (int n = 0; n < surf->pointN; ++n) {
+        for (int m = 0; m < DIMS; ++m) {
+            data = surf->v[n][m];
+            fwrite(&data, sizeof(data), 1, fp);
+        }
+    }
+    size = surf->vertN * sizeof(int);
+    fwrite(&size, sizeof(size), 1, fp);
+    for (int n = 0; n < surf->vertN; ++n) {
+        fwrite(&n, sizeof(int), 1, fp);
+    }
+    fwrite(&size, sizeof(size), 1, fp);
+    for (int n = 1; n <= surf->vertN; ++n) {
+        fwrite(&n, sizeof(int), 1, fp);
+    }
+    size = POLYN * surf->faceN * sizeof(int);
+    fwrite(&size, sizeof(size), 1, fp);
+    fwrite(surf->f, sizeof(int), POLYN * surf->faceN, fp);
+    size = surf->faceN * sizeof(int);
+    fwrite(&size, sizeof(size), 1, fp);
+    for (int n = 1, m = POLYN; n <= surf->faceN; ++n, m = m + POLYN) {
+        fwrite(&m, sizeof(int), 1, fp);
+    }
+    fprintf(fp, "\n  </AppendedData>\n");
+    fprintf(fp, "</VTKFile>\n");
+    fclose(fp);
+    return;
+}
 /* a good practice: end file with a newline */
 
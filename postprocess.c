@@ -14,6 +14,8 @@
 #include "postprocess.h"
 #include <stdio.h> /* standard library for input and output */
 #include <stdlib.h> /* dynamic memory allocation and exit */
+#include "data_stage.h"
+#include "domain_partition.h"
 #include "commons.h"
 /****************************************************************************
  * Static Function Declarations
@@ -25,6 +27,8 @@ static void ReleaseProgramMemory(Time *, Space *, Model *);
 int Postprocess(Time *time, Space *space, Model *model)
 {
     ShowInfo("Postprocessing...\n");
+    ShowInfo("  draining staged output...\n");
+    FinalizeStage();
     ShowInfo("  releasing memory...\n");
     ReleaseProgramMemory(time, space, model);
     ShowInfo("  computing finished, successfully exit.\n");
@@ -36,7 +40,7 @@ static void ReleaseProgramMemory(Time *time, Space *space, Model *model)
     /* geometry related */
     Geometry *const geo = &(space->geo);
     Polyhedron *poly = NULL;
-    for (int n = geo->sphN; n < geo->totN; ++n) {
+    for (int n = geo->sphN; (NULL != geo->poly) && (n < geo->totN); ++n) {
         poly = geo->poly + n;
         RetrieveStorage(poly->f);
         RetrieveStorage(poly->Nf);
@@ -44,11 +48,19 @@ static void ReleaseProgramMemory(Time *time, Space *space, Model *model)
         RetrieveStorage(poly->Ne);
         RetrieveStorage(poly->v);
         RetrieveStorage(poly->Nv);
+        RetrieveStorage(poly->fo);
+        RetrieveStorage(poly->bv);
+        RetrieveStorage(poly->sdf);
+        RetrieveStorage(poly->sdfF);
     }
     RetrieveStorage(geo->poly);
+    RetrieveStorage(geo->pos);
     RetrieveStorage(geo->col);
+    RetrieveStorage(geo->cost);
     /* space related */
     Partition *const part = &(space->part);
+    FinalizeWorkPool(part->pool);
+    part->pool = NULL;
     RetrieveStorage(part->typeBC);
     RetrieveStorage(part->N);
     RetrieveStorage(part->varBC);
@@ -56,10 +68,16 @@ static void ReleaseProgramMemory(Time *time, Space *space, Model *model)
     RetrieveStorage(part->posIC);
     RetrieveStorage(part->varIC);
     RetrieveStorage(space->node);
+    RetrieveStorage(part->unit);
     /* time related */
+    RetrieveStorage(time->cvgId);
+    RetrieveStorage(time->img);
     RetrieveStorage(time->lp);
     RetrieveStorage(time->pp);
     /* model related */
+    if (NULL != model->mat) {
+        RetrieveStorage(model->mat->tab);
+    }
     RetrieveStorage(model->mat);
     return;
 }
@@ -17,6 +17,8 @@
 #include "case_loader.h"
 #include "cfd_parameters.h"
 #include "domain_partition.h"
+#include "equation_of_state.h"
+#include "data_stage.h"
 #include "commons.h"
 /****************************************************************************
  * Static Function Declarations
@@ -37,6 +39,11 @@ int Preprocess(Time *time, Space *space, Model *model)
     PartitionDomain(space);
     ShowInfo("  allocating memory...\n");
     AllocateProgramMemory(space, model);
+    space->part.pool = InitializeWorkPool(space->part.thread);
+    ShowInfo("  loading material data...\n");
+    LoadEquationOfState(model);
+    ShowInfo("  staging output...\n");
+    InitializeStage(time);
     ShowInfo("Session");
     return 0;
 }
@@ -50,9 +57,18 @@ static void AllocateProgramMemory(Space *space, Model *model)
     Geometry *const geo = &(space->geo);
     const int totN = part->n[X] * part->n[Y] * part->n[Z];
     space->node = AssignStorage(totN * sizeof(*space->node));
+    part->unit = AssignStorage(part->thread * sizeof(*part->unit));
     if (0 != geo->totN) {
         geo->col = AssignStorage(geo->totN * sizeof(*geo->col));
         geo->poly = AssignStorage(geo->totN * sizeof(*geo->poly));
+        geo->pos = AssignStorage(geo->totN * sizeof(*geo->pos));
+        for (int n = 0; n < geo->totN; ++n) {
+            geo->pos[n] = n;
+            geo->poly[n].pid = n + 1;
+        }
+        if (0 < geo->costN) {
+            geo->cost = AssignStorage(geo->totN * sizeof(*geo->cost));
+        }
     }
     model->mat = AssignStorage(sizeof(*model->mat));
     return;
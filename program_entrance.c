@@ -17,6 +17,7 @@
 #include <string.h> /* manipulating strings */
 #include "calculator.h"
 #include "case_generator.h"
+#include "numerical_test.h"
 #include "commons.h"
 /****************************************************************************
  * Static Function Declarations
@@ -51,7 +52,7 @@ int EnterProgram(int argc, char *argv[], Control *control, Space *space)
             exit(EXIT_FAILURE);
         }
         switch (argv[1][1]) { /* argv[1][1] is the actual option character */
-            /* run mode: -m [gui], [serial], [omp], [mpi], [gpu] */
+            /* run mode: -m [gui], [serial], [omp], [mpi], [gpu], [test] */
             case 'm':
                 ++argv;
                 --argc;
@@ -75,6 +76,10 @@ int EnterProgram(int argc, char *argv[], Control *control, Space *space)
                     control->runMode = 'g';
                     break;
                 }
+                if (0 == strcmp(argv[1], "test")) {
+                    control->runMode = 't';
+                    break;
+                }
                 ShowError("bad option: %s\n", argv[1]);
                 exit(EXIT_FAILURE);
                 /* number of processors: -n nx*ny*nz */
@@ -124,6 +129,8 @@ static void ConfigureProgram(Control *control, Space *space)
             break;
         case 'g': /* gpu mode */
             break;
+        case 't': /* test mode */
+            exit((0 == RunNumericalTests()) ? EXIT_SUCCESS : EXIT_FAILURE);
         default:
             break;
     }
@@ -188,7 +195,7 @@ static void ShowManual(void)
     ShowInfo("SYNOPSIS:\n");
     ShowInfo("        artracfd [-m runmode] [-n nprocessors]\n");
     ShowInfo("OPTIONS:\n");
-    ShowInfo("        -m runmode        run mode: gui, serial, omp, mpi, gpu\n");
+    ShowInfo("        -m runmode        run mode: gui, serial, omp, mpi, gpu, test\n");
     ShowInfo("        -n nprocessors    processors per dimension: nx*ny*nz\n");
     ShowInfo("NOTES:\n");
     ShowInfo("        default run mode is gui\n");
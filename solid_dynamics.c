@@ -20,17 +20,25 @@
 #include "immersed_boundary.h"
 #include "computational_geometry.h"
 #include "linear_system.h"
+#include "timer.h"
 #include "cfd_commons.h"
 #include "commons.h"
 /****************************************************************************
  * Static Function Declarations
  ****************************************************************************/
 static void ApplyKinematics(const Real, const Real, Space *);
-static void ApplyCollision(Space *);
+static void ApplyCollision(Space *, const Model *);
 static void DetectColState(const int, const int, const int, const int, const int,
         const int [restrict][DIMS], const Node *const, const Partition *const,
         Geometry *const);
-static void AddColObject(const int [restrict], const int, Geometry *const);
+static void DetectContact(const int, Geometry *const);
+static Real ComputeContact(const Polyhedron *, const Polyhedron *, Real [restrict]);
+static Real SphereMeshContact(const Polyhedron *, const Polyhedron *, Real [restrict]);
+static Real MeshMeshContact(const Polyhedron *, const Polyhedron *, Real [restrict]);
+static Real VertexMeshContact(const Polyhedron *, const Polyhedron *, const Real,
+        Real, Real [restrict]);
+static int BoxOverlap(const Real [restrict][LIMIT], const Real [restrict][LIMIT]);
+static void AddColObject(const Real [restrict], const int, Geometry *const);
 static void ApplyMotion(const Real, Space *);
 /****************************************************************************
  * Function definitions
@@ -40,7 +48,7 @@ void EvolveSolidDynamics(const Real now, const Real dt, Space *space, const Mode
     IntegrateSurfaceForce(space, model);
     ApplyKinematics(now, dt, space);
     if (1 != model->psi) {
-        ApplyCollision(space);
+        ApplyCollision(space, model);
     }
     ApplyMotion(dt, space);
     ComputeGeometricField(space, model);
@@ -80,11 +88,13 @@ void IntegrateSurfaceForce(Space *space, const Model *model)
     Real Vn = zero; /* velocity projection */
     Real mu = zero; /* viscosity */
     Real ds = zero; /* infinitesimal area for integration */
+    Timer tm; /* timer for cost accounting */
     for (int n = 0; n < geo->totN; ++n) {
         poly = geo->poly + n;
         if (0 < poly->state) { /* surface force negligible */
             continue;
         }
+        TickTime(&tm);
         /* reset some non accumulative information to zero */
         memset(poly->Fp, 0, DIMS * sizeof(*poly->Fp));
         memset(poly->Fv, 0, DIMS * sizeof(*poly->Fv));
@@ -116,7 +126,7 @@ void IntegrateSurfaceForce(Space *space, const Model *model)
                     r[X] = pO[X] - poly->O[X];
                     r[Y] = pO[Y] - poly->O[Y];
                     r[Z] = pO[Z] - poly->O[Z];
-                    MapPrimitive(model->gamma, model->gasR, node[idx].U[TO], Uo);
+                    MapPrimitive(model, node[idx].U[TO], Uo);
                     Fp[X] = Uo[4] * N[X];
                     Fp[Y] = Uo[4] * N[Y];
                     Fp[Z] = Uo[4] * N[Z];
@@ -135,6 +145,12 @@ void IntegrateSurfaceForce(Space *space, const Model *model)
                         Fv[X] = mu * (V[X] - Vn * N[X]) / Dist(pG, pO);
                         Fv[Y] = mu * (V[Y] - Vn * N[Y]) / Dist(pG, pO);
                         Fv[Z] = mu * (V[Z] - Vn * N[Z]) / Dist(pG, pO);
+                        if (WALLN != model->wall) { /* modelled shear from the image point, opposite to ghost side */
+                            Vn = -mu * ModelWallShear(TO, pI, pO, N, poly, part, node, model, V) / Dist(pI, pO);
+                            Fv[X] = Vn * V[X];
+                            Fv[Y] = Vn * V[Y];
+                            Fv[Z] = Vn * V[Z];
+                        }
                     } else {
                         memset(Fv, 0, DIMS * sizeof(*Fv));
                     }
@@ -151,6 +167,11 @@ void IntegrateSurfaceForce(Space *space, const Model *model)
                 }
             }
         }
+        if (NULL != geo->cost) {
+            AccountGeometryCost(geo->cost[poly->pid - 1][COSTFORCE], TockTime(&tm), gstN,
+                    (0 < poly->faceN) ? gstN : 0, (box[X][MAX] - box[X][MIN]) * (box[Y][MAX] - box[Y][MIN]) *
+                    (box[Z][MAX] - box[Z][MIN]));
+        }
         /* calibrate the sum of discrete forces into integration */
         if ((0 == lidN) || (0 == gstN)) { /* no surface force exerted */
             continue;
@@ -210,7 +231,7 @@ static void ApplyKinematics(const Real now, const Real dt, Space *space)
     }
     return;
 }
-static void ApplyCollision(Space *space)
+static void ApplyCollision(Space *space, const Model *model)
 {
     const Partition *const part = &(space->part);
     const Node *const node = space->node;
@@ -246,19 +267,23 @@ static void ApplyCollision(Space *space)
             continue;
         }
         geo->colN = 0; /* reset */
-        /* determine search range according to bounding box of polyhedron and valid node space */
-        for (int s = 0; s < DIMS; ++s) {
-            box[s][MIN] = ConfineSpace(MapNode(polp->box[s][MIN], sMin[s], dd[s], ng[s]), nMin[s], nMax[s]);
-            box[s][MAX] = ConfineSpace(MapNode(polp->box[s][MAX], sMin[s], dd[s], ng[s]), nMin[s], nMax[s]) + 1;
-        }
-        for (int k = box[Z][MIN]; k < box[Z][MAX]; ++k) {
-            for (int j = box[Y][MIN]; j < box[Y][MAX]; ++j) {
-                for (int i = box[X][MIN]; i < box[X][MAX]; ++i) {
-                    idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
-                    if ((1 != node[idx].lid) || (p + 1 != node[idx].did)) {
-                        continue;
+        if (CONTACTMESH == model->contact) {
+            DetectContact(p, geo);
+        } else {
+            /* determine search range according to bounding box of polyhedron and valid node space */
+            for (int s = 0; s < DIMS; ++s) {
+                box[s][MIN] = ConfineSpace(MapNode(polp->box[s][MIN], sMin[s], dd[s], ng[s]), nMin[s], nMax[s]);
+                box[s][MAX] = ConfineSpace(MapNode(polp->box[s][MAX], sMin[s], dd[s], ng[s]), nMin[s], nMax[s]) + 1;
+            }
+            for (int k = box[Z][MIN]; k < box[Z][MAX]; ++k) {
+                for (int j = box[Y][MIN]; j < box[Y][MAX]; ++j) {
+                    for (int i = box[X][MIN]; i < box[X][MAX]; ++i) {
+                        idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
+                        if ((1 != node[idx].lid) || (p + 1 != node[idx].did)) {
+                            continue;
+                        }
+                        DetectColState(k, j, i, p + 1, part->pathSep[1], part->path, node, part, geo);
                     }
-                    DetectColState(k, j, i, p + 1, part->pathSep[1], part->path, node, part, geo);
                 }
             }
         }
@@ -277,7 +302,7 @@ static void ApplyCollision(Space *space)
         for (int n = 0; n < geo->colN; ++n) {
             col = geo->col + n;
             /* line of impact */
-            if (0 == abs(col->N[X]) + abs(col->N[Y]) + abs(col->N[Z])) {
+            if ((zero == col->N[X]) && (zero == col->N[Y]) && (zero == col->N[Z])) {
                 if ((geo->colN - 1 == n) && (coltag > polp->state)) {
                     /* recover contacting but none colliding polyhedron */
                     memcpy(polp->V[TO], Vo, DIMS * sizeof(*polp->V[TO]));
@@ -350,12 +375,131 @@ static void DetectColState(const int k, const int j, const int i, const int did,
             continue;
         }
         if (did != node[idx].did) { /* a heterogeneous node on the path */
-            AddColObject(path[n], node[idx].did, geo);
+            const RealVec N = {path[n][X], path[n][Y], path[n][Z]};
+            AddColObject(N, node[idx].did, geo);
+        }
+    }
+    return;
+}
+/*
+ * Geometric narrow phase of contact detection. Candidate pairs are given by
+ * overlapping bounding boxes, and the exact geometry of each pair decides
+ * the contact and the line of impact. The cost is independent of the mesh
+ * resolution of the computational domain.
+ */
+static void DetectContact(const int p, Geometry *const geo)
+{
+    const Polyhedron *const polp = geo->poly + p;
+    const Polyhedron *poln = NULL;
+    RealVec N = {0.0}; /* line of impact */
+    for (int n = 0; n < geo->totN; ++n) {
+        poln = geo->poly + n;
+        if ((p == n) || !BoxOverlap(polp->box, poln->box)) {
+            continue;
+        }
+        if (0.0 <= ComputeContact(polp, poln, N)) {
+            AddColObject(N, n + 1, geo);
         }
     }
     return;
 }
-static void AddColObject(const int N[restrict], const int did, Geometry *const geo)
+/*
+ * Return the penetration depth of two polyhedrons, negative when separated,
+ * and the unit line of impact pointing from the first to the second one.
+ */
+static Real ComputeContact(const Polyhedron *polp, const Polyhedron *poln, Real N[restrict])
+{
+    Real depth = 0.0;
+    if ((0 >= polp->faceN) && (0 >= poln->faceN)) { /* sphere and sphere */
+        N[X] = poln->O[X] - polp->O[X];
+        N[Y] = poln->O[Y] - polp->O[Y];
+        N[Z] = poln->O[Z] - polp->O[Z];
+        depth = Norm(N);
+        if (0.0 < depth) {
+            Normalize(DIMS, depth, N);
+        }
+        return polp->r + poln->r - depth;
+    }
+    if (0 >= polp->faceN) { /* sphere and mesh */
+        return SphereMeshContact(polp, poln, N);
+    }
+    if (0 >= poln->faceN) { /* mesh and sphere */
+        depth = SphereMeshContact(poln, polp, N);
+        N[X] = -N[X];
+        N[Y] = -N[Y];
+        N[Z] = -N[Z];
+        return depth;
+    }
+    return MeshMeshContact(polp, poln, N);
+}
+static Real SphereMeshContact(const Polyhedron *sph, const Polyhedron *mesh, Real N[restrict])
+{
+    RealVec pi = {0.0}; /* closest surface point */
+    int fid = 0; /* closest face */
+    const int in = PointInPolyhedron(sph->O, mesh, &fid);
+    const Real dist = sqrt(ComputeIntersection(sph->O, fid, mesh, pi, N));
+    /* the outward normal of the mesh points towards the sphere center */
+    Normalize(DIMS, -Norm(N), N);
+    return in ? (sph->r + dist) : (sph->r - dist);
+}
+/*
+ * Vertices of each mesh in the overlap region are tested against the other
+ * mesh, and the deepest vertex defines the contact.
+ */
+static Real MeshMeshContact(const Polyhedron *polp, const Polyhedron *poln, Real N[restrict])
+{
+    RealVec Nn = {0.0}; /* line of impact from vertices of the second mesh */
+    Real depth = VertexMeshContact(polp, poln, -1.0, -FLT_MAX, N);
+    const Real dn = VertexMeshContact(poln, polp, 1.0, depth, Nn);
+    if (dn > depth) {
+        depth = dn;
+        N[X] = Nn[X];
+        N[Y] = Nn[Y];
+        N[Z] = Nn[Z];
+    }
+    return depth;
+}
+/*
+ * Return the largest penetration depth of the vertices of polv into polm
+ * if it exceeds depth, and the normal of polm there scaled by sign.
+ */
+static Real VertexMeshContact(const Polyhedron *polv, const Polyhedron *polm, const Real sign,
+        Real depth, Real N[restrict])
+{
+    RealVec pi = {0.0}; /* closest surface point */
+    RealVec Nm = {0.0}; /* surface normal */
+    Real dist = 0.0;
+    int fid = 0; /* closest face */
+    int in = 0; /* vertex inside flag */
+    for (int n = 0; n < polv->vertN; ++n) {
+        if ((polv->v[n][X] < polm->box[X][MIN]) || (polv->v[n][X] > polm->box[X][MAX]) ||
+                (polv->v[n][Y] < polm->box[Y][MIN]) || (polv->v[n][Y] > polm->box[Y][MAX]) ||
+                (polv->v[n][Z] < polm->box[Z][MIN]) || (polv->v[n][Z] > polm->box[Z][MAX])) {
+            continue;
+        }
+        in = PointInPolyhedron(polv->v[n], polm, &fid);
+        dist = sqrt(ComputeIntersection(polv->v[n], fid, polm, pi, Nm));
+        dist = in ? dist : -dist;
+        if (dist > depth) {
+            depth = dist;
+            Normalize(DIMS, sign * Norm(Nm), Nm);
+            N[X] = Nm[X];
+            N[Y] = Nm[Y];
+            N[Z] = Nm[Z];
+        }
+    }
+    return depth;
+}
+static int BoxOverlap(const Real boxA[restrict][LIMIT], const Real boxB[restrict][LIMIT])
+{
+    for (int s = 0; s < DIMS; ++s) {
+        if ((boxA[s][MAX] < boxB[s][MIN]) || (boxB[s][MAX] < boxA[s][MIN])) {
+            return 0;
+        }
+    }
+    return 1;
+}
+static void AddColObject(const Real N[restrict], const int did, Geometry *const geo)
 {
     Collision *col = NULL;
     /* search the object list, if already exist, adjust the line of impact */
@@ -15,18 +15,24 @@
 #include <stdio.h> /* standard library for input and output */
 #include <math.h> /* common mathematical functions */
 #include <limits.h> /* sizes of integral types */
+#include <float.h> /* size of floating point values */
 #include "initialization.h"
 #include "fluid_dynamics.h"
 #include "solid_dynamics.h"
 #include "data_stream.h"
+#include "kernel_tuner.h"
+#include "geometry_order.h"
+#include "data_stage.h"
+#include "convergence.h"
+#include "weno.h"
 #include "timer.h"
 #include "cfd_commons.h"
 #include "commons.h"
 /****************************************************************************
  * Static Function Declarations
  ****************************************************************************/
-static void EvolveSolution(Time *, Space *, const Model *);
-static Real ComputeTimeStep(const Time *, const Space *, const Model *);
+static Real ComputeTimeStep(const Time *, const Space *, const Model *, March *);
+static void AdaptCFL(const Time *, const Real, const Real, const Real, const Real, March *);
 /****************************************************************************
  * Function definitions
  ****************************************************************************/
@@ -39,37 +45,69 @@ int Solve(Time *time, Space *space, const Model *model)
 {
     ShowInfo("Solving...\n");
     ShowInfo("  initializing...\n");
-    InitializeComputeDomain(time, space, model);
+    March march; /* time marching state */
+    InitializeSolution(time, space, model, &march);
     ShowInfo("  time marching...\n");
-    EvolveSolution(time, space, model);
+    AdvanceSolution(time->stepN, &march, time, space, model);
+    FinalizeSolution(&march);
     ShowInfo("Session");
     return 0;
 }
-static void EvolveSolution(Time *time, Space *space, const Model *model)
+void InitializeSolution(Time *time, Space *space, const Model *model, March *march)
+{
+    InitializeComputeDomain(time, space, model);
+    TuneKernel(time, space, model);
+    /* data writing interval and recorder */
+    for (int n = 0; n < NPROBE; ++n) {
+        march->dtData[n] = time->end / (Real)(time->dataW[n]);
+        march->rcData[n] = 0.0;
+    }
+    /* time instants interval and recorder */
+    march->tmInt = (INT_MAX == time->dataW[PROSD]) ? time->end : march->dtData[PROSD]; /* a specific instant */
+    march->rcInt = 0.0;
+    march->lag = 0.0;
+    march->conv = 0;
+    march->cfl = time->numCFL;
+    march->rate = 0.0;
+    march->rhoMin = 0.0;
+    march->pMin = 0.0;
+    march->sat = 0.0;
+    march->mach = 0.0;
+    march->calm = 0;
+    march->dual = 0;
+    march->hist = (DualTime){0};
+    march->mt = (Monitor){0};
+    return;
+}
+int AdvanceSolution(const int stepN, March *march, Time *time, Space *space, const Model *model)
 {
     Real dt = time->end - time->now;
     const Real zero = 0.0;
     if (zero >= dt) {
         ShowWarning("  time.now >= time.end");
-        return;
+        return 0;
+    }
+    if (0 != march->conv) {
+        return 0;
     }
     Timer tm; /* timer for computing operations */
-    /* data writing interval and recorder */
-    const Real dtData[NPROBE] = {time->end / (Real)(time->dataW[PROPT]),
-        time->end / (Real)(time->dataW[PROLN]), time->end / (Real)(time->dataW[PROCV]),
-        time->end / (Real)(time->dataW[PROFC]), time->end / (Real)(time->dataW[PROSD])};
-    Real rcData[NPROBE] = {zero};
-    /* time instants interval and recorder */
-    const Real tmInt = (INT_MAX == time->dataW[PROSD]) ? time->end : dtData[PROSD]; /* a specific instant */
-    Real rcInt = zero; /* time instant recorder */
-    while ((time->now < time->end) && (time->stepC < time->stepN)) {
+    const Real *restrict dtData = march->dtData;
+    Real *restrict rcData = march->rcData;
+    const int stepO = time->stepC; /* step number at entry */
+    const int stepM = (time->stepN - time->stepC > stepN) ? time->stepC + stepN : time->stepN; /* last step */
+    int sync = 0; /* synchronization flag of field data */
+    int ckpt = 0; /* checkpoint request flag */
+    while ((time->now < time->end) && (time->stepC < stepM)) {
         ++(time->stepC);
-        dt = ComputeTimeStep(time, space, model);
-        if (rcInt + dt > tmInt) { /* rectify dt */
-            dt = tmInt - rcInt;
-            rcInt = zero;
+        if ((0 < space->geo.reorder) && (0 == (time->stepC - 1) % space->geo.reorder)) {
+            ReorderGeometry(space);
+        }
+        dt = ComputeTimeStep(time, space, model, march);
+        if (march->rcInt + dt > march->tmInt) { /* rectify dt */
+            dt = march->tmInt - march->rcInt;
+            march->rcInt = zero;
         } else {
-            rcInt = rcInt + dt;
+            march->rcInt = march->rcInt + dt;
         }
         time->now = time->now + dt;
         if (time->now > time->end) { /* rectify dt */
@@ -78,19 +116,40 @@ static void EvolveSolution(Time *time, Space *space, const Model *model)
         }
         ShowInfo("\nstep=%d; time=%.6g; remain=%.6g; dt=%.6g;\n",
                 time->stepC, time->now, time->end - time->now, dt);
+        if (time->numCFL < time->cflMax) {
+            ShowInfo("  cfl: %.6g\n", march->cfl);
+        }
+        /* field data need synchronization for solid dynamics and data export */
+        ckpt = StageSignaled();
+        sync = (0 != model->psi) || (time->now == time->end) || (time->stepC == stepM) || ckpt;
+        for (int n = 0; n < NPROBE; ++n) { /* probe types without probes write nothing */
+            sync = sync || (((PROSD == n) || (0 != time->dataN[n])) && (rcData[n] + dt >= dtData[n]));
+        }
+        sync = sync || ((0 < time->imgN) && (0 == time->stepC % time->imgW));
+        /* a sampling step and the step before it end at a time instant */
+        sync = sync || (0 == time->stepC % time->cvgW) || (0 == (time->stepC + 1) % time->cvgW);
+        MarkMonitor(time, space, &(march->mt));
         TickTime(&tm);
         if (0 != model->psi) {
             EvolveSolidDynamics(time->now, 0.5 * dt, space, model);
         }
-        EvolveFluidDynamics(dt, space, model);
+        if (0 != march->dual) {
+            SynchronizeFluidDynamics(&(march->lag), space, model);
+            EvolveDualTime(dt, march->mach, &(march->hist), space, model);
+        } else {
+            march->hist.dt = 0.0; /* an explicit step breaks the dual time history */
+            EvolveFluidDynamics(dt, sync, &(march->lag), space, model);
+        }
         if (0 != model->psi) {
             EvolveSolidDynamics(time->now, 0.5 * dt, space, model);
         }
         ShowInfo("  elapsed: %.6gs\n", TockTime(&tm));
+        march->conv = CheckConvergence(dt, time, space, model, &(march->mt));
         /* export data if accumulated time increases to anticipated interval */
         for (int n = 0; n < NPROBE; ++n) {
             rcData[n] = rcData[n] + dt;
-            if ((rcData[n] >= dtData[n]) || (time->now == time->end) || (time->stepC == time->stepN)) {
+            if ((rcData[n] >= dtData[n]) || (time->now == time->end) || (time->stepC == time->stepN) ||
+                    (0 != march->conv) || ((PROSD == n) && (0 != ckpt))) {
                 if (PROFC == n) {
                     IntegrateSurfaceForce(space, model);
                 }
@@ -98,14 +157,33 @@ static void EvolveSolution(Time *time, Space *space, const Model *model)
                     ShowInfo("  writing data...\n");
                     ++(time->dataC); /* export count increase */
                 }
-                WriteData(n, time, space, model);
+                if (0 == time->mute) {
+                    WriteData(n, time, space, model);
+                }
                 rcData[n] = zero; /* reset probe accumulated time */
             }
         }
+        if ((0 < time->imgN) && (0 == time->stepC % time->imgW) && (0 == time->mute)) {
+            WriteImageData(time, space, model);
+        }
+        if (0 != ckpt) { /* checkpoint completes only in the destination */
+            FlushStage();
+        }
+        if (0 != march->conv) {
+            ShowInfo("  steady state reached, terminating...\n");
+            break;
+        }
     }
+    return time->stepC - stepO;
+}
+void FinalizeSolution(March *march)
+{
+    FinalizeMonitor(&(march->mt));
+    FinalizeFluidDynamics(&(march->hist));
     return;
 }
-static Real ComputeTimeStep(const Time *time, const Space *space, const Model *model)
+static Real ComputeTimeStep(const Time *time, const Space *space, const Model *model,
+        March *march)
 {
     const Partition *const part = &(space->part);
     const Node *const node = space->node;
@@ -117,6 +195,15 @@ static Real ComputeTimeStep(const Time *time, const Space *space, const Model *m
     Real c = 0.0; /* speed of sound */
     RealVec V = {0.0}; /* characteristic speeds in each direction */
     RealVec Vmax = {0.0}; /* maximum characteristic speeds in each direction */
+    RealVec Vc = {0.0}; /* maximum convective speeds in each direction */
+    Real mach = 0.0; /* maximum Mach number */
+    Real rhoMin = FLT_MAX; /* minimum density */
+    Real pMin = FLT_MAX; /* minimum pressure */
+    const int adapt = (time->numCFL < time->cflMax) ? 1 : 0; /* adaptive CFL flag */
+    const int stride[DIMS] = {1, part->n[X], part->n[X] * part->n[Y]}; /* node strides */
+    Real f[5] = {0.0}; /* density on a five-point stencil */
+    int sampleN = 0; /* number of saturation samples */
+    int satN = 0; /* number of saturated samples */
     /* incorporate solid dynamics into CFL condition */
     for (int n = 0; n < geo->totN; ++n) {
         poly = geo->poly + n;
@@ -129,6 +216,9 @@ static Real ComputeTimeStep(const Time *time, const Space *space, const Model *m
             }
         }
     }
+    for (int s = 0; s < DIMS; ++s) {
+        Vc[s] = Vmax[s]; /* solid motion is convective */
+    }
     /* incorporate fluid dynamics into CFL condition */
     for (int k = part->ns[PIN][Z][MIN]; k < part->ns[PIN][Z][MAX]; ++k) {
         for (int j = part->ns[PIN][Y][MIN]; j < part->ns[PIN][Y][MAX]; ++j) {
@@ -138,18 +228,90 @@ static Real ComputeTimeStep(const Time *time, const Space *space, const Model *m
                 if (0 != node[idx].did) {
                     continue;
                 }
-                MapPrimitive(model->gamma, model->gasR, U, Uo);
-                c = sqrt(model->gamma * model->gasR * Uo[5]);
+                MapPrimitive(model, U, Uo);
+                rhoMin = MinReal(rhoMin, Uo[0]);
+                pMin = MinReal(pMin, Uo[4]);
+                c = ComputeSoundSpeed(model, U);
+                mach = MaxReal(mach, sqrt(Uo[1] * Uo[1] + Uo[2] * Uo[2] + Uo[3] * Uo[3]) / c);
                 for (int s = 0; s < DIMS; ++s) {
                     V[s] = fabs(Uo[s+1]) + c;
                     if (Vmax[s] < V[s]) {
                         Vmax[s] = V[s];
                     }
+                    Vc[s] = MaxReal(Vc[s], fabs(Uo[s+1]));
+                }
+                if (0 == adapt) {
+                    continue;
+                }
+                /* WENO weight saturation of density on each resolved dimension */
+                const int p[DIMS] = {i, j, k};
+                for (int s = 0; s < DIMS; ++s) {
+                    if ((1 == part->m[s]) || (2 > p[s]) || (part->n[s] - 2 <= p[s])) {
+                        continue;
+                    }
+                    for (int m = 0; m < 5; ++m) {
+                        f[m] = node[idx+(m-2)*stride[s]].U[TO][0];
+                    }
+                    ++sampleN;
+                    if (0.5 < WENOSaturation(f)) {
+                        ++satN;
+                    }
                 }
             }
         }
     }
-    return time->numCFL * MinReal(part->d[X] / Vmax[X], MinReal(part->d[Y] / Vmax[Y], part->d[Z] / Vmax[Z]));
+    if (0 != adapt) {
+        AdaptCFL(time, MaxReal(Vmax[X] / part->d[X], MaxReal(Vmax[Y] / part->d[Y], Vmax[Z] / part->d[Z])),
+                rhoMin, pMin, (0 < sampleN) ? (Real)satN / (Real)sampleN : 0.0, march);
+    }
+    const Real dt = march->cfl * model->ssp * MinReal(part->d[X] / Vmax[X],
+            MinReal(part->d[Y] / Vmax[Y], part->d[Z] / Vmax[Z])); /* acoustic time step */
+    /*
+     * Dual time steps start only after the flow stays below the Mach
+     * threshold for the hold steps, hence never on the first step, and
+     * end as soon as the threshold is exceeded. They follow the convective
+     * CFL condition, bounded by the stated multiple of the acoustic step.
+     */
+    march->mach = mach;
+    march->calm = (mach < model->pcMa) ? march->calm + 1 : 0;
+    march->dual = (model->pcHold < march->calm) ? 1 : 0;
+    if (0 != march->dual) {
+        const Real rate = MaxReal(Vc[X] / part->d[X], MaxReal(Vc[Y] / part->d[Y], Vc[Z] / part->d[Z]));
+        if (time->numCFL < model->pcStep * dt * rate) {
+            return time->numCFL / rate;
+        }
+        return model->pcStep * dt;
+    }
+    return dt;
+}
+/*
+ * The CFL number moves between the case value and the ceiling. Indicators
+ * are taken from the solution after the final stage of the last step: a
+ * drop of the density or pressure minimum, or a rise of the maximum
+ * characteristic rate or of the fraction of samples whose WENO5 weights
+ * of density are saturated, beyond the tolerated change per step signals a
+ * violent transient and halves the CFL number; otherwise it grows by the
+ * user factor.
+ */
+static void AdaptCFL(const Time *time, const Real rate, const Real rhoMin, const Real pMin,
+        const Real sat, March *march)
+{
+    const Real drop = 0.8; /* tolerated relative decrease of minima per step */
+    const Real rise = 1.1; /* tolerated relative increase of rate and saturation per step */
+    const Real noise = 0.01; /* saturated sample fraction change ignored as noise */
+    if (0.0 < march->rate) { /* indicators of the last step exist */
+        if ((drop * march->rhoMin > rhoMin) || (drop * march->pMin > pMin) || (rise * march->rate < rate) ||
+                (rise * march->sat + noise < sat)) {
+            march->cfl = MaxReal(time->numCFL, 0.5 * march->cfl);
+        } else {
+            march->cfl = MinReal(time->cflMax, time->cflRate * march->cfl);
+        }
+    }
+    march->rate = rate;
+    march->rhoMin = rhoMin;
+    march->pMin = pMin;
+    march->sat = sat;
+    return;
 }
 /* a good practice: end file with a newline */
 
@@ -16,10 +16,30 @@
 /****************************************************************************
  * Required Header Files
  ****************************************************************************/
+#include "convergence.h"
+#include "fluid_dynamics.h"
 #include "commons.h"
 /****************************************************************************
  * Data Structure Declarations
  ****************************************************************************/
+typedef struct {
+    Real dtData[NPROBE]; /* data writing interval */
+    Real rcData[NPROBE]; /* data writing recorder */
+    Real tmInt; /* time instants interval */
+    Real rcInt; /* time instant recorder */
+    Real lag; /* deferred split sweep time */
+    int conv; /* steady state convergence flag */
+    Real cfl; /* adopted CFL number */
+    Real rate; /* maximum characteristic rate of the last step */
+    Real rhoMin; /* minimum density of the last step */
+    Real pMin; /* minimum pressure of the last step */
+    Real sat; /* saturated WENO weight fraction of the last step */
+    Real mach; /* maximum Mach number of the last step */
+    int calm; /* consecutive steps below the Mach threshold */
+    int dual; /* dual time stepping flag of the current step */
+    DualTime hist; /* history of dual time stepping */
+    Monitor mt; /* steady state convergence monitor */
+} March; /* time marching state carried across steps */
 /****************************************************************************
  * Public Functions Declaration
  ****************************************************************************/
@@ -30,6 +50,25 @@
  *      Call a series of function to perform numerical computation.
  */
 extern int Solve(Time *, Space *, const Model *);
+/*
+ * Resumable time marching
+ *
+ * Function
+ *      Initialize the computational domain and the marching state, then
+ *      advance the solution by at most stepN steps, stopping earlier at
+ *      the termination time, the total step number, or a steady state.
+ *      The field data are synchronized at the end of each call. Return
+ *      the number of steps advanced.
+ */
+extern void InitializeSolution(Time *, Space *, const Model *, March *);
+extern int AdvanceSolution(const int stepN, March *, Time *, Space *, const Model *);
+/*
+ * Marching state finalization
+ *
+ * Function
+ *      Release the storage carried by the marching state.
+ */
+extern void FinalizeSolution(March *);
 #endif
 /* a good practice: end file with a newline */
 
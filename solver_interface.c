@@ -0,0 +1,244 @@
+/****************************************************************************
+ *                              ArtraCFD                                    *
+ *                          <By Huangrui Mo>                                *
+ * Copyright (C) Huangrui Mo <huangrui.mo@gmail.com>                        *
+ * This file is part of ArtraCFD.                                           *
+ * ArtraCFD is free software: you can redistribute it and/or modify it      *
+ * under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or        *
+ * (at your option) any later version.                                      *
+ ****************************************************************************/
+/****************************************************************************
+ * Required Header Files
+ ****************************************************************************/
+#include "solver_interface.h"
+#include <stdio.h> /* standard library for input and output */
+#include <string.h> /* manipulating strings */
+#include "preprocess.h"
+#include "solve.h"
+#include "postprocess.h"
+#include "solid_dynamics.h"
+#include "cfd_commons.h"
+#include "commons.h"
+/****************************************************************************
+ * Data Structure Declarations
+ ****************************************************************************/
+struct Session {
+    Time time; /* time data */
+    Space space; /* space data */
+    Model model; /* model data */
+    March march; /* time marching state */
+    FileTable files; /* in-memory files and staging of the session */
+    int fail; /* failure flag, a failed session only accepts closing */
+};
+/****************************************************************************
+ * Static Function Declarations
+ ****************************************************************************/
+static void EnterSession(Session *, jmp_buf *);
+static void LeaveSession(void);
+static int FailSession(Session *);
+static Polyhedron *SessionBody(const Session *, const int);
+/****************************************************************************
+ * Function definitions
+ ****************************************************************************/
+/*
+ * A session runs the same preprocessing, initialization, and time marching
+ * as the executable in serial mode, except that the case texts come from
+ * memory and all file output is muted.
+ * Every entry point binds the file table of the session to the calling
+ * thread and sets an error trap, so that an error in the solver returns
+ * an error code to the host program instead of exiting it. Errors inside
+ * worker threads of a parallel section still exit, since their stacks
+ * cannot be unwound from the calling thread.
+ */
+Session *OpenSession(const char *caseText, const char *geoText)
+{
+    jmp_buf trap; /* error return point */
+    Session *volatile session = NULL;
+    if (0 != setjmp(trap)) {
+        if (NULL == session) {
+            LeaveSession();
+            return NULL;
+        }
+        session->fail = 1;
+        CloseSession(session);
+        return NULL;
+    }
+    SetErrorTrap(&trap);
+    session = AssignStorage(sizeof(*session));
+    /* buffers mounted on the calling thread before opening move into the session */
+    FileTable *const files = BoundFileTable();
+    session->files.fileN = files->fileN;
+    memcpy(session->files.fname, files->fname, sizeof(files->fname));
+    memcpy(session->files.data, files->data, sizeof(files->data));
+    memcpy(session->files.size, files->size, sizeof(files->size));
+    UnmountMemoryFiles();
+    EnterSession(session, &trap);
+    if (NULL != caseText) {
+        MountMemoryFile("artracfd.case", caseText, strlen(caseText));
+    }
+    if (NULL != geoText) {
+        MountMemoryFile("artracfd.geo", geoText, strlen(geoText));
+    }
+    Time *const time = &(session->time);
+    Space *const space = &(session->space);
+    Model *const model = &(session->model);
+    Partition *const part = &(space->part);
+    time->mute = 1;
+    part->proc[X] = 1;
+    part->proc[Y] = 1;
+    part->proc[Z] = 1;
+    part->procN = 1;
+    Preprocess(time, space, model);
+    InitializeSolution(time, space, model, &(session->march));
+    LeaveSession();
+    return session;
+}
+void CloseSession(Session *session)
+{
+    if (NULL == session) {
+        return;
+    }
+    jmp_buf trap; /* error return point */
+    if (0 == setjmp(trap)) {
+        EnterSession(session, &trap);
+        FinalizeSolution(&(session->march));
+        Postprocess(&(session->time), &(session->space), &(session->model));
+    }
+    UnmountMemoryFiles();
+    LeaveSession();
+    RetrieveStorage(session);
+    return;
+}
+int AdvanceSession(Session *session, const int stepN)
+{
+    if (0 != session->fail) {
+        return SESSIONFAIL;
+    }
+    jmp_buf trap; /* error return point */
+    if (0 != setjmp(trap)) {
+        return FailSession(session);
+    }
+    EnterSession(session, &trap);
+    const int n = AdvanceSolution(stepN, &(session->march), &(session->time),
+            &(session->space), &(session->model));
+    LeaveSession();
+    return n;
+}
+Real SessionTime(const Session *session)
+{
+    return session->time.now;
+}
+static void EnterSession(Session *session, jmp_buf *trap)
+{
+    BindFileTable(&(session->files));
+    SetErrorTrap(trap);
+    return;
+}
+static void LeaveSession(void)
+{
+    SetErrorTrap(NULL);
+    BindFileTable(NULL);
+    return;
+}
+static int FailSession(Session *session)
+{
+    session->fail = 1;
+    LeaveSession();
+    return SESSIONFAIL;
+}
+static Polyhedron *SessionBody(const Session *session, const int id)
+{
+    const Geometry *const geo = &(session->space.geo);
+    if ((1 > id) || (geo->totN < id)) {
+        return NULL;
+    }
+    return geo->poly + geo->pos[id - 1];
+}
+int SetBodyVelocity(Session *session, const int id, const Real V[restrict], const Real W[restrict])
+{
+    if (0 != session->fail) {
+        return SESSIONFAIL;
+    }
+    Polyhedron *const poly = SessionBody(session, id);
+    if (NULL == poly) {
+        return SESSIONARG;
+    }
+    for (int s = 0; s < DIMS; ++s) {
+        poly->V[TO][s] = V[s];
+        poly->W[TO][s] = W[s];
+    }
+    return SESSIONOK;
+}
+int GetBodyLoad(Session *session, const int id, Real F[restrict], Real T[restrict])
+{
+    if (0 != session->fail) {
+        return SESSIONFAIL;
+    }
+    const Polyhedron *const poly = SessionBody(session, id);
+    if (NULL == poly) {
+        return SESSIONARG;
+    }
+    jmp_buf trap; /* error return point */
+    if (0 != setjmp(trap)) {
+        return FailSession(session);
+    }
+    EnterSession(session, &trap);
+    IntegrateSurfaceForce(&(session->space), &(session->model));
+    LeaveSession();
+    for (int s = 0; s < DIMS; ++s) {
+        F[s] = poly->Fp[s] + poly->Fv[s];
+        T[s] = poly->Tt[s];
+    }
+    return SESSIONOK;
+}
+void ProbeSession(const Session *session, const Real p[restrict], Real Uo[restrict])
+{
+    const Partition *const part = &(session->space.part);
+    const Node *const node = session->space.node;
+    int nodeN[DIMS] = {0}; /* node index of the point */
+    for (int s = 0; s < DIMS; ++s) {
+        nodeN[s] = ConfineSpace(MapNode(p[s], part->domain[s][MIN], part->dd[s], part->ng[s]),
+                part->ns[PHY][s][MIN], part->ns[PHY][s][MAX]);
+    }
+    const int idx = IndexNode(nodeN[Z], nodeN[Y], nodeN[X], part->n[Y], part->n[X]);
+    MapPrimitive(&(session->model), node[idx].U[TO], Uo);
+    return;
+}
+void SessionMesh(const Session *session, int n[restrict], Real domain[restrict][LIMIT])
+{
+    const Partition *const part = &(session->space.part);
+    for (int s = 0; s < DIMS; ++s) {
+        n[s] = part->ns[PHY][s][MAX] - part->ns[PHY][s][MIN];
+        domain[s][MIN] = part->domain[s][MIN];
+        domain[s][MAX] = part->domain[s][MAX];
+    }
+    return;
+}
+int CopySessionField(const Session *session, const int var, Real *restrict field)
+{
+    const Partition *const part = &(session->space.part);
+    const Node *const node = session->space.node;
+    Real Uo[DIMUo] = {0.0};
+    int idx = 0; /* linear array index math variable */
+    int m = 0; /* linear index of the caller array */
+    if (0 != session->fail) {
+        return SESSIONFAIL;
+    }
+    if ((0 > var) || (DIMUo <= var)) {
+        return SESSIONARG;
+    }
+    for (int k = part->ns[PHY][Z][MIN]; k < part->ns[PHY][Z][MAX]; ++k) {
+        for (int j = part->ns[PHY][Y][MIN]; j < part->ns[PHY][Y][MAX]; ++j) {
+            for (int i = part->ns[PHY][X][MIN]; i < part->ns[PHY][X][MAX]; ++i) {
+                idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
+                MapPrimitive(&(session->model), node[idx].U[TO], Uo);
+                field[m] = Uo[var];
+                ++m;
+            }
+        }
+    }
+    return SESSIONOK;
+}
+/* a good practice: end file with a newline */
+
@@ -0,0 +1,88 @@
+/****************************************************************************
+ *                              ArtraCFD                                    *
+ *                          <By Huangrui Mo>                                *
+ * Copyright (C) Huangrui Mo <huangrui.mo@gmail.com>                        *
+ * This file is part of ArtraCFD.                                           *
+ * ArtraCFD is free software: you can redistribute it and/or modify it      *
+ * under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or        *
+ * (at your option) any later version.                                      *
+ ****************************************************************************/
+/****************************************************************************
+ * Header File Guards to Avoid Interdependence
+ ****************************************************************************/
+#ifndef ARTRACFD_SOLVER_INTERFACE_H_ /* if undefined */
+#define ARTRACFD_SOLVER_INTERFACE_H_ /* set a unique marker */
+/****************************************************************************
+ * Required Header Files
+ ****************************************************************************/
+#include <stddef.h> /* size_t */
+#include "commons.h"
+/****************************************************************************
+ * Data Structure Declarations
+ ****************************************************************************/
+typedef struct Session Session; /* a solver instance embedded in a host program */
+typedef enum {
+    SESSIONOK = 0, /* success */
+    SESSIONFAIL = -1, /* solver error, the session only accepts closing */
+    SESSIONARG = -2, /* invalid argument, the session is intact */
+} SessionStatus;
+/****************************************************************************
+ * Public Functions Declaration
+ ****************************************************************************/
+/*
+ * Session management
+ *
+ * Function
+ *      Open a session from the texts of artracfd.case and artracfd.geo,
+ *      a NULL text reads the file of the working directory instead.
+ *      Other inputs, such as STL and equation of state tables, can be
+ *      provided in memory by MountMemoryFile before opening. A session
+ *      writes no files; buffers mounted on the calling thread move into
+ *      the session and should persist until the session is closed.
+ *      Sessions keep their states apart, therefore several sessions can
+ *      be open at a time, and different sessions can be used from
+ *      different threads. Errors in the solver do not exit the process:
+ *      OpenSession returns NULL, and the other calls return SESSIONFAIL,
+ *      after which a session only accepts CloseSession.
+ */
+extern Session *OpenSession(const char *caseText, const char *geoText);
+extern void CloseSession(Session *);
+/*
+ * Time marching
+ *
+ * Function
+ *      Advance a session by at most stepN steps, return the number of
+ *      steps advanced, which is less than stepN if the termination time,
+ *      the total step number, or a steady state is reached, or SESSIONFAIL.
+ */
+extern int AdvanceSession(Session *, const int stepN);
+extern Real SessionTime(const Session *);
+/*
+ * Body state and loads
+ *
+ * Function
+ *      Body id follows the input order of geometries, starting from 1.
+ *      Set the translational and rotational velocities of a body, and
+ *      get the total force and torque acting on a body. Return a
+ *      SessionStatus, SESSIONARG for a body id out of range.
+ */
+extern int SetBodyVelocity(Session *, const int id, const Real V[restrict], const Real W[restrict]);
+extern int GetBodyLoad(Session *, const int id, Real F[restrict], Real T[restrict]);
+/*
+ * Field views
+ *
+ * Function
+ *      Probe the primitive variables rho, u, v, w, p, T at the node
+ *      nearest to a point. Copy a primitive variable of the physical
+ *      region into a caller array of n[X] * n[Y] * n[Z] values in x
+ *      fastest order, where n is the node number given by SessionMesh.
+ *      CopySessionField returns a SessionStatus, SESSIONARG for an
+ *      unidentified variable.
+ */
+extern void ProbeSession(const Session *, const Real p[restrict], Real Uo[restrict]);
+extern void SessionMesh(const Session *, int n[restrict], Real domain[restrict][LIMIT]);
+extern int CopySessionField(const Session *, const int var, Real *restrict field);
+#endif
+/* a good practice: end file with a newline */
+
@@ -37,5 +37,24 @@ void ComputePhi(const int tn, const int k, const int j, const int i,
     Phi[4] = Dot(fb, V);
     return;
 }
+/*
+ * For the body force, density is constant, momentum varies linearly and
+ * energy quadratically with time, which is also the result of the RK2 and
+ * RK3 schemes applied to this nilpotent linear system, but evaluated here
+ * in one pass.
+ */
+void IntegratePhi(const Real dt, const Model *model, Real U[restrict])
+{
+    if (0 == model->sState) {
+        return;
+    }
+    const RealVec fb = {U[0] * model->g[X], U[0] * model->g[Y], U[0] * model->g[Z]};
+    const RealVec m = {U[1], U[2], U[3]};
+    U[1] = m[X] + dt * fb[X];
+    U[2] = m[Y] + dt * fb[Y];
+    U[3] = m[Z] + dt * fb[Z];
+    U[4] = U[4] + dt * Dot(m, model->g) + 0.5 * dt * dt * Dot(fb, model->g);
+    return;
+}
 /* a good practice: end file with a newline */
 
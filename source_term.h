@@ -32,6 +32,14 @@
 void ComputePhi(const int tn, const int k, const int j, const int i,
         const int partn[restrict], const Node *const,
         const Model *, Real Phi[restrict]);
+/*
+ * Source term integration
+ *
+ * Function
+ *      Integrate dU/dt = Phi(U) exactly over dt at a node. The source term
+ *      is local, hence no neighbour or boundary data are involved.
+ */
+void IntegratePhi(const Real dt, const Model *, Real U[restrict]);
 #endif
 /* a good practice: end file with a newline */
 
@@ -21,6 +21,8 @@
  ****************************************************************************/
 typedef enum {
     STLSTR = 80, /* STL header characters */
+    STLREAL = 12, /* STL reals of a facet: normal and three vertices */
+    STLFACET = 50, /* STL bytes of a facet record */
 } StlConst;
 /*
  * STL data format and type control
@@ -36,45 +38,33 @@ typedef float StlReal; /* STL real data */
 /****************************************************************************
  * Function definitions
  ****************************************************************************/
+/*
+ * Facet records are read in one block and decoded from the buffer, since
+ * the many small reads of a record dominate the load time of large files.
+ */
 void ReadStlFile(const char *fname, Polyhedron *poly)
 {
     StlStr header = {'\0'};
     StlLint facetN = 0;
-    StlInt attribute = 0;
-    StlReal facetData = 0.0;
+    StlReal facetData[STLREAL] = {0.0};
     FILE *fp = Fopen(fname, "rb");
     Fread(header, sizeof(StlStr), 1, fp);
     Fread(&facetN, sizeof(StlLint), 1, fp);
     poly->faceN = facetN;
     poly->facet = AssignStorage(poly->faceN * sizeof(*poly->facet));
+    StlChar *record = AssignStorage((size_t)facetN * STLFACET * sizeof(*record));
+    Fread(record, STLFACET * sizeof(*record), facetN, fp);
+    fclose(fp);
     for (StlLint n = 0; n < facetN; ++n) {
-        Fread(&facetData, sizeof(StlReal), 1, fp);
-        poly->facet[n].N[X] = facetData;
-        Fread(&facetData, sizeof(StlReal), 1, fp);
-        poly->facet[n].N[Y] = facetData;
-        Fread(&facetData, sizeof(StlReal), 1, fp);
-        poly->facet[n].N[Z] = facetData;
-        Fread(&facetData, sizeof(StlReal), 1, fp);
-        poly->facet[n].v0[X] = facetData;
-        Fread(&facetData, sizeof(StlReal), 1, fp);
-        poly->facet[n].v0[Y] = facetData;
-        Fread(&facetData, sizeof(StlReal), 1, fp);
-        poly->facet[n].v0[Z] = facetData;
-        Fread(&facetData, sizeof(StlReal), 1, fp);
-        poly->facet[n].v1[X] = facetData;
-        Fread(&facetData, sizeof(StlReal), 1, fp);
-        poly->facet[n].v1[Y] = facetData;
-        Fread(&facetData, sizeof(StlReal), 1, fp);
-        poly->facet[n].v1[Z] = facetData;
-        Fread(&facetData, sizeof(StlReal), 1, fp);
-        poly->facet[n].v2[X] = facetData;
-        Fread(&facetData, sizeof(StlReal), 1, fp);
-        poly->facet[n].v2[Y] = facetData;
-        Fread(&facetData, sizeof(StlReal), 1, fp);
-        poly->facet[n].v2[Z] = facetData;
-        Fread(&attribute, sizeof(StlInt), 1, fp);
+        memcpy(facetData, record + (size_t)n * STLFACET, sizeof(facetData));
+        for (int s = 0; s < DIMS; ++s) {
+            poly->facet[n].N[s] = facetData[s];
+            poly->facet[n].v0[s] = facetData[DIMS + s];
+            poly->facet[n].v1[s] = facetData[2 * DIMS + s];
+            poly->facet[n].v2[s] = facetData[3 * DIMS + s];
+        }
     }
-    fclose(fp);
+    RetrieveStorage(record);
     return;
 }
 void WriteStlFile(const char *fname, const Polyhedron *poly)
@@ -31,6 +31,14 @@
  */
 extern void WENO3(Real F[restrict][DIMU], Real Fhat[restrict]);
 extern void WENO5(Real F[restrict][DIMU], Real Fhat[restrict]);
+/*
+ * WENO weight saturation
+ *
+ * Function
+ *      Measure how far the WENO5 nonlinear weights of a scalar five-point
+ *      stencil depart from the linear weights.
+ */
+extern Real WENOSaturation(const Real f[restrict]);
 #endif
 /* a good practice: end file with a newline */
 
@@ -24,6 +24,8 @@ typedef enum {
 /****************************************************************************
  * Static Function Declarations
  ****************************************************************************/
+static void ComputeWeights(const Real, const Real, const Real, const Real,
+        const Real, Real [restrict]);
 static Real Square(const Real);
 /****************************************************************************
  * Function definitions
@@ -36,23 +38,8 @@ void WENO5(Real F[restrict][DIMU], Real Fhat[restrict])
 {
     Real omega[R]; /* weights */
     Real q[R]; /* q vectors */
-    Real IS[R]; /* smoothness measurements */
-    Real alpha[R];
-    const Real C[R] = {1.0 / 10.0, 6.0 / 10.0, 3.0 / 10.0};
-    const Real epsilon = 1.0e-6;
     for (int r = 0; r < DIMU; ++r) {
-        IS[0] = (13.0 / 12.0) * Square(F[CN-2][r] - 2.0 * F[CN-1][r] + F[CN][r]) +
-            (1.0 / 4.0) * Square(F[CN-2][r] - 4.0 * F[CN-1][r] + 3.0 * F[CN][r]);
-        IS[1] = (13.0 / 12.0) * Square(F[CN-1][r] - 2.0 * F[CN][r] + F[CN+1][r]) +
-            (1.0 / 4.0) * Square(F[CN-1][r] - F[CN+1][r]);
-        IS[2] = (13.0 / 12.0) * Square(F[CN][r] - 2.0 * F[CN+1][r] + F[CN+2][r]) +
-            (1.0 / 4.0) * Square(3.0 * F[CN][r] - 4.0 * F[CN+1][r] + F[CN+2][r]);
-        alpha[0] = C[0] / Square(epsilon + IS[0]);
-        alpha[1] = C[1] / Square(epsilon + IS[1]);
-        alpha[2] = C[2] / Square(epsilon + IS[2]);
-        omega[0] = alpha[0] / (alpha[0] + alpha[1] + alpha[2]);
-        omega[1] = alpha[1] / (alpha[0] + alpha[1] + alpha[2]);
-        omega[2] = alpha[2] / (alpha[0] + alpha[1] + alpha[2]);
+        ComputeWeights(F[CN-2][r], F[CN-1][r], F[CN][r], F[CN+1][r], F[CN+2][r], omega);
         q[0] = (1.0 / 6.0) * (2.0 * F[CN-2][r] - 7.0 * F[CN-1][r] + 11.0 * F[CN][r]);
         q[1] = (1.0 / 6.0) * (-F[CN-1][r] + 5.0 * F[CN][r] + 2.0 * F[CN+1][r]);
         q[2] = (1.0 / 6.0) * (2.0 * F[CN][r] + 5.0 * F[CN+1][r] - F[CN+2][r]);
@@ -60,6 +47,39 @@ void WENO5(Real F[restrict][DIMU], Real Fhat[restrict])
     }
     return;
 }
+/*
+ * The saturation is the largest relative loss of a linear weight,
+ * 1 - min(omega_r / C_r). It vanishes where the stencil is smooth and
+ * approaches one where a substencil is switched off by a discontinuity.
+ */
+Real WENOSaturation(const Real f[restrict])
+{
+    Real omega[R]; /* weights */
+    const Real C[R] = {1.0 / 10.0, 6.0 / 10.0, 3.0 / 10.0};
+    ComputeWeights(f[CN-2], f[CN-1], f[CN], f[CN+1], f[CN+2], omega);
+    return 1.0 - MinReal(omega[0] / C[0], MinReal(omega[1] / C[1], omega[2] / C[2]));
+}
+static void ComputeWeights(const Real fll, const Real fl, const Real f, const Real fr,
+        const Real frr, Real omega[restrict])
+{
+    Real IS[R]; /* smoothness measurements */
+    Real alpha[R];
+    const Real C[R] = {1.0 / 10.0, 6.0 / 10.0, 3.0 / 10.0};
+    const Real epsilon = 1.0e-6;
+    IS[0] = (13.0 / 12.0) * Square(fll - 2.0 * fl + f) +
+        (1.0 / 4.0) * Square(fll - 4.0 * fl + 3.0 * f);
+    IS[1] = (13.0 / 12.0) * Square(fl - 2.0 * f + fr) +
+        (1.0 / 4.0) * Square(fl - fr);
+    IS[2] = (13.0 / 12.0) * Square(f - 2.0 * fr + frr) +
+        (1.0 / 4.0) * Square(3.0 * f - 4.0 * fr + frr);
+    alpha[0] = C[0] / Square(epsilon + IS[0]);
+    alpha[1] = C[1] / Square(epsilon + IS[1]);
+    alpha[2] = C[2] / Square(epsilon + IS[2]);
+    omega[0] = alpha[0] / (alpha[0] + alpha[1] + alpha[2]);
+    omega[1] = alpha[1] / (alpha[0] + alpha[1] + alpha[2]);
+    omega[2] = alpha[2] / (alpha[0] + alpha[1] + alpha[2]);
+    return;
+}
 static Real Square(const Real x)
 {
     return x * x;